@@ -6,9 +6,17 @@ layout(location = 1) in vec3 aColor;
 out vec3 vColor;
 out vec2 vPos;
 
-uniform mat4 matrix;
+layout(std140) uniform Frame {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProj;
+    vec4 cameraPosition;
+    float time;
+};
+
+uniform mat4 model;
 
 void main() {
     vColor = aColor;
-    gl_Position = matrix * vec4(aPos, 1.0);
+    gl_Position = viewProj * model * vec4(aPos, 1.0);
 }
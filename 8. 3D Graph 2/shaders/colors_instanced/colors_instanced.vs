@@ -0,0 +1,20 @@
+#version 330 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aColor;
+layout(location = 2) in mat4 iModel; // per instance, takes locations 2..5
+
+out vec3 vColor;
+
+layout(std140) uniform Frame {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProj;
+    vec4 cameraPosition;
+    float time;
+};
+
+void main() {
+    vColor = aColor;
+    gl_Position = viewProj * iModel * vec4(aPos, 1.0);
+}
@@ -6,10 +6,18 @@ layout(location = 1) in vec2 v_tex;
 out vec3 f_pos;
 out vec2 f_tex;
 
-uniform mat4 matrix;
+layout(std140) uniform Frame {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProj;
+    vec4 cameraPosition;
+    float time;
+};
+
+uniform mat4 model;
 
 void main() {
     f_pos = v_pos;
     f_tex = v_tex;
-    gl_Position = matrix * vec4(v_pos, 1.0);
+    gl_Position = viewProj * model * vec4(v_pos, 1.0);
 }
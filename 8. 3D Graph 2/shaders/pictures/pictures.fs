@@ -0,0 +1,11 @@
+#version 330 core
+
+in vec3 f_tex;
+
+out vec4 o_color;
+
+uniform sampler2DArray u_sampler;
+
+void main() {
+    o_color = texture(u_sampler, f_tex);
+}
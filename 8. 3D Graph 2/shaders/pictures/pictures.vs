@@ -0,0 +1,22 @@
+#version 330 core
+
+layout(location = 0) in vec3 v_pos;
+layout(location = 1) in vec2 v_tex;
+layout(location = 2) in mat4 i_model;  // per instance, takes locations 2..5
+layout(location = 6) in vec4 i_uvRect; // atlas offset.xy, scale.zw
+layout(location = 7) in float i_layer;
+
+out vec3 f_tex;
+
+layout(std140) uniform Frame {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProj;
+    vec4 cameraPosition;
+    float time;
+};
+
+void main() {
+    f_tex = vec3(i_uvRect.xy + v_tex * i_uvRect.zw, i_layer);
+    gl_Position = viewProj * i_model * vec4(v_pos, 1.0);
+}
@@ -0,0 +1,44 @@
+#include "bench.hpp"
+
+#include <iostream>
+
+namespace bench {
+
+    namespace {
+        struct entry {
+            const char* name;
+            int (*fn)();
+            const char* description;
+        };
+
+        const entry entries[] = {
+            { "instancing", instancing, "per-cube draw loop vs one instanced draw (1k/10k/100k cubes)" },
+            { "parser",     parser,     "text .mo parsing throughput, istream vs from_chars (1M/10M values)" },
+            { "parser_threads", parserThreads, "chunked parallel .mo parsing scaling, 1..N threads" },
+            { "weld",       weld,       "vertex welding of triangle soup, exact and epsilon (200k/2M triangles)" },
+            { "lod",        lod,        "screen-size LOD selection over 1k/4k high-poly spheres" },
+            { "transforms", transforms, "100k world/MVP matrices, per-object glm vs batched SoA store" },
+            { "scene",      scene,      "scene graph world-transform updates, one root/leaf/all moved (100k nodes)" },
+            { "bvh",        bvh,        "BVH build/refit/frustum cull/ray cast vs linear (10k/100k/1M boxes)" },
+            { "pick",       pick,       "CPU mouse picking, BVH + SSE ray/triangle vs brute force (1M triangles)" },
+            { "texload",    texload,    "gallery texture loading, synchronous vs threaded decode + PBO streaming" },
+            { "gallery",    gallery,    "1k pictures, texture + draw per picture vs atlas array + one instanced draw" },
+        };
+    }
+
+    int run(const std::string& name) {
+        for (const auto& e : entries) {
+            if (name == e.name)
+                return e.fn();
+        }
+
+        if (!name.empty())
+            std::cerr << "Unknown benchmark: " << name << "\n";
+
+        std::cout << "Available benchmarks:\n";
+        for (const auto& e : entries)
+            std::cout << "  " << e.name << " - " << e.description << "\n";
+        return name.empty() ? 0 : 1;
+    }
+
+}
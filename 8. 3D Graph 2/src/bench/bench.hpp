@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+namespace bench {
+
+    /**
+     * @brief Benchmark entry points, selected with `out.exe --bench <name>`.
+     *
+     * Every benchmark prints its own report to stdout and returns a process
+     * exit code. `out.exe --bench` without a name lists the available ones.
+     */
+    int run(const std::string& name);
+
+    int instancing();
+    int parser();
+    int parserThreads();
+    int weld();
+    int lod();
+    int transforms();
+    int scene();
+    int bvh();
+    int pick();
+    int texload();
+    int gallery();
+
+    /// Small wall-clock helper shared by the benchmarks
+    class stopwatch {
+    public:
+        stopwatch() : m_start(clock::now()) {}
+
+        void reset() { m_start = clock::now(); }
+
+        double ms() const {
+            return std::chrono::duration<double, std::milli>(clock::now() - m_start).count();
+        }
+
+    private:
+        using clock = std::chrono::steady_clock;
+        clock::time_point m_start;
+    };
+
+}
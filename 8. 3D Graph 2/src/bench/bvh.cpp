@@ -0,0 +1,156 @@
+#include "bench.hpp"
+
+#include "../gl/Bvh.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace bench {
+
+    namespace {
+        // Markers scattered through a cube that grows with the count, so
+        // density (and the share of the view) stays about the same
+        std::vector<gl::aabb> generateBoxes(std::size_t count, float& side) {
+            side = 10.0f * std::cbrt(static_cast<float>(count));
+            std::mt19937 rng(16);
+            std::uniform_real_distribution<float> pos(-side * 0.5f, side * 0.5f);
+            std::uniform_real_distribution<float> size(0.2f, 2.0f);
+
+            std::vector<gl::aabb> boxes(count);
+            for (auto& b : boxes) {
+                glm::vec3 c(pos(rng), pos(rng), pos(rng));
+                glm::vec3 h(size(rng), size(rng), size(rng));
+                b.min = c - h * 0.5f;
+                b.max = c + h * 0.5f;
+            }
+            return boxes;
+        }
+
+        bool rayHitsBox(const gl::aabb& b, const glm::vec3& o, const glm::vec3& inv, float& t) {
+            float t0 = 0.0f, t1 = 1e30f;
+            for (int a = 0; a < 3; a++) {
+                float n = (b.min[a] - o[a]) * inv[a], f = (b.max[a] - o[a]) * inv[a];
+                if (n > f)
+                    std::swap(n, f);
+                t0 = std::max(t0, n);
+                t1 = std::min(t1, f);
+            }
+            t = t0;
+            return t0 <= t1;
+        }
+    }
+
+    int bvh() {
+        std::printf("%8s | %-18s | %10s | %s\n", "objects", "step", "ms", "notes");
+
+        for (std::size_t count : { 10000u, 100000u, 1000000u }) {
+            float side;
+            std::vector<gl::aabb> boxes = generateBoxes(count, side);
+            auto print = [&](const char* step, double ms, const char* fmt = "", double a = 0, double b = 0) {
+                char notes[96];
+                std::snprintf(notes, sizeof(notes), fmt, a, b);
+                std::printf("%8zu | %-18s | %10.3f | %s\n", count, step, ms, notes);
+            };
+
+            gl::Bvh tree;
+            stopwatch sw;
+            tree.build(boxes);
+            gl::Bvh::Stats st = tree.stats();
+            print("build (SAH)", sw.ms(), "%.0f nodes, depth %.0f", static_cast<double>(st.nodes), static_cast<double>(st.depth));
+
+            // Everything drifts a little: same tree, new boxes
+            std::mt19937 rng(5);
+            std::uniform_real_distribution<float> drift(-0.5f, 0.5f);
+            for (auto& b : boxes) {
+                glm::vec3 d(drift(rng), drift(rng), drift(rng));
+                b.min += d;
+                b.max += d;
+            }
+            sw.reset();
+            tree.refit(boxes);
+            print("refit all", sw.ms());
+
+            // One object moves, the way a single animated picture would
+            const int moves = 1000;
+            sw.reset();
+            for (int i = 0; i < moves; i++) {
+                std::uint32_t o = static_cast<std::uint32_t>((i * 7919u) % count);
+                boxes[o].min.x += 0.01f;
+                boxes[o].max.x += 0.01f;
+                tree.refit(o, boxes[o]);
+            }
+            print("refit one", sw.ms() / moves, "per object");
+
+            // A camera at the edge of the cloud looking in (about half
+            // visible), and one inside it with a short view distance
+            gl::CullBatch batch;
+            for (const auto& b : boxes) {
+                glm::vec3 c = b.center();
+                batch.add(glm::vec4(c, glm::length(b.max - c)));
+            }
+            const struct { const char* bvh; const char* linear; glm::mat4 viewProj; } views[] = {
+                { "cull wide (BVH)", "cull wide (linear)",
+                    glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, side) *
+                    glm::lookAt(glm::vec3(0.0f, 0.0f, side * 0.6f), glm::vec3(0.0f), glm::vec3(0, 1, 0)) },
+                { "cull near (BVH)", "cull near (linear)",
+                    glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 50.0f) *
+                    glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0, 1, 0)) },
+            };
+
+            std::vector<std::uint32_t> visible;
+            const int queries = 20;
+            for (const auto& v : views) {
+                gl::Frustum frustum(v.viewProj);
+                sw.reset();
+                for (int i = 0; i < queries; i++)
+                    tree.cull(frustum, visible);
+                print(v.bvh, sw.ms() / queries, "%.0f visible", static_cast<double>(visible.size()));
+
+                std::size_t linearVisible = 0;
+                sw.reset();
+                for (int i = 0; i < queries; i++)
+                    linearVisible = batch.cull(frustum);
+                print(v.linear, sw.ms() / queries, "%.0f visible (spheres)", static_cast<double>(linearVisible));
+            }
+
+            // Random rays through the cloud: BVH vs testing every box
+            const int rays = count >= 1000000 ? 200 : 1000;
+            std::uniform_real_distribution<float> dir(-1.0f, 1.0f);
+            std::vector<glm::vec3> dirs(rays);
+            for (auto& d : dirs)
+                d = glm::normalize(glm::vec3(dir(rng), dir(rng), dir(rng)) + glm::vec3(0, 0, -0.1f));
+            const glm::vec3 origin(0.0f, 0.0f, side * 0.6f);
+
+            std::size_t hits = 0;
+            sw.reset();
+            std::vector<gl::Bvh::Hit> bvhHits(rays);
+            for (int r = 0; r < rays; r++) {
+                bvhHits[r] = tree.raycast(origin, dirs[r]);
+                hits += bvhHits[r].object != gl::Bvh::invalid;
+            }
+            print("ray (BVH)", sw.ms() / rays, "per ray, %.0f/%.0f hit", static_cast<double>(hits), rays);
+
+            int mismatches = 0;
+            sw.reset();
+            for (int r = 0; r < rays; r++) {
+                glm::vec3 inv = 1.0f / dirs[r];
+                float best = 1e30f;
+                for (const auto& b : boxes) {
+                    float t;
+                    if (rayHitsBox(b, origin, inv, t) && t < best)
+                        best = t;
+                }
+                bool hit = best < 1e30f;
+                if (hit != (bvhHits[r].object != gl::Bvh::invalid) || (hit && std::abs(best - bvhHits[r].t) > 1e-3f))
+                    mismatches++;
+            }
+            print("ray (linear)", sw.ms() / rays, "per ray, %.0f mismatches", mismatches);
+        }
+        return 0;
+    }
+
+}
@@ -0,0 +1,215 @@
+#include "bench.hpp"
+
+#include "../main.hpp"
+#include "../gl/Shader.hpp"
+#include "../gl/Mesh.hpp"
+#include "../gl/PictureBatch.hpp"
+#include "../gl/RenderQueue.hpp"
+#include "../gl/Texture.hpp"
+#include "../gl/TextureAtlas.hpp"
+#include "../gl/UniformBuffer.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace bench {
+
+    namespace {
+        const int frames = 60;
+        const int images = 1000;
+        const int columns = 40;
+
+        struct result {
+            double submitMs; // CPU time spent issuing the frame
+            double frameMs;  // submit + glFinish
+            std::size_t draws, binds;
+        };
+
+        template<typename F>
+        result measure(F&& drawFrame) {
+            auto& stats = gl::render_stats::global();
+            stats.reset();
+            result r{ 0, 0, 0, 0 };
+            for (int f = 0; f < frames; f++) {
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+                stopwatch sw;
+                drawFrame();
+                r.submitMs += sw.ms();
+                glFinish();
+                r.frameMs += sw.ms();
+
+                window.swapBuffers();
+                window.pollEvents();
+            }
+            r.submitMs /= frames;
+            r.frameMs /= frames;
+            r.draws = stats.draws / frames;
+            r.binds = stats.textures / frames;
+            return r;
+        }
+
+        struct picture {
+            int width, height;
+            std::vector<unsigned char> rgba;
+            glm::mat4 model; // unit quad scaled to fit one grid cell
+        };
+
+        // Distinct images: a colour ramp per picture with a checker on top,
+        // sizes from 48 to 320 texels a side
+        std::vector<picture> makeGallery() {
+            std::mt19937 rng(25);
+            std::uniform_int_distribution<int> size(48, 320);
+            std::uniform_int_distribution<int> channel(40, 255);
+
+            std::vector<picture> gallery(images);
+            const int rows = (images + columns - 1) / columns;
+            for (int i = 0; i < images; i++) {
+                picture& p = gallery[i];
+                p.width = size(rng);
+                p.height = size(rng);
+                const int r = channel(rng), g = channel(rng), b = channel(rng);
+                p.rgba.resize(static_cast<std::size_t>(p.width) * p.height * 4);
+                for (int y = 0; y < p.height; y++) {
+                    for (int x = 0; x < p.width; x++) {
+                        unsigned char* px = p.rgba.data() + (static_cast<std::size_t>(y) * p.width + x) * 4;
+                        const bool dark = ((x / 16) + (y / 16)) % 2 != 0;
+                        px[0] = static_cast<unsigned char>(r * x / p.width);
+                        px[1] = static_cast<unsigned char>(g * y / p.height);
+                        px[2] = static_cast<unsigned char>(dark ? b / 2 : b);
+                        px[3] = 255;
+                    }
+                }
+
+                const float scale = 0.9f / std::max(p.width, p.height);
+                const glm::vec3 at(i % columns - columns * 0.5f + 0.5f, rows * 0.5f - i / columns - 0.5f, 0.0f);
+                p.model = glm::scale(glm::translate(glm::mat4(1), at), glm::vec3(p.width * scale, p.height * scale, 1.0f));
+            }
+            return gallery;
+        }
+    }
+
+    int gallery() {
+        if (!window.init(800, 600, "bench: gallery"))
+            return 1;
+        glfwSwapInterval(0);
+        glEnable(GL_DEPTH_TEST);
+
+        gl::UniformBuffer frameBuffer;
+        frameBuffer.create(gl::frame_uniforms::block, gl::frame_uniforms::binding, sizeof(gl::frame_uniforms));
+
+        gl::Shader s_cube;
+        s_cube.attach("./shaders/cube");
+        gl::Shader s_pictures;
+        s_pictures.attach("./shaders/pictures");
+
+        // The whole 40 x 25 grid in view
+        glm::mat4 proj = glm::perspective(glm::radians(90.f), 8.f / 6.f, 0.1f, 100.f);
+        glm::mat4 view = glm::lookAt(glm::vec3(0, 0, 16), glm::vec3(0), glm::vec3(0, 1, 0));
+        gl::frame_uniforms frame;
+        frame.view = view;
+        frame.projection = proj;
+        frame.viewProj = proj * view;
+        frameBuffer.update(frame);
+
+        const std::vector<picture> gallery = makeGallery();
+
+        // One unit quad shared by both paths; only the textures differ
+        gl::Mesh quad;
+        {
+            std::vector<float> vertices = {
+                -0.5f, -0.5f, 0.0f,   0.0f, 0.0f,
+                 0.5f, -0.5f, 0.0f,   1.0f, 0.0f,
+                 0.5f,  0.5f, 0.0f,   1.0f, 1.0f,
+                -0.5f,  0.5f, 0.0f,   0.0f, 1.0f
+            };
+            std::vector<unsigned> indices = { 0,1,2, 2,3,0 };
+            gl::vertex_layout layout;
+            layout.add<float>(3);
+            layout.add<float>(2);
+            quad.upload(vertices, indices, layout);
+        }
+
+        // Per picture: a texture each, one draw and one bind each
+        std::vector<gl::Texture> textures(gallery.size());
+        std::size_t separateBytes = 0;
+        stopwatch uploadTimer;
+        for (std::size_t i = 0; i < gallery.size(); i++) {
+            textures[i].allocate(gallery[i].width, gallery[i].height);
+            textures[i].update(0, gallery[i].height, gallery[i].rgba.data());
+            textures[i].generateMipmaps();
+            separateBytes += textures[i].memorySize();
+        }
+        glFinish();
+        const double separateMs = uploadTimer.ms();
+
+        // Atlas: every picture in a few array layers, one draw in total
+        gl::TextureAtlas atlas;
+        stopwatch atlasTimer;
+        for (const auto& p : gallery)
+            atlas.add(p.rgba.data(), p.width, p.height);
+        if (!atlas.build())
+            return 1;
+        glFinish();
+        const double atlasMs = atlasTimer.ms();
+
+        std::vector<gl::picture_instance> instances;
+        instances.reserve(gallery.size());
+        for (std::size_t i = 0; i < gallery.size(); i++) {
+            const gl::atlas_region& r = atlas.region(i);
+            instances.push_back({ gallery[i].model, r.uvRect, static_cast<float>(r.layer) });
+        }
+        gl::vertex_layout inst(quad.instanceBaseIndex(), 1);
+        for (int c = 0; c < 4; c++)
+            inst.add<float>(4);
+        inst.add<float>(4);
+        inst.add<float>(1);
+
+        std::printf("%d pictures, %dx%d to %dx%d\n", images, 48, 48, 320, 320);
+        std::printf("separate textures: %zu, %.1f MB, upload %.1f ms\n",
+            textures.size(), separateBytes / (1024.0 * 1024.0), separateMs);
+        std::printf("atlas: %d layers of %dx%d, fill %.1f%%, %.1f MB, pack %.1f ms, build %.1f ms\n",
+            atlas.layers(), atlas.layerSize(), atlas.layerSize(), atlas.fill() * 100.0,
+            atlas.texture().memorySize() / (1024.0 * 1024.0), atlas.packMs(), atlasMs);
+
+        std::printf("%-26s | %10s | %10s | %6s | %6s\n", "path", "submit ms", "frame ms", "draws", "binds");
+
+        gl::RenderQueue queue;
+        result separate = measure([&] {
+            for (std::size_t i = 0; i < gallery.size(); i++) {
+                gl::RenderQueue::Draw d;
+                d.shader = &s_cube;
+                d.mesh = &quad;
+                d.texture = textures[i].id();
+                d.mode = 2; // MODE: Textured
+                d.matrix = gallery[i].model;
+                queue.submit(d);
+            }
+            queue.flush();
+        });
+
+        // Instances streamed every frame, as PictureBatch::update does
+        result batched = measure([&] {
+            quad.uploadInstances(instances.data(), instances.size() * sizeof(gl::picture_instance), inst);
+            gl::RenderQueue::Draw d;
+            d.shader = &s_pictures;
+            d.mesh = &quad;
+            d.texture = atlas.texture().id();
+            d.textureTarget = GL_TEXTURE_2D_ARRAY;
+            d.matrixUniform = {};
+            d.instances = static_cast<GLsizei>(instances.size());
+            queue.submit(d);
+            queue.flush();
+        });
+
+        std::printf("%-26s | %10.3f | %10.3f | %6zu | %6zu\n", "texture per picture", separate.submitMs, separate.frameMs, separate.draws, separate.binds);
+        std::printf("%-26s | %10.3f | %10.3f | %6zu | %6zu\n", "atlas, one instanced draw", batched.submitMs, batched.frameMs, batched.draws, batched.binds);
+
+        return 0;
+    }
+
+}
@@ -0,0 +1,115 @@
+#include "bench.hpp"
+
+#include "../main.hpp"
+#include "../gl/Shader.hpp"
+#include "../gl/Mesh.hpp"
+#include "../gl/MeshParser.hpp"
+#include "../gl/UniformBuffer.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace bench {
+
+    namespace {
+        const int frames = 60;
+
+        struct result {
+            double submitMs; // CPU time spent issuing the frame
+            double frameMs;  // submit + glFinish
+        };
+
+        template<typename F>
+        result measure(F&& drawFrame) {
+            result r{ 0, 0 };
+            for (int f = 0; f < frames; f++) {
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+                stopwatch sw;
+                drawFrame();
+                r.submitMs += sw.ms();
+                glFinish();
+                r.frameMs += sw.ms();
+
+                window.swapBuffers();
+                window.pollEvents();
+            }
+            r.submitMs /= frames;
+            r.frameMs /= frames;
+            return r;
+        }
+    }
+
+    int instancing() {
+        if (!window.init(800, 600, "bench: instancing"))
+            return 1;
+        glfwSwapInterval(0);
+        glEnable(GL_DEPTH_TEST);
+
+        gl::UniformBuffer frameBuffer;
+        frameBuffer.create(gl::frame_uniforms::block, gl::frame_uniforms::binding, sizeof(gl::frame_uniforms));
+
+        gl::Shader s_colors;
+        s_colors.attach("./shaders/colors");
+        s_colors.use();
+        auto unif_model = s_colors.getUniform("model");
+
+        gl::Shader s_instanced;
+        s_instanced.attach("./shaders/colors_instanced");
+
+        gl::Mesh m_cube = gl::MeshParser::loadModel("./models/cube.mo");
+
+        glm::mat4 proj = glm::perspective(glm::radians(75.f), 8.f / 6.f, 0.1f, 1000.f);
+        glm::mat4 view = glm::lookAt(glm::vec3(0, 0, 120), glm::vec3(0), glm::vec3(0, 1, 0));
+        gl::frame_uniforms frame;
+        frame.view = view;
+        frame.projection = proj;
+        frame.viewProj = proj * view;
+        frameBuffer.update(frame);
+
+        std::printf("%8s | %-20s | %10s | %10s | %6s\n", "cubes", "path", "submit ms", "frame ms", "draws");
+
+        for (int n : { 1000, 10000, 100000 }) {
+            // Lay the cubes out in a grid roughly centered on the origin
+            int side = static_cast<int>(std::ceil(std::cbrt(static_cast<double>(n))));
+            std::vector<glm::mat4> models;
+            models.reserve(n);
+            for (int i = 0; i < n; i++) {
+                glm::vec3 p(i % side, (i / side) % side, i / (side * side));
+                models.push_back(glm::translate(glm::mat4(1), 2.f * p - float(side)));
+            }
+
+            s_colors.use();
+            result loop = measure([&] {
+                for (const auto& m : models) {
+                    unif_model = m;
+                    m_cube.draw();
+                }
+            });
+
+            gl::vertex_layout inst(m_cube.instanceBaseIndex(), 1);
+            for (int c = 0; c < 4; c++) inst.add<float>(4);
+
+            s_instanced.use();
+            m_cube.uploadInstances(models.data(), models.size() * sizeof(glm::mat4), inst);
+            result staticInst = measure([&] {
+                m_cube.drawInstanced();
+            });
+
+            result streamedInst = measure([&] {
+                m_cube.uploadInstances(models.data(), models.size() * sizeof(glm::mat4), inst);
+                m_cube.drawInstanced();
+            });
+
+            std::printf("%8d | %-20s | %10.3f | %10.3f | %6d\n", n, "draw loop", loop.submitMs, loop.frameMs, n);
+            std::printf("%8d | %-20s | %10.3f | %10.3f | %6d\n", n, "instanced", staticInst.submitMs, staticInst.frameMs, 1);
+            std::printf("%8d | %-20s | %10.3f | %10.3f | %6d\n", n, "instanced + upload", streamedInst.submitMs, streamedInst.frameMs, 1);
+        }
+
+        return 0;
+    }
+
+}
@@ -0,0 +1,147 @@
+#include "bench.hpp"
+
+#include "../main.hpp"
+#include "../gl/Shader.hpp"
+#include "../gl/Model.hpp"
+#include "../gl/MeshSimplifier.hpp"
+#include "../gl/UniformBuffer.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <numbers>
+#include <vector>
+
+namespace bench {
+
+    namespace {
+        const int frames = 60;
+        const float viewportHeight = 600.0f;
+
+        // Unit UV sphere with rings x segments quads, position + color
+        gl::MeshData generateSphere(int rings, int segments) {
+            gl::MeshData md;
+            md.layout.add<float>(3).tag(gl::vertex_layout::semantic::position);
+            md.layout.add<float>(3).tag(gl::vertex_layout::semantic::color);
+
+            std::vector<float> v;
+            for (int i = 0; i <= rings; i++) {
+                for (int j = 0; j < segments; j++) {
+                    double theta = std::numbers::pi * i / rings;
+                    double phi = 2.0 * std::numbers::pi * j / segments;
+                    float x = static_cast<float>(std::sin(theta) * std::cos(phi));
+                    float y = static_cast<float>(std::cos(theta));
+                    float z = static_cast<float>(std::sin(theta) * std::sin(phi));
+                    v.insert(v.end(), { x, y, z, x * 0.5f + 0.5f, y * 0.5f + 0.5f, z * 0.5f + 0.5f });
+                }
+            }
+            for (int i = 0; i < rings; i++) {
+                for (int j = 0; j < segments; j++) {
+                    unsigned a = i * segments + j, b = i * segments + (j + 1) % segments;
+                    unsigned c = a + segments, d = b + segments;
+                    md.indices.insert(md.indices.end(), { a, c, b, b, c, d });
+                }
+            }
+
+            md.vertices.resize(v.size() * sizeof(float));
+            std::memcpy(md.vertices.data(), v.data(), md.vertices.size());
+            return md;
+        }
+    }
+
+    int lod() {
+        if (!window.init(800, 600, "bench: lod"))
+            return 1;
+        glfwSwapInterval(0);
+        glEnable(GL_DEPTH_TEST);
+
+        gl::UniformBuffer frameBuffer;
+        frameBuffer.create(gl::frame_uniforms::block, gl::frame_uniforms::binding, sizeof(gl::frame_uniforms));
+
+        gl::Shader s_colors;
+        s_colors.attach("./shaders/colors");
+        s_colors.use();
+        auto unif_model = s_colors.getUniform("model");
+
+        // One 65k triangle sphere, drawn at every grid cell
+        gl::MeshData md = generateSphere(128, 256);
+        stopwatch build;
+        std::vector<gl::MeshSimplifier::Level> levels = gl::MeshSimplifier::buildLods(md, 4);
+        double buildMs = build.ms();
+
+        gl::Model sphere;
+        sphere.upload(md);
+        std::vector<gl::Mesh> meshes;
+        std::vector<float> errors;
+        for (auto& l : levels) {
+            meshes.emplace_back();
+            meshes.back().upload(l.data);
+            errors.push_back(l.error);
+        }
+        sphere.setLods(std::move(meshes), errors);
+
+        std::printf("sphere: %zu triangles, %zu levels built in %.1f ms\n", md.indices.size() / 3, levels.size(), buildMs);
+        for (std::size_t i = 0; i < sphere.lodCount(); i++)
+            std::printf("  level %zu: %7d triangles, error %.5f\n", i, sphere.lodMesh(i).indexCount() / 3,
+                i ? errors[i - 1] : 0.0f);
+
+        gl::Camera cam(glm::vec3(0, 20, 10), glm::vec3(0, 1, 0), glm::vec3(0, -0.3f, -1));
+        glm::mat4 proj = glm::perspective(glm::radians(75.f), 8.f / 6.f, 0.1f, 2000.f);
+        gl::frame_uniforms frame;
+        frame.view = cam.getMatrix();
+        frame.projection = proj;
+        frame.viewProj = proj * frame.view;
+        frame.cameraPosition = glm::vec4(cam.getPosition(), 1.0f);
+        frameBuffer.update(frame);
+
+        std::printf("\n%8s | %-10s | %12s | %10s | %10s\n", "models", "path", "triangles", "submit ms", "frame ms");
+
+        for (int side : { 32, 64 }) {
+            // Grid stretching from the camera out to a few hundred units
+            std::vector<glm::vec3> positions;
+            for (int z = 0; z < side; z++)
+                for (int x = 0; x < side; x++)
+                    positions.push_back(glm::vec3((x - side / 2) * 6.0f, 0.0f, -z * 6.0f));
+
+            for (bool useLod : { false, true }) {
+                double submitMs = 0, frameMs = 0;
+                long long triangles = 0;
+                std::size_t perLevel[8] = {};
+
+                for (int f = 0; f < frames; f++) {
+                    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+                    stopwatch sw;
+                    for (const auto& p : positions) {
+                        sphere.setPosition(p);
+                        std::size_t level = useLod ? sphere.selectLod(cam, proj, viewportHeight) : 0;
+                        unif_model = sphere.modelMatrix();
+                        sphere.lodMesh(level).draw();
+                        triangles += sphere.lodMesh(level).indexCount() / 3;
+                        perLevel[level]++;
+                    }
+                    submitMs += sw.ms();
+                    glFinish();
+                    frameMs += sw.ms();
+
+                    window.swapBuffers();
+                    window.pollEvents();
+                }
+
+                std::printf("%8zu | %-10s | %12lld | %10.3f | %10.3f\n", positions.size(), useLod ? "lod" : "full",
+                    triangles / frames, submitMs / frames, frameMs / frames);
+                if (useLod) {
+                    std::printf("%8s   levels:", "");
+                    for (std::size_t i = 0; i < sphere.lodCount(); i++)
+                        std::printf(" %zu", perLevel[i] / frames);
+                    std::printf("\n");
+                }
+            }
+        }
+
+        return 0;
+    }
+
+}
@@ -0,0 +1,217 @@
+#include "bench.hpp"
+
+#include "../gl/MeshParser.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace bench {
+
+    namespace {
+        // What the original reader produced: floats only
+        struct LegacyData {
+            std::vector<float> vertices;
+            std::vector<unsigned int> indices;
+            gl::vertex_layout layout;
+            std::unordered_map<std::string, std::string> metadata;
+        };
+
+        // The original getline/istringstream reader, kept as the baseline
+        bool legacyParse(const std::string& path, LegacyData& out) {
+            std::ifstream file(path);
+            if (!file)
+                return false;
+
+            enum Section { NONE, VERTEX, INDEX };
+            Section section = NONE;
+            bool headerParsed = false;
+            std::string line;
+
+            auto trim = [](std::string& s) {
+                while (!s.empty() && std::isspace((unsigned char)s.back()))
+                    s.pop_back();
+                size_t start = 0;
+                while (start < s.size() && std::isspace((unsigned char)s[start]))
+                    ++start;
+                s = s.substr(start);
+            };
+
+            while (std::getline(file, line)) {
+                auto hash = line.find('#');
+                if (hash != std::string::npos)
+                    line = line.substr(0, hash);
+
+                trim(line);
+                if (line.empty())
+                    continue;
+
+                if (line[0] == '@') {
+                    auto colon = line.find(':');
+                    if (colon != std::string::npos) {
+                        std::string key = line.substr(1, colon - 1);
+                        std::string val = line.substr(colon + 1);
+                        trim(key);
+                        trim(val);
+                        out.metadata[key] = val;
+                    }
+                    continue;
+                }
+
+                if (line == ":vertex") {
+                    section = VERTEX;
+                    headerParsed = false;
+                    continue;
+                }
+                if (line == ":index") {
+                    section = INDEX;
+                    continue;
+                }
+
+                if (section == VERTEX) {
+                    if (!headerParsed) {
+                        std::istringstream ss(line);
+                        std::string token;
+                        while (ss >> token) {
+                            if (token.rfind("float", 0) == 0)
+                                out.layout.add<float>(std::stoi(token.substr(token.find('(') + 1)));
+                        }
+                        headerParsed = true;
+                        continue;
+                    }
+
+                    std::istringstream ss(line);
+                    float val;
+                    while (ss >> val)
+                        out.vertices.push_back(val);
+                }
+                else if (section == INDEX) {
+                    std::istringstream ss(line);
+                    unsigned int idx;
+                    while (ss >> idx)
+                        out.indices.push_back(idx);
+                }
+            }
+            return true;
+        }
+
+        // Writes a position + color model holding about `values` numbers,
+        // half vertex floats and half indices
+        void generateModel(const std::string& path, std::size_t values) {
+            std::mt19937 rng(1234);
+            std::uniform_real_distribution<float> coord(-100.f, 100.f);
+            std::uniform_real_distribution<float> color(0.f, 1.f);
+
+            std::size_t vertexCount = values / 12;
+            std::ofstream f(path);
+            f << "@name: Generated\n@color_mode: vertex\n\n:vertex\nfloat(3) float(3)\n";
+            char buf[128];
+            for (std::size_t i = 0; i < vertexCount; i++) {
+                int n = std::snprintf(buf, sizeof(buf), "%.4f %.4f %.4f   %.3f %.3f %.3f\n",
+                    coord(rng), coord(rng), coord(rng), color(rng), color(rng), color(rng));
+                f.write(buf, n);
+            }
+
+            std::uniform_int_distribution<unsigned> idx(0, static_cast<unsigned>(vertexCount - 1));
+            f << "\n:index\n# triangles\n";
+            for (std::size_t i = 0; i < values / 2 / 3; i++) {
+                int n = std::snprintf(buf, sizeof(buf), "%u %u %u\n", idx(rng), idx(rng), idx(rng));
+                f.write(buf, n);
+            }
+        }
+    }
+
+    int parserThreads() {
+        namespace fs = std::filesystem;
+
+        const std::size_t values = 10'000'000;
+        std::string path = (fs::temp_directory_path() / "bench_threads.mo").string();
+        generateModel(path, values);
+
+        // Parse from memory so the disk is out of the picture
+        std::string text;
+        {
+            std::ifstream f(path, std::ios::binary);
+            std::ostringstream ss;
+            ss << f.rdbuf();
+            text = ss.str();
+        }
+        fs::remove(path);
+        double mb = static_cast<double>(text.size()) / (1024.0 * 1024.0);
+
+        gl::MeshData serial;
+        gl::MeshParser::setThreadCount(1);
+        gl::MeshParser::parseBuffer(text, serial);
+
+        unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+        std::printf("%.1f MB, %zu vertices, %zu indices\n", mb, serial.vertexCount(), serial.indices.size());
+        std::printf("%8s | %10s | %9s | %8s | %s\n", "threads", "ms", "MB/s", "speedup", "identical");
+
+        double baseMs = 0;
+        for (unsigned t = 1; t <= maxThreads; t++) {
+            gl::MeshParser::setThreadCount(t);
+
+            // Best of three, the first run also warms the pool up
+            double best = 1e300;
+            gl::MeshData md;
+            for (int run = 0; run < 3; run++) {
+                md = gl::MeshData();
+                stopwatch sw;
+                gl::MeshParser::parseBuffer(text, md);
+                best = std::min(best, sw.ms());
+            }
+            if (t == 1)
+                baseMs = best;
+
+            bool same = md.vertices == serial.vertices && md.indices == serial.indices;
+            std::printf("%8u | %10.1f | %9.1f | %7.2fx | %s\n", t, best, mb / (best / 1000.0), baseMs / best, same ? "yes" : "NO");
+        }
+
+        gl::MeshParser::setThreadCount(0);
+        return 0;
+    }
+
+    int parser() {
+        namespace fs = std::filesystem;
+
+        std::printf("%10s | %9s | %-10s | %10s | %9s\n", "values", "MB", "parser", "ms", "MB/s");
+        for (std::size_t values : { std::size_t(1'000'000), std::size_t(10'000'000) }) {
+            std::string path = (fs::temp_directory_path() / ("bench_" + std::to_string(values) + ".mo")).string();
+            generateModel(path, values);
+            double mb = static_cast<double>(fs::file_size(path)) / (1024.0 * 1024.0);
+
+            LegacyData legacy;
+            gl::MeshData fast;
+            gl::MeshParser::setThreadCount(1);
+
+            stopwatch sw;
+            legacyParse(path, legacy);
+            double legacyMs = sw.ms();
+
+            sw.reset();
+            gl::MeshParser::parseFile(path, fast);
+            double fastMs = sw.ms();
+
+            std::printf("%10zu | %9.1f | %-10s | %10.1f | %9.1f\n", values, mb, "istream", legacyMs, mb / (legacyMs / 1000.0));
+            std::printf("%10zu | %9.1f | %-10s | %10.1f | %9.1f\n", values, mb, "from_chars", fastMs, mb / (fastMs / 1000.0));
+
+            bool same = legacy.vertices.size() * sizeof(float) == fast.vertices.size() && legacy.indices == fast.indices &&
+                std::memcmp(legacy.vertices.data(), fast.vertices.data(), fast.vertices.size()) == 0;
+            if (!same)
+                std::printf("  warning: parsers disagree on %s\n", path.c_str());
+
+            fs::remove(path);
+        }
+        gl::MeshParser::setThreadCount(0);
+        return 0;
+    }
+
+}
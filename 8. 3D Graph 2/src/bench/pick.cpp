@@ -0,0 +1,133 @@
+#include "bench.hpp"
+
+#include "../gl/Picker.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <numbers>
+#include <random>
+#include <vector>
+
+namespace bench {
+
+    namespace {
+        struct SphereMesh {
+            std::vector<float> positions; // xyz
+            std::vector<unsigned> indices;
+        };
+
+        // UV sphere with 2 * rings * segments triangles (minus the pole slivers)
+        SphereMesh generateSphere(int rings, int segments) {
+            SphereMesh m;
+            for (int r = 0; r <= rings; r++) {
+                float phi = std::numbers::pi_v<float> * r / rings;
+                for (int s = 0; s <= segments; s++) {
+                    float theta = 2.0f * std::numbers::pi_v<float> * s / segments;
+                    m.positions.push_back(std::sin(phi) * std::cos(theta));
+                    m.positions.push_back(std::cos(phi));
+                    m.positions.push_back(std::sin(phi) * std::sin(theta));
+                }
+            }
+            for (int r = 0; r < rings; r++) {
+                for (int s = 0; s < segments; s++) {
+                    unsigned a = r * (segments + 1) + s, b = a + segments + 1;
+                    m.indices.insert(m.indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+                }
+            }
+            return m;
+        }
+
+        // Plain scalar Möller-Trumbore over every triangle, as the reference
+        float bruteForce(const SphereMesh& m, const glm::vec3& o, const glm::vec3& d) {
+            float best = 1e30f;
+            auto p = [&](unsigned i) { return glm::vec3(m.positions[i * 3], m.positions[i * 3 + 1], m.positions[i * 3 + 2]); };
+            for (std::size_t i = 0; i + 2 < m.indices.size(); i += 3) {
+                glm::vec3 a = p(m.indices[i]);
+                glm::vec3 e1 = p(m.indices[i + 1]) - a, e2 = p(m.indices[i + 2]) - a;
+                glm::vec3 pv = glm::cross(d, e2);
+                float det = glm::dot(e1, pv);
+                if (std::abs(det) <= 1e-12f)
+                    continue;
+                glm::vec3 tv = o - a;
+                float u = glm::dot(tv, pv) / det;
+                glm::vec3 qv = glm::cross(tv, e1);
+                float v = glm::dot(d, qv) / det;
+                float t = glm::dot(e2, qv) / det;
+                if (u >= 0 && v >= 0 && u + v <= 1 && t >= 0 && t < best)
+                    best = t;
+            }
+            return best;
+        }
+    }
+
+    int pick() {
+        // 16 spheres of 64k triangles each, about 1M triangles in view
+        const int grid = 4;
+        SphereMesh sphere = generateSphere(128, 256);
+
+        stopwatch sw;
+        gl::PickMesh mesh;
+        mesh.build(sphere.positions.data(), sphere.positions.size() / 3, sizeof(float) * 3,
+            sphere.indices.data(), sphere.indices.size());
+        double buildMs = sw.ms();
+
+        gl::Picker picker;
+        std::vector<glm::mat4> models;
+        for (int x = 0; x < grid; x++) {
+            for (int y = 0; y < grid; y++) {
+                glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3((x - 1.5f) * 3.0f, (y - 1.5f) * 3.0f, 0.0f));
+                m = glm::scale(m, glm::vec3(1.0f + 0.1f * x, 1.0f, 1.0f + 0.1f * y));
+                models.push_back(m);
+                picker.add(mesh, m);
+            }
+        }
+        const std::size_t triangles = mesh.triangleCount() * models.size();
+        std::printf("%zu triangles in %zu objects\n", triangles, models.size());
+        std::printf("%-24s | %10s\n", "step", "ms");
+        std::printf("%-24s | %10.3f\n", "PickMesh build", buildMs);
+
+        // Clicks all over an 800x600 window
+        const glm::vec2 viewport(800.0f, 600.0f);
+        const glm::mat4 projection = glm::perspective(glm::radians(75.0f), viewport.x / viewport.y, 0.1f, 1000.0f);
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 7.0f), glm::vec3(0.0f), glm::vec3(0, 1, 0));
+        std::mt19937 rng(17);
+        std::uniform_real_distribution<float> px(0.0f, viewport.x), py(0.0f, viewport.y);
+
+        const int clicks = 1000;
+        std::vector<gl::Picker::Ray> rays(clicks);
+        for (auto& r : rays)
+            r = gl::Picker::unproject(glm::vec2(px(rng), py(rng)), viewport, projection, view);
+
+        std::vector<gl::Picker::Hit> hits(clicks);
+        int hitCount = 0;
+        sw.reset();
+        for (int i = 0; i < clicks; i++) {
+            hits[i] = picker.pick(rays[i]);
+            hitCount += hits[i].object != gl::Picker::invalid;
+        }
+        std::printf("%-24s | %10.4f | %d/%d hit\n", "pick (BVH + SSE)", sw.ms() / clicks, hitCount, clicks);
+
+        // The reference tests every triangle of every object, so only a few rays
+        const int checked = 40;
+        int mismatches = 0;
+        sw.reset();
+        for (int i = 0; i < checked; i++) {
+            float best = 1e30f;
+            for (const auto& m : models) {
+                glm::mat4 inv = glm::inverse(m);
+                glm::vec3 o = glm::vec3(inv * glm::vec4(rays[i].origin, 1.0f));
+                glm::vec3 d = glm::vec3(inv * glm::vec4(rays[i].dir, 0.0f));
+                best = std::min(best, bruteForce(sphere, o, d));
+            }
+            bool hit = best < 1e30f;
+            if (hit != (hits[i].object != gl::Picker::invalid) || (hit && std::abs(best - hits[i].t) > 1e-3f * best))
+                mismatches++;
+        }
+        std::printf("%-24s | %10.4f | %d mismatches\n", "pick (brute force)", sw.ms() / checked, mismatches);
+        return mismatches ? 1 : 0;
+    }
+
+}
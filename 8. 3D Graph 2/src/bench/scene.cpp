@@ -0,0 +1,95 @@
+#include "bench.hpp"
+
+#include "../gl/SceneGraph.hpp"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace bench {
+
+    namespace {
+        // `roots` trees of `perRoot` nodes each; every node hangs off a
+        // random earlier node of its own tree, giving uneven depths
+        std::vector<gl::SceneGraph::node> buildForest(gl::SceneGraph& scene, std::size_t roots, std::size_t perRoot,
+            std::vector<gl::SceneGraph::node>& rootNodes) {
+            std::mt19937 rng(21);
+            std::uniform_real_distribution<float> offset(-2.0f, 2.0f);
+
+            std::vector<gl::SceneGraph::node> nodes;
+            nodes.reserve(roots * perRoot);
+            for (std::size_t r = 0; r < roots; r++) {
+                std::size_t first = nodes.size();
+                for (std::size_t i = 0; i < perRoot; i++) {
+                    gl::SceneGraph::node parent = gl::SceneGraph::none;
+                    if (i > 0)
+                        parent = nodes[first + std::uniform_int_distribution<std::size_t>(0, i - 1)(rng)];
+                    gl::SceneGraph::node n = scene.create(parent);
+                    scene.setPosition(n, { offset(rng), offset(rng), offset(rng) });
+                    nodes.push_back(n);
+                }
+                rootNodes.push_back(nodes[first]);
+            }
+            return nodes;
+        }
+    }
+
+    int scene() {
+        const int repeats = 50;
+
+        std::printf("%8s | %8s | %-22s | %10s | %10s\n", "nodes", "roots", "update", "recomputed", "ms");
+        auto print = [](std::size_t nodes, std::size_t roots, const char* what, std::size_t updated, double ms) {
+            std::printf("%8zu | %8zu | %-22s | %10zu | %10.4f\n", nodes, roots, what, updated, ms);
+        };
+
+        struct shape { std::size_t roots, perRoot; };
+        for (shape s : { shape{ 1000, 100 }, shape{ 100, 1000 }, shape{ 1, 100000 } }) {
+            gl::SceneGraph scene;
+            std::vector<gl::SceneGraph::node> roots;
+            std::vector<gl::SceneGraph::node> nodes = buildForest(scene, s.roots, s.perRoot, roots);
+            const std::size_t count = nodes.size();
+
+            stopwatch sw;
+            scene.update();
+            print(count, s.roots, "full (reorder)", scene.stats().updated, sw.ms());
+
+            // Idle frame: nothing moved
+            sw.reset();
+            for (int i = 0; i < repeats; i++)
+                scene.update();
+            print(count, s.roots, "nothing moved", scene.stats().updated, sw.ms() / repeats);
+
+            // One root moved: only its subtree is walked
+            std::size_t updated = 0;
+            sw.reset();
+            for (int i = 0; i < repeats; i++) {
+                scene.translate(roots[i % roots.size()], { 0.1f, 0.0f, 0.0f });
+                scene.update();
+                updated += scene.stats().updated;
+            }
+            print(count, s.roots, "one root moved", updated / repeats, sw.ms() / repeats);
+
+            // One leaf-ish node moved (the last created in a tree)
+            updated = 0;
+            sw.reset();
+            for (int i = 0; i < repeats; i++) {
+                std::size_t tree = i % roots.size();
+                scene.translate(nodes[tree * s.perRoot + s.perRoot - 1], { 0.1f, 0.0f, 0.0f });
+                scene.update();
+                updated += scene.stats().updated;
+            }
+            print(count, s.roots, "one leaf moved", updated / repeats, sw.ms() / repeats);
+
+            // Every root moved: whole graph, one linear pass
+            sw.reset();
+            for (int i = 0; i < repeats / 10; i++) {
+                for (auto r : roots)
+                    scene.translate(r, { 0.1f, 0.0f, 0.0f });
+                scene.update();
+            }
+            print(count, s.roots, "all roots moved", scene.stats().updated, sw.ms() / (repeats / 10));
+        }
+        return 0;
+    }
+
+}
@@ -0,0 +1,95 @@
+#include "bench.hpp"
+
+#include "../main.hpp"
+#include "../gl/Texture.hpp"
+#include "../gl/TextureLoader.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+    namespace {
+        // Every image in ./imgs, repeated to make a small gallery
+        std::vector<std::string> galleryPaths(int copies) {
+            std::vector<std::string> images;
+            for (const auto& entry : std::filesystem::directory_iterator("./imgs")) {
+                if (entry.is_regular_file())
+                    images.push_back(entry.path().string());
+            }
+            std::sort(images.begin(), images.end());
+
+            std::vector<std::string> paths;
+            for (int c = 0; c < copies; c++)
+                paths.insert(paths.end(), images.begin(), images.end());
+            return paths;
+        }
+
+        void present() {
+            glFinish();
+            window.swapBuffers();
+            window.pollEvents();
+        }
+    }
+
+    int texload() {
+        if (!window.init(800, 600, "bench: texload"))
+            return 1;
+        glfwSwapInterval(0);
+
+        const std::vector<std::string> paths = galleryPaths(4);
+        if (paths.empty()) {
+            std::printf("no images in ./imgs\n");
+            return 1;
+        }
+
+        std::printf("%zu textures\n", paths.size());
+        std::printf("%-22s | %12s | %14s | %14s | %6s\n", "path", "first frame", "worst frame", "all loaded", "frames");
+
+        // Synchronous: nothing is drawn until every image is decoded and uploaded
+        {
+            std::vector<gl::Texture> textures(paths.size());
+            stopwatch sw;
+            for (std::size_t i = 0; i < paths.size(); i++)
+                textures[i].loadFromFile(paths[i]);
+            present();
+            double ms = sw.ms();
+            std::printf("%-22s | %9.1f ms | %11.1f ms | %11.1f ms | %6d\n", "loadFromFile", ms, ms, ms, 1);
+        }
+
+        for (std::size_t budget : { std::size_t(1) << 20, std::size_t(4) << 20, std::size_t(16) << 20 }) {
+            std::vector<gl::Texture> textures(paths.size());
+            gl::texture_load_stats::global().reset();
+            gl::TextureLoader loader(budget);
+
+            stopwatch total;
+            for (std::size_t i = 0; i < paths.size(); i++)
+                loader.load(textures[i], paths[i]);
+
+            double firstFrame = 0, worstFrame = 0;
+            int frames = 0;
+            do {
+                stopwatch frame;
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                loader.update();
+                present();
+                worstFrame = std::max(worstFrame, frame.ms());
+                if (frames++ == 0)
+                    firstFrame = total.ms();
+            } while (!loader.idle());
+
+            char name[32];
+            std::snprintf(name, sizeof(name), "async, %zu MB/frame", budget >> 20);
+            std::printf("%-22s | %9.1f ms | %11.1f ms | %11.1f ms | %6d\n", name, firstFrame, worstFrame, total.ms(), frames);
+        }
+
+        auto& stats = gl::texture_load_stats::global();
+        std::printf("\nlast run: decode %.1f ms on workers, %zu MB uploaded, worst update %.2f ms\n",
+            stats.decodeMs, stats.bytesUploaded >> 20, stats.worstUpdateMs);
+        return 0;
+    }
+
+}
@@ -0,0 +1,129 @@
+#include "bench.hpp"
+
+#include "../gl/TransformStore.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace bench {
+
+    namespace {
+        struct object {
+            glm::vec3 position;
+            glm::quat rotation;
+            glm::vec3 scale;
+        };
+
+        std::vector<object> generateObjects(std::size_t count) {
+            std::mt19937 rng(13);
+            std::uniform_real_distribution<float> pos(-500.0f, 500.0f);
+            std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+            std::uniform_real_distribution<float> size(0.5f, 2.0f);
+
+            std::vector<object> objects(count);
+            for (auto& o : objects) {
+                o.position = { pos(rng), pos(rng), pos(rng) };
+                o.rotation = glm::angleAxis(angle(rng), glm::normalize(glm::vec3(pos(rng), pos(rng), pos(rng) + 1000.0f)));
+                o.scale = glm::vec3(size(rng));
+            }
+            return objects;
+        }
+
+        // Keeps the optimizer from dropping the matrices
+        float checksum(const glm::mat4& m) { return m[0][0] + m[1][1] + m[2][2] + m[3][0]; }
+    }
+
+    int transforms() {
+        const std::size_t count = 100000;
+        const int frames = 20;
+
+        std::vector<object> objects = generateObjects(count);
+        glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 2000.0f);
+        auto viewProjAt = [&](int frame) {
+            return proj * glm::lookAt(glm::vec3(0.0f, 50.0f, 800.0f + frame), glm::vec3(0.0f), glm::vec3(0, 1, 0));
+        };
+
+        gl::TransformStore store;
+        std::vector<gl::transform_handle> handles;
+        handles.reserve(count);
+        for (const auto& o : objects) {
+            handles.emplace_back(store);
+            handles.back().setPosition(o.position);
+            handles.back().setRotation(o.rotation);
+            handles.back().setScale(o.scale);
+        }
+        store.update();
+
+        const glm::quat spin = glm::angleAxis(0.01f, glm::vec3(0, 1, 0));
+        float sink = 0.0f;
+
+        std::printf("%zu objects, %d frames\n", count, frames);
+        std::printf("%-28s | %10s | %12s\n", "path", "ms/frame", "ns/object");
+        auto print = [&](const char* path, double ms) {
+            std::printf("%-28s | %10.3f | %12.2f\n", path, ms / frames, ms * 1e6 / frames / count);
+        };
+
+        // Everything moves every frame
+        {
+            stopwatch sw;
+            for (int f = 0; f < frames; f++) {
+                glm::mat4 viewProj = viewProjAt(f);
+                for (auto& o : objects) {
+                    o.rotation = spin * o.rotation;
+                    glm::mat4 m = glm::translate(glm::mat4(1.0f), o.position) * glm::mat4_cast(o.rotation) * glm::scale(glm::mat4(1.0f), o.scale);
+                    sink += checksum(viewProj * m);
+                }
+            }
+            print("all moving: per-object glm", sw.ms());
+        }
+        {
+            stopwatch sw;
+            for (int f = 0; f < frames; f++) {
+                glm::mat4 viewProj = viewProjAt(f);
+                for (auto& h : handles) {
+                    h.setRotation(spin * h.rotation());
+                    sink += checksum(h.mvp(viewProj));
+                }
+            }
+            print("all moving: handle mvp()", sw.ms());
+        }
+        {
+            stopwatch sw;
+            for (int f = 0; f < frames; f++) {
+                for (auto& h : handles)
+                    h.setRotation(spin * h.rotation());
+                store.update(viewProjAt(f));
+                sink += checksum(store.mvps()[f]);
+            }
+            print("all moving: batched update", sw.ms());
+        }
+
+        // Static objects, only the camera moves
+        {
+            stopwatch sw;
+            for (int f = 0; f < frames; f++) {
+                glm::mat4 viewProj = viewProjAt(f);
+                for (const auto& o : objects) {
+                    glm::mat4 m = glm::translate(glm::mat4(1.0f), o.position) * glm::mat4_cast(o.rotation) * glm::scale(glm::mat4(1.0f), o.scale);
+                    sink += checksum(viewProj * m);
+                }
+            }
+            print("camera only: per-object glm", sw.ms());
+        }
+        {
+            stopwatch sw;
+            for (int f = 0; f < frames; f++) {
+                store.update(viewProjAt(f));
+                sink += checksum(store.mvps()[f]);
+            }
+            print("camera only: batched update", sw.ms());
+        }
+
+        std::printf("(checksum %g)\n", sink);
+        return 0;
+    }
+
+}
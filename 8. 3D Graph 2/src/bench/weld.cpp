@@ -0,0 +1,64 @@
+#include "bench.hpp"
+
+#include "../gl/MeshWelder.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace bench {
+
+    namespace {
+        // A side x side grid as unindexed triangle soup: position + color,
+        // six vertices per quad. Jitter (if any) is applied per copy, the
+        // way separately exported faces drift apart.
+        gl::MeshData generateSoup(int side, float jitter) {
+            gl::MeshData md;
+            md.layout.add<float>(3).tag(gl::vertex_layout::semantic::position);
+            md.layout.add<float>(3).tag(gl::vertex_layout::semantic::color);
+
+            std::mt19937 rng(7);
+            std::uniform_real_distribution<float> noise(-jitter, jitter);
+
+            std::vector<float> v;
+            v.reserve(static_cast<std::size_t>(side) * side * 6 * 6);
+            auto push = [&](int x, int y) {
+                v.insert(v.end(), { x + noise(rng), y + noise(rng), 0.0f,
+                    static_cast<float>(x) / side, static_cast<float>(y) / side, 0.5f });
+            };
+            for (int y = 0; y < side; y++) {
+                for (int x = 0; x < side; x++) {
+                    push(x, y); push(x + 1, y); push(x, y + 1);
+                    push(x + 1, y); push(x + 1, y + 1); push(x, y + 1);
+                }
+            }
+
+            md.vertices.resize(v.size() * sizeof(float));
+            std::memcpy(md.vertices.data(), v.data(), md.vertices.size());
+            return md;
+        }
+    }
+
+    int weld() {
+        std::printf("%10s | %-12s | %10s | %10s | %10s\n", "triangles", "mode", "before", "after", "ms");
+
+        for (int side : { 316, 1000 }) {
+            struct run { const char* mode; float jitter; std::vector<float> epsilon; };
+            const run runs[] = {
+                { "exact", 0.0f, {} },
+                { "eps 1e-3", 1e-4f, { 1e-3f } },
+            };
+
+            for (const auto& r : runs) {
+                gl::MeshData md = generateSoup(side, r.jitter);
+                gl::MeshWelder::Result result;
+                gl::MeshWelder::weld(md, r.epsilon, &result);
+                std::printf("%10zu | %-12s | %10zu | %10zu | %10.2f\n", md.indices.size() / 3, r.mode,
+                    result.verticesBefore, result.verticesAfter, result.ms);
+            }
+        }
+        return 0;
+    }
+
+}
@@ -10,6 +10,10 @@ static double lastY = 0.0;
 static bool mouseCaptured = false;
 static bool escPressed = false;
 
+// Last unhandled click, see takePickRequest()
+static bool pickPending = false;
+static glm::vec2 pickCursor(0.0f), pickViewport(0.0f);
+
 // Mouse sensitivity
 static float mouseSensitivity = 0.1f;
 static float yaw = 0, pitch = 0;
@@ -26,6 +30,7 @@ static float movementSpeed = 15.0f;
 void setupControls() {
     auto handle = window.getHandle();
     glfwSetCursorPosCallback(handle, mouseLookCallback);
+    glfwSetMouseButtonCallback(handle, mouseButtonCallback);
     glfwSetFramebufferSizeCallback(handle, framebufferSizeCallback);
     
 }
@@ -113,6 +118,37 @@ void mouseLookCallback(GLFWwindow* window, double xpos, double ypos) {
 }
 
 
+// ------------------------------------------------------------
+// Mouse picking
+// ------------------------------------------------------------
+void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
+    if (button != GLFW_MOUSE_BUTTON_LEFT || action != GLFW_PRESS)
+        return;
+
+    int width, height;
+    glfwGetWindowSize(window, &width, &height);
+    pickViewport = glm::vec2(static_cast<float>(width), static_cast<float>(height));
+
+    if (mouseCaptured) {
+        pickCursor = pickViewport * 0.5f;   // crosshair
+    } else {
+        double x, y;
+        glfwGetCursorPos(window, &x, &y);
+        pickCursor = glm::vec2(static_cast<float>(x), static_cast<float>(y));
+    }
+    pickPending = true;
+}
+
+bool takePickRequest(glm::vec2& cursor, glm::vec2& viewport) {
+    if (!pickPending)
+        return false;
+    cursor = pickCursor;
+    viewport = pickViewport;
+    pickPending = false;
+    return true;
+}
+
+
 // ------------------------------------------------------------
 // Mouse capture
 // ------------------------------------------------------------
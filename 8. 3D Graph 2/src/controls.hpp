@@ -12,6 +12,12 @@ void handleKeyboardInput();
 // Mouse callback
 void mouseLookCallback(GLFWwindow* window, double xpos, double ypos);
 
+// Left click queues a pick at the cursor (the screen center while captured)
+void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
+
+// Pending pick in window pixels; false when there was no click since the last call
+bool takePickRequest(glm::vec2& cursor, glm::vec2& viewport);
+
 void framebufferSizeCallback(GLFWwindow* window, int width, int height);
 
 // Capture/release mouse toggler
@@ -0,0 +1,622 @@
+#include "BlockCompressor.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLOCK_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace gl {
+
+    namespace {
+        // One block as floats, channel by channel, so four pixels fill an SSE register
+        struct block_pixels {
+            alignas(16) float c[4][16]; // r, g, b, a
+        };
+
+        struct endpoints {
+            float e[2][4];
+        };
+
+        void loadBlock(const unsigned char rgba[64], block_pixels& px) {
+            for (int i = 0; i < 16; i++) {
+                for (int ch = 0; ch < 4; ch++)
+                    px.c[ch][i] = rgba[i * 4 + ch];
+            }
+        }
+
+        float clamp255(float v) {
+            return std::min(255.0f, std::max(0.0f, v));
+        }
+
+        // For every pixel, the nearest of `steps` evenly spaced positions
+        // between e0 (0) and e1 (steps - 1), over the first `channels` channels
+        void selectIndices(const block_pixels& px, const float e0[4], const float e1[4], int channels, int steps, int idx[16]) {
+            float axis[4] = {};
+            float len2 = 0.0f;
+            for (int ch = 0; ch < channels; ch++) {
+                axis[ch] = e1[ch] - e0[ch];
+                len2 += axis[ch] * axis[ch];
+            }
+            if (len2 < 1e-6f) {
+                std::fill(idx, idx + 16, 0);
+                return;
+            }
+            const float scale = (steps - 1) / len2;
+            for (int ch = 0; ch < channels; ch++)
+                axis[ch] *= scale;
+
+#ifdef BLOCK_SSE
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 last = _mm_set1_ps(static_cast<float>(steps - 1));
+            for (int i = 0; i < 16; i += 4) {
+                __m128 t = zero;
+                for (int ch = 0; ch < channels; ch++) {
+                    __m128 d = _mm_sub_ps(_mm_load_ps(px.c[ch] + i), _mm_set1_ps(e0[ch]));
+                    t = _mm_add_ps(t, _mm_mul_ps(d, _mm_set1_ps(axis[ch])));
+                }
+                t = _mm_min_ps(_mm_max_ps(t, zero), last);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(idx + i), _mm_cvtps_epi32(t));
+            }
+#else
+            for (int i = 0; i < 16; i++) {
+                float t = 0.0f;
+                for (int ch = 0; ch < channels; ch++)
+                    t += (px.c[ch][i] - e0[ch]) * axis[ch];
+                idx[i] = static_cast<int>(std::lround(std::min<float>(steps - 1, std::max(0.0f, t))));
+            }
+#endif
+        }
+
+        // Endpoints spanning the block along its principal axis, pulled in
+        // slightly since the extremes are rarely worth hitting exactly
+        endpoints fitEndpoints(const block_pixels& px, int channels) {
+            float mean[4] = {};
+            for (int ch = 0; ch < channels; ch++) {
+                for (int i = 0; i < 16; i++)
+                    mean[ch] += px.c[ch][i];
+                mean[ch] /= 16.0f;
+            }
+
+            float cov[4][4] = {};
+            for (int i = 0; i < 16; i++) {
+                float d[4];
+                for (int ch = 0; ch < channels; ch++)
+                    d[ch] = px.c[ch][i] - mean[ch];
+                for (int a = 0; a < channels; a++) {
+                    for (int b = 0; b < channels; b++)
+                        cov[a][b] += d[a] * d[b];
+                }
+            }
+
+            // Power iteration from the row of the widest channel
+            int widest = 0;
+            for (int ch = 1; ch < channels; ch++) {
+                if (cov[ch][ch] > cov[widest][widest])
+                    widest = ch;
+            }
+            float axis[4] = {};
+            for (int ch = 0; ch < channels; ch++)
+                axis[ch] = cov[widest][ch];
+            for (int iter = 0; iter < 8; iter++) {
+                float next[4] = {};
+                float norm = 0.0f;
+                for (int a = 0; a < channels; a++) {
+                    for (int b = 0; b < channels; b++)
+                        next[a] += cov[a][b] * axis[b];
+                    norm += next[a] * next[a];
+                }
+                if (norm < 1e-12f)
+                    break;
+                norm = 1.0f / std::sqrt(norm);
+                for (int ch = 0; ch < channels; ch++)
+                    axis[ch] = next[ch] * norm;
+            }
+
+            float tmin = 0.0f, tmax = 0.0f;
+            for (int i = 0; i < 16; i++) {
+                float t = 0.0f;
+                for (int ch = 0; ch < channels; ch++)
+                    t += (px.c[ch][i] - mean[ch]) * axis[ch];
+                tmin = std::min(tmin, t);
+                tmax = std::max(tmax, t);
+            }
+            const float inset = (tmax - tmin) / 32.0f;
+            tmin += inset;
+            tmax -= inset;
+
+            endpoints e{};
+            for (int ch = 0; ch < 4; ch++) {
+                e.e[0][ch] = ch < channels ? clamp255(mean[ch] + axis[ch] * tmin) : 255.0f;
+                e.e[1][ch] = ch < channels ? clamp255(mean[ch] + axis[ch] * tmax) : 255.0f;
+            }
+            return e;
+        }
+
+        // Least-squares endpoints for fixed indices, index k weighing
+        // k / (steps - 1) towards e1. False when the indices don't pin
+        // down two endpoints.
+        bool refit(const block_pixels& px, const int idx[16], int steps, int channels, endpoints& out) {
+            float aa = 0.0f, bb = 0.0f, ab = 0.0f;
+            float ax[4] = {}, bx[4] = {};
+            for (int i = 0; i < 16; i++) {
+                const float w = static_cast<float>(idx[i]) / (steps - 1);
+                const float v = 1.0f - w;
+                aa += v * v;
+                bb += w * w;
+                ab += v * w;
+                for (int ch = 0; ch < channels; ch++) {
+                    ax[ch] += v * px.c[ch][i];
+                    bx[ch] += w * px.c[ch][i];
+                }
+            }
+
+            const float det = aa * bb - ab * ab;
+            if (std::fabs(det) < 1e-6f)
+                return false;
+            for (int ch = 0; ch < 4; ch++) {
+                out.e[0][ch] = ch < channels ? clamp255((ax[ch] * bb - bx[ch] * ab) / det) : 255.0f;
+                out.e[1][ch] = ch < channels ? clamp255((bx[ch] * aa - ax[ch] * ab) / det) : 255.0f;
+            }
+            return true;
+        }
+
+        float blockError(const block_pixels& px, const float palette[][4], const int idx[16], int channels) {
+            float error = 0.0f;
+            for (int i = 0; i < 16; i++) {
+                for (int ch = 0; ch < channels; ch++) {
+                    float d = px.c[ch][i] - palette[idx[i]][ch];
+                    error += d * d;
+                }
+            }
+            return error;
+        }
+
+        // Little-endian bit stream over one 16-byte block
+        struct bit_writer {
+            unsigned char* bytes;
+            int pos = 0;
+
+            void write(std::uint32_t value, int bits) {
+                for (int b = 0; b < bits; b++, pos++) {
+                    if ((value >> b) & 1)
+                        bytes[pos >> 3] |= static_cast<unsigned char>(1 << (pos & 7));
+                }
+            }
+        };
+
+        struct bit_reader {
+            const unsigned char* bytes;
+            int pos = 0;
+
+            std::uint32_t read(int bits) {
+                std::uint32_t value = 0;
+                for (int b = 0; b < bits; b++, pos++)
+                    value |= static_cast<std::uint32_t>((bytes[pos >> 3] >> (pos & 7)) & 1) << b;
+                return value;
+            }
+        };
+
+        // ---------------------------
+        // BC1 colour
+        // ---------------------------
+        std::uint16_t pack565(const float c[4]) {
+            int r = static_cast<int>(std::lround(c[0] * 31.0f / 255.0f));
+            int g = static_cast<int>(std::lround(c[1] * 63.0f / 255.0f));
+            int b = static_cast<int>(std::lround(c[2] * 31.0f / 255.0f));
+            return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+        }
+
+        void unpack565(std::uint16_t v, int c[3]) {
+            int r = v >> 11, g = (v >> 5) & 63, b = v & 31;
+            c[0] = (r << 3) | (r >> 2);
+            c[1] = (g << 2) | (g >> 4);
+            c[2] = (b << 3) | (b >> 2);
+        }
+
+        // Four-colour palette in position order: c0, 2/3 c0 + 1/3 c1, ..., c1
+        void colorPalette(std::uint16_t c0, std::uint16_t c1, float palette[4][4]) {
+            int a[3], b[3];
+            unpack565(c0, a);
+            unpack565(c1, b);
+            for (int ch = 0; ch < 3; ch++) {
+                palette[0][ch] = static_cast<float>(a[ch]);
+                palette[1][ch] = static_cast<float>((2 * a[ch] + b[ch]) / 3);
+                palette[2][ch] = static_cast<float>((a[ch] + 2 * b[ch]) / 3);
+                palette[3][ch] = static_cast<float>(b[ch]);
+            }
+        }
+
+        struct color_fit {
+            std::uint16_t c0, c1;
+            int idx[16];
+            float error;
+        };
+
+        color_fit quantizeColor(const block_pixels& px, const endpoints& e) {
+            color_fit fit;
+            fit.c0 = pack565(e.e[0]);
+            fit.c1 = pack565(e.e[1]);
+
+            float palette[4][4] = {};
+            colorPalette(fit.c0, fit.c1, palette);
+            selectIndices(px, palette[0], palette[3], 3, 4, fit.idx);
+            fit.error = blockError(px, palette, fit.idx, 3);
+            return fit;
+        }
+
+        void encodeColor(const block_pixels& px, unsigned char out[8]) {
+            color_fit best = quantizeColor(px, fitEndpoints(px, 3));
+            endpoints refined;
+            if (refit(px, best.idx, 4, 3, refined)) {
+                color_fit fit = quantizeColor(px, refined);
+                if (fit.error < best.error)
+                    best = fit;
+            }
+
+            // c0 > c1 selects the four-colour mode
+            if (best.c0 < best.c1) {
+                std::swap(best.c0, best.c1);
+                for (int& k : best.idx)
+                    k = 3 - k;
+            }
+            std::uint32_t bits = 0;
+            if (best.c0 != best.c1) {
+                static const std::uint32_t code[4] = { 0, 2, 3, 1 };
+                for (int i = 0; i < 16; i++)
+                    bits |= code[best.idx[i]] << (2 * i);
+            }
+
+            out[0] = static_cast<unsigned char>(best.c0);
+            out[1] = static_cast<unsigned char>(best.c0 >> 8);
+            out[2] = static_cast<unsigned char>(best.c1);
+            out[3] = static_cast<unsigned char>(best.c1 >> 8);
+            for (int i = 0; i < 4; i++)
+                out[4 + i] = static_cast<unsigned char>(bits >> (8 * i));
+        }
+
+        void decodeColor(const unsigned char in[8], bool fourColorOnly, unsigned char rgba[64]) {
+            const std::uint16_t c0 = static_cast<std::uint16_t>(in[0] | (in[1] << 8));
+            const std::uint16_t c1 = static_cast<std::uint16_t>(in[2] | (in[3] << 8));
+            int a[3], b[3];
+            unpack565(c0, a);
+            unpack565(c1, b);
+
+            int palette[4][4];
+            for (int ch = 0; ch < 3; ch++) {
+                palette[0][ch] = a[ch];
+                palette[1][ch] = b[ch];
+                if (c0 > c1 || fourColorOnly) {
+                    palette[2][ch] = (2 * a[ch] + b[ch]) / 3;
+                    palette[3][ch] = (a[ch] + 2 * b[ch]) / 3;
+                }
+                else {
+                    palette[2][ch] = (a[ch] + b[ch]) / 2;
+                    palette[3][ch] = 0;
+                }
+            }
+            palette[0][3] = palette[1][3] = palette[2][3] = 255;
+            palette[3][3] = (c0 > c1 || fourColorOnly) ? 255 : 0;
+
+            const std::uint32_t bits = in[4] | (in[5] << 8) | (in[6] << 16) | (static_cast<std::uint32_t>(in[7]) << 24);
+            for (int i = 0; i < 16; i++) {
+                const int* p = palette[(bits >> (2 * i)) & 3];
+                for (int ch = 0; ch < 4; ch++)
+                    rgba[i * 4 + ch] = static_cast<unsigned char>(p[ch]);
+            }
+        }
+
+        // ---------------------------
+        // BC3 alpha
+        // ---------------------------
+        void encodeAlpha(const block_pixels& px, unsigned char out[8]) {
+            float lo = 255.0f, hi = 0.0f;
+            for (int i = 0; i < 16; i++) {
+                lo = std::min(lo, px.c[3][i]);
+                hi = std::max(hi, px.c[3][i]);
+            }
+            const int a0 = static_cast<int>(std::lround(hi));
+            const int a1 = static_cast<int>(std::lround(lo));
+
+            // a0 > a1: six values between the two, position k from a0
+            std::uint64_t bits = 0;
+            if (a0 > a1) {
+                const float scale = 7.0f / (a0 - a1);
+                for (int i = 0; i < 16; i++) {
+                    int k = static_cast<int>(std::lround((a0 - px.c[3][i]) * scale));
+                    k = std::min(7, std::max(0, k));
+                    const std::uint64_t code = k == 0 ? 0 : k == 7 ? 1 : k + 1;
+                    bits |= code << (3 * i);
+                }
+            }
+
+            out[0] = static_cast<unsigned char>(a0);
+            out[1] = static_cast<unsigned char>(a1);
+            for (int i = 0; i < 6; i++)
+                out[2 + i] = static_cast<unsigned char>(bits >> (8 * i));
+        }
+
+        void decodeAlpha(const unsigned char in[8], unsigned char rgba[64]) {
+            const int a0 = in[0], a1 = in[1];
+            int palette[8] = { a0, a1 };
+            if (a0 > a1) {
+                for (int j = 2; j < 8; j++)
+                    palette[j] = ((8 - j) * a0 + (j - 1) * a1) / 7;
+            }
+            else {
+                for (int j = 2; j < 6; j++)
+                    palette[j] = ((6 - j) * a0 + (j - 1) * a1) / 5;
+                palette[6] = 0;
+                palette[7] = 255;
+            }
+
+            std::uint64_t bits = 0;
+            for (int i = 0; i < 6; i++)
+                bits |= static_cast<std::uint64_t>(in[2 + i]) << (8 * i);
+            for (int i = 0; i < 16; i++)
+                rgba[i * 4 + 3] = static_cast<unsigned char>(palette[(bits >> (3 * i)) & 7]);
+        }
+
+        // ---------------------------
+        // BC7 mode 6
+        // ---------------------------
+        const int bc7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        int bc7Interpolate(int e0, int e1, int k) {
+            return ((64 - bc7Weights[k]) * e0 + bc7Weights[k] * e1 + 32) >> 6;
+        }
+
+        struct bc7_fit {
+            int q[2][4]; // 7-bit endpoints
+            int p[2];    // p-bits
+            int idx[16];
+            float error;
+        };
+
+        // 7 bits per channel plus a shared p-bit, whichever p-bit lands closer
+        void quantizeBC7Endpoint(const float e[4], int q[4], int& p) {
+            float bestError = 1e30f;
+            for (int pbit = 0; pbit < 2; pbit++) {
+                int candidate[4];
+                float error = 0.0f;
+                for (int ch = 0; ch < 4; ch++) {
+                    candidate[ch] = std::min(127, std::max(0, static_cast<int>(std::lround((e[ch] - pbit) / 2.0f))));
+                    float d = static_cast<float>(candidate[ch] * 2 + pbit) - e[ch];
+                    error += d * d;
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    std::memcpy(q, candidate, sizeof(candidate));
+                    p = pbit;
+                }
+            }
+        }
+
+        bc7_fit quantizeBC7(const block_pixels& px, const endpoints& e) {
+            bc7_fit fit;
+            quantizeBC7Endpoint(e.e[0], fit.q[0], fit.p[0]);
+            quantizeBC7Endpoint(e.e[1], fit.q[1], fit.p[1]);
+
+            int v[2][4];
+            float vf[2][4];
+            for (int end = 0; end < 2; end++) {
+                for (int ch = 0; ch < 4; ch++) {
+                    v[end][ch] = fit.q[end][ch] * 2 + fit.p[end];
+                    vf[end][ch] = static_cast<float>(v[end][ch]);
+                }
+            }
+            selectIndices(px, vf[0], vf[1], 4, 16, fit.idx);
+
+            float palette[16][4];
+            for (int k = 0; k < 16; k++) {
+                for (int ch = 0; ch < 4; ch++)
+                    palette[k][ch] = static_cast<float>(bc7Interpolate(v[0][ch], v[1][ch], k));
+            }
+            fit.error = blockError(px, palette, fit.idx, 4);
+            return fit;
+        }
+
+        void encodeBC7(const block_pixels& px, unsigned char out[16]) {
+            bc7_fit best = quantizeBC7(px, fitEndpoints(px, 4));
+            endpoints refined;
+            if (refit(px, best.idx, 16, 4, refined)) {
+                bc7_fit fit = quantizeBC7(px, refined);
+                if (fit.error < best.error)
+                    best = fit;
+            }
+
+            // The first index is stored without its top bit, so it must be < 8;
+            // the weights are symmetric, so swapping the ends is lossless
+            if (best.idx[0] >= 8) {
+                std::swap(best.q[0], best.q[1]);
+                std::swap(best.p[0], best.p[1]);
+                for (int& k : best.idx)
+                    k = 15 - k;
+            }
+
+            std::memset(out, 0, 16);
+            bit_writer bits{ out };
+            bits.write(1u << 6, 7); // mode 6
+            for (int ch = 0; ch < 4; ch++) {
+                bits.write(best.q[0][ch], 7);
+                bits.write(best.q[1][ch], 7);
+            }
+            bits.write(best.p[0], 1);
+            bits.write(best.p[1], 1);
+            bits.write(best.idx[0], 3);
+            for (int i = 1; i < 16; i++)
+                bits.write(best.idx[i], 4);
+        }
+
+        void decodeBC7(const unsigned char in[16], unsigned char rgba[64]) {
+            if ((in[0] & 0x7F) != 0x40) { // anything but mode 6
+                for (int i = 0; i < 16; i++) {
+                    rgba[i * 4 + 0] = 255;
+                    rgba[i * 4 + 1] = 0;
+                    rgba[i * 4 + 2] = 255;
+                    rgba[i * 4 + 3] = 255;
+                }
+                return;
+            }
+
+            bit_reader bits{ in, 7 };
+            int q[2][4];
+            for (int ch = 0; ch < 4; ch++) {
+                q[0][ch] = static_cast<int>(bits.read(7));
+                q[1][ch] = static_cast<int>(bits.read(7));
+            }
+            const int p0 = static_cast<int>(bits.read(1));
+            const int p1 = static_cast<int>(bits.read(1));
+            for (int i = 0; i < 16; i++) {
+                const int k = static_cast<int>(bits.read(i == 0 ? 3 : 4));
+                for (int ch = 0; ch < 4; ch++)
+                    rgba[i * 4 + ch] = static_cast<unsigned char>(bc7Interpolate(q[0][ch] * 2 + p0, q[1][ch] * 2 + p1, k));
+            }
+        }
+    }
+
+    const char* BlockCompressor::name(block_format format) {
+        switch (format) {
+        case block_format::bc1: return "bc1";
+        case block_format::bc3: return "bc3";
+        case block_format::bc7: return "bc7";
+        }
+        return "?";
+    }
+
+    bool BlockCompressor::parse(const std::string& name, block_format& format) {
+        for (block_format f : { block_format::bc1, block_format::bc3, block_format::bc7 }) {
+            if (name == BlockCompressor::name(f)) {
+                format = f;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    GLenum BlockCompressor::glFormat(block_format format) {
+        switch (format) {
+        case block_format::bc1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case block_format::bc3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case block_format::bc7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        }
+        return 0;
+    }
+
+    bool BlockCompressor::fromGlFormat(GLenum glFormat, block_format& format) {
+        switch (glFormat) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT: format = block_format::bc1; return true;
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT: format = block_format::bc3; return true;
+        case GL_COMPRESSED_RGBA_BPTC_UNORM:    format = block_format::bc7; return true;
+        }
+        return false;
+    }
+
+    std::size_t BlockCompressor::blockBytes(block_format format) {
+        return format == block_format::bc1 ? 8 : 16;
+    }
+
+    std::size_t BlockCompressor::compressedSize(block_format format, int width, int height) {
+        const std::size_t bw = std::max(1, (width + 3) / 4);
+        const std::size_t bh = std::max(1, (height + 3) / 4);
+        return bw * bh * blockBytes(format);
+    }
+
+    void BlockCompressor::encodeBlock(block_format format, const unsigned char rgba[64], unsigned char* out) {
+        block_pixels px;
+        loadBlock(rgba, px);
+        switch (format) {
+        case block_format::bc1:
+            encodeColor(px, out);
+            break;
+        case block_format::bc3:
+            encodeAlpha(px, out);
+            encodeColor(px, out + 8);
+            break;
+        case block_format::bc7:
+            encodeBC7(px, out);
+            break;
+        }
+    }
+
+    void BlockCompressor::decodeBlock(block_format format, const unsigned char* in, unsigned char rgba[64]) {
+        switch (format) {
+        case block_format::bc1:
+            decodeColor(in, false, rgba);
+            break;
+        case block_format::bc3:
+            decodeColor(in + 8, true, rgba);
+            decodeAlpha(in, rgba);
+            break;
+        case block_format::bc7:
+            decodeBC7(in, rgba);
+            break;
+        }
+    }
+
+    std::vector<unsigned char> BlockCompressor::compress(block_format format, const unsigned char* rgba,
+        int width, int height, ThreadPool& pool) {
+        if (!rgba || width <= 0 || height <= 0)
+            return {};
+
+        const int bw = (width + 3) / 4;
+        const int bh = (height + 3) / 4;
+        const std::size_t bytes = blockBytes(format);
+        std::vector<unsigned char> out(compressedSize(format, width, height));
+
+        pool.parallelFor(bh, [&](std::size_t by) {
+            unsigned char block[64];
+            for (int bx = 0; bx < bw; bx++) {
+                for (int y = 0; y < 4; y++) {
+                    const int sy = std::min(static_cast<int>(by) * 4 + y, height - 1);
+                    for (int x = 0; x < 4; x++) {
+                        const int sx = std::min(bx * 4 + x, width - 1);
+                        std::memcpy(block + (y * 4 + x) * 4, rgba + (static_cast<std::size_t>(sy) * width + sx) * 4, 4);
+                    }
+                }
+                encodeBlock(format, block, out.data() + (by * bw + bx) * bytes);
+            }
+        });
+        return out;
+    }
+
+    std::vector<unsigned char> BlockCompressor::decompress(block_format format, const unsigned char* blocks,
+        int width, int height) {
+        if (!blocks || width <= 0 || height <= 0)
+            return {};
+
+        const int bw = (width + 3) / 4;
+        const int bh = (height + 3) / 4;
+        const std::size_t bytes = blockBytes(format);
+        std::vector<unsigned char> rgba(static_cast<std::size_t>(width) * height * 4);
+
+        unsigned char block[64];
+        for (int by = 0; by < bh; by++) {
+            for (int bx = 0; bx < bw; bx++) {
+                decodeBlock(format, blocks + (static_cast<std::size_t>(by) * bw + bx) * bytes, block);
+                for (int y = 0; y < 4 && by * 4 + y < height; y++) {
+                    for (int x = 0; x < 4 && bx * 4 + x < width; x++)
+                        std::memcpy(rgba.data() + (static_cast<std::size_t>(by * 4 + y) * width + bx * 4 + x) * 4, block + (y * 4 + x) * 4, 4);
+                }
+            }
+        }
+        return rgba;
+    }
+
+    bool BlockCompressor::canDecompress(block_format format, const unsigned char* blocks, int width, int height) {
+        if (format != block_format::bc7)
+            return true;
+        const std::size_t count = static_cast<std::size_t>((width + 3) / 4) * ((height + 3) / 4);
+        for (std::size_t i = 0; i < count; i++) {
+            if ((blocks[i * 16] & 0x7F) != 0x40)
+                return false;
+        }
+        return true;
+    }
+
+}
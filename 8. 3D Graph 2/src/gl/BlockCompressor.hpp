@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+
+#include "ThreadPool.hpp"
+
+// S3TC is an extension everywhere, so the core loader does not define it
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT  0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT 0x83F2
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+namespace gl {
+
+    // GPU block formats, each coding 4x4 pixels
+    enum class block_format {
+        bc1, // RGB, 8 bytes per block (4 bpp); alpha is dropped
+        bc3, // BC1 colour + interpolated alpha, 16 bytes (8 bpp)
+        bc7, // RGBA, 16 bytes (8 bpp), better colour than BC1/BC3
+    };
+
+    /**
+     * @brief CPU encoder for BC1, BC3 and BC7 textures.
+     *
+     * Every block fits its endpoints along the principal axis of its
+     * colours, picks indices by projecting onto the quantized endpoints
+     * (four pixels per SSE op) and refits the endpoints once by least
+     * squares, keeping whichever pass has the lower error. BC7 only uses
+     * mode 6 (one subset, RGBA endpoints, 4-bit indices): no partition
+     * search, but a large step up from BC1 on gradients.
+     *
+     * Quality is that of a fast offline encoder, not a reference one.
+     */
+    class BlockCompressor {
+    public:
+        static const char* name(block_format format);
+        static bool parse(const std::string& name, block_format& format);
+
+        // Internal format for glCompressedTexImage2D
+        static GLenum glFormat(block_format format);
+        static bool fromGlFormat(GLenum glFormat, block_format& format);
+
+        static std::size_t blockBytes(block_format format);
+        static std::size_t compressedSize(block_format format, int width, int height);
+
+        // Tightly packed RGBA8 in, blocks row by row out. Edge blocks repeat
+        // the last row/column. Block rows are spread over `pool`.
+        static std::vector<unsigned char> compress(block_format format, const unsigned char* rgba,
+            int width, int height, ThreadPool& pool = ThreadPool::shared());
+
+        // Inverse of compress(), for measuring the error. BC7 blocks in a
+        // mode other than 6 decode to magenta.
+        static std::vector<unsigned char> decompress(block_format format, const unsigned char* blocks,
+            int width, int height);
+        // False when decompress() would not read every block faithfully,
+        // i.e. BC7 from an encoder using modes other than 6
+        static bool canDecompress(block_format format, const unsigned char* blocks, int width, int height);
+
+        // One 4x4 block of RGBA8, row-major
+        static void encodeBlock(block_format format, const unsigned char rgba[64], unsigned char* out);
+        static void decodeBlock(block_format format, const unsigned char* in, unsigned char rgba[64]);
+    };
+
+}
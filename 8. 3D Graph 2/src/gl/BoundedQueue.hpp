@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace gl {
+
+    /**
+     * @brief Fixed-capacity lock-free queue, safe for any number of
+     * producers and consumers (Vyukov's bounded MPMC ring).
+     *
+     * Every cell carries a sequence number saying whose turn it is; a
+     * push or pop claims a position with one compare-exchange and never
+     * blocks. tryPush fails when the queue is full, tryPop when empty.
+     */
+    template<typename T>
+    class BoundedQueue {
+    public:
+        // Rounded up to a power of two
+        explicit BoundedQueue(std::size_t capacity = 256) {
+            std::size_t size = 2;
+            while (size < capacity)
+                size *= 2;
+            m_mask = size - 1;
+            m_cells = std::make_unique<Cell[]>(size);
+            for (std::size_t i = 0; i < size; i++)
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        bool tryPush(T value) {
+            std::size_t pos = m_tail.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell& cell = m_cells[pos & m_mask];
+                std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+                std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+                if (diff == 0) {
+                    if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        cell.value = std::move(value);
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0) {
+                    return false; // full
+                }
+                else {
+                    pos = m_tail.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool tryPop(T& out) {
+            std::size_t pos = m_head.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell& cell = m_cells[pos & m_mask];
+                std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+                std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+                if (diff == 0) {
+                    if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        out = std::move(cell.value);
+                        cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0) {
+                    return false; // empty
+                }
+                else {
+                    pos = m_head.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        std::size_t capacity() const { return m_mask + 1; }
+
+    private:
+        struct Cell {
+            std::atomic<std::size_t> sequence;
+            T value{};
+        };
+
+        std::unique_ptr<Cell[]> m_cells;
+        std::size_t m_mask = 0;
+
+        // Producers and consumers each get their own cache line
+        alignas(64) std::atomic<std::size_t> m_tail{ 0 };
+        alignas(64) std::atomic<std::size_t> m_head{ 0 };
+    };
+
+}
@@ -0,0 +1,423 @@
+#include "Bvh.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace gl {
+
+    namespace {
+        const std::uint32_t LeafSize = 4;
+        const int Bins = 16;
+
+        struct bin {
+            aabb box;
+            std::uint32_t count = 0;
+        };
+
+        // false if the box is outside; clears the bits of planes it is fully inside
+        bool classify(const Frustum& frustum, const float* mn, const float* mx, unsigned& mask) {
+            for (unsigned p = 0; p < 6; p++) {
+                if (!(mask & (1u << p)))
+                    continue;
+                const glm::vec4& pl = frustum.plane(p);
+                float dFar = pl.w + pl.x * (pl.x >= 0 ? mx[0] : mn[0])
+                    + pl.y * (pl.y >= 0 ? mx[1] : mn[1]) + pl.z * (pl.z >= 0 ? mx[2] : mn[2]);
+                if (dFar < 0.0f)
+                    return false;
+                float dNear = pl.w + pl.x * (pl.x >= 0 ? mn[0] : mx[0])
+                    + pl.y * (pl.y >= 0 ? mn[1] : mx[1]) + pl.z * (pl.z >= 0 ? mn[2] : mx[2]);
+                if (dNear >= 0.0f)
+                    mask &= ~(1u << p);
+            }
+            return true;
+        }
+
+        // Entry distance of the ray into the box, if it gets there before tMax
+        bool slab(const float* mn, const float* mx, const glm::vec3& origin, const glm::vec3& inv,
+            float tMax, float& tEnter) {
+            float t0 = 0.0f, t1 = tMax;
+            for (int a = 0; a < 3; a++) {
+                float n = (mn[a] - origin[a]) * inv[a];
+                float f = (mx[a] - origin[a]) * inv[a];
+                if (n > f)
+                    std::swap(n, f);
+                t0 = n > t0 ? n : t0; // NaN (ray in the slab plane) keeps the old bound
+                t1 = f < t1 ? f : t1;
+            }
+            tEnter = t0;
+            return t0 <= t1;
+        }
+    }
+
+    // ---------------------------
+    // Build
+    // ---------------------------
+    void Bvh::build(const std::vector<aabb>& boxes) {
+        const std::uint32_t n = static_cast<std::uint32_t>(boxes.size());
+        m_nodes.clear();
+        m_parentRef.clear();
+        m_first.clear();
+        m_count.clear();
+        m_objects.resize(n);
+        std::iota(m_objects.begin(), m_objects.end(), 0u);
+        m_leafRef.assign(n, invalid);
+        m_root = aabb();
+        if (n == 0) {
+            m_boxes.clear();
+            m_positionOf.clear();
+            return;
+        }
+
+        m_nodes.reserve(2 * n / LeafSize + 1);
+        m_parentRef.reserve(m_nodes.capacity());
+        std::vector<glm::vec3> centroids(n);
+        for (std::uint32_t i = 0; i < n; i++)
+            centroids[i] = boxes[i].center();
+
+        if (n <= LeafSize) {
+            // A single leaf still needs a node to live in
+            m_nodes.push_back(Node{});
+            m_parentRef.push_back(invalid);
+            m_first.push_back(0);
+            m_count.push_back(n);
+            Node& root = m_nodes[0];
+            root.child[0] = 0;
+            root.count[0] = n;
+            root.child[1] = invalid;
+            root.count[1] = 0;
+            for (std::uint32_t i = 0; i < n; i++)
+                m_leafRef[i] = 0;
+        }
+        else {
+            buildNode(0, n, invalid, boxes, centroids);
+        }
+
+        // Boxes in leaf order, so leaves read them contiguously
+        m_boxes.resize(n);
+        m_positionOf.resize(n);
+        for (std::uint32_t i = 0; i < n; i++) {
+            m_boxes[i] = boxes[m_objects[i]];
+            m_positionOf[m_objects[i]] = i;
+        }
+        if (n <= LeafSize) {
+            setSlot(0, leafBox(0, n));
+            setSlot(1, aabb());
+        }
+
+        m_root = slotBox(0, 0);
+        m_root.grow(slotBox(0, 1));
+    }
+
+    std::uint32_t Bvh::buildNode(std::uint32_t first, std::uint32_t count, std::uint32_t parentRef,
+        const std::vector<aabb>& boxes, const std::vector<glm::vec3>& centroids) {
+        // Binned SAH over the axis-wise centroid bounds
+        aabb centroidBox;
+        for (std::uint32_t i = first; i < first + count; i++)
+            centroidBox.grow(centroids[m_objects[i]]);
+
+        int bestAxis = -1;
+        int bestSplit = 0;
+        float bestCost = 1e30f;
+        for (int axis = 0; axis < 3; axis++) {
+            float lo = centroidBox.min[axis];
+            float extent = centroidBox.max[axis] - lo;
+            if (extent <= 0.0f)
+                continue;
+
+            bin bins[Bins];
+            float scale = Bins / extent;
+            for (std::uint32_t i = first; i < first + count; i++) {
+                std::uint32_t o = m_objects[i];
+                int b = std::min(Bins - 1, static_cast<int>((centroids[o][axis] - lo) * scale));
+                bins[b].count++;
+                bins[b].box.grow(boxes[o]);
+            }
+
+            // Right-to-left sweep, then left-to-right with the cost of each split
+            float rightArea[Bins];
+            std::uint32_t rightCount[Bins];
+            aabb acc;
+            std::uint32_t n = 0;
+            for (int b = Bins - 1; b > 0; b--) {
+                acc.grow(bins[b].box);
+                n += bins[b].count;
+                rightArea[b] = acc.area();
+                rightCount[b] = n;
+            }
+            acc = aabb();
+            n = 0;
+            for (int b = 0; b < Bins - 1; b++) {
+                acc.grow(bins[b].box);
+                n += bins[b].count;
+                if (n == 0 || rightCount[b + 1] == 0)
+                    continue;
+                float cost = acc.area() * n + rightArea[b + 1] * rightCount[b + 1];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = b + 1;
+                }
+            }
+        }
+
+        std::uint32_t leftCount;
+        if (bestAxis >= 0) {
+            float lo = centroidBox.min[bestAxis];
+            float scale = Bins / (centroidBox.max[bestAxis] - lo);
+            auto mid = std::partition(m_objects.begin() + first, m_objects.begin() + first + count,
+                [&](std::uint32_t o) {
+                    int b = std::min(Bins - 1, static_cast<int>((centroids[o][bestAxis] - lo) * scale));
+                    return b < bestSplit;
+                });
+            leftCount = static_cast<std::uint32_t>(mid - (m_objects.begin() + first));
+        }
+        else {
+            // Every centroid in one spot: any split is as good as another
+            leftCount = count / 2;
+        }
+
+        const std::uint32_t node = static_cast<std::uint32_t>(m_nodes.size());
+        m_nodes.push_back(Node{});
+        m_parentRef.push_back(parentRef);
+        m_first.push_back(first);
+        m_count.push_back(count);
+
+        const std::uint32_t ranges[2][2] = { { first, leftCount }, { first + leftCount, count - leftCount } };
+        for (int slot = 0; slot < 2; slot++) {
+            std::uint32_t f = ranges[slot][0], c = ranges[slot][1];
+            std::uint32_t ref = node * 2 + slot;
+            aabb box;
+            for (std::uint32_t i = f; i < f + c; i++)
+                box.grow(boxes[m_objects[i]]);
+            setSlot(ref, box);
+            if (c <= LeafSize) {
+                m_nodes[node].child[slot] = f;
+                m_nodes[node].count[slot] = c;
+                for (std::uint32_t i = f; i < f + c; i++)
+                    m_leafRef[m_objects[i]] = ref;
+            }
+            else {
+                std::uint32_t child = buildNode(f, c, ref, boxes, centroids);
+                m_nodes[node].child[slot] = child;
+                m_nodes[node].count[slot] = 0;
+            }
+        }
+        return node;
+    }
+
+    aabb Bvh::leafBox(std::uint32_t first, std::uint32_t count) const {
+        aabb box;
+        for (std::uint32_t i = first; i < first + count; i++)
+            box.grow(m_boxes[i]);
+        return box;
+    }
+
+    void Bvh::setSlot(std::uint32_t ref, const aabb& box) {
+        Node& n = m_nodes[ref >> 1];
+        int slot = ref & 1;
+        for (int a = 0; a < 3; a++) {
+            n.min[slot][a] = box.min[a];
+            n.max[slot][a] = box.max[a];
+        }
+    }
+
+    aabb Bvh::slotBox(std::uint32_t node, int slot) const {
+        const Node& n = m_nodes[node];
+        aabb box;
+        if (n.count[slot] == 0 && n.child[slot] == invalid)
+            return box;
+        box.min = glm::vec3(n.min[slot][0], n.min[slot][1], n.min[slot][2]);
+        box.max = glm::vec3(n.max[slot][0], n.max[slot][1], n.max[slot][2]);
+        return box;
+    }
+
+    // ---------------------------
+    // Refit
+    // ---------------------------
+    void Bvh::refit(const std::vector<aabb>& boxes) {
+        if (boxes.size() != m_objects.size() || m_nodes.empty())
+            return;
+        for (std::size_t i = 0; i < m_objects.size(); i++)
+            m_boxes[i] = boxes[m_objects[i]];
+
+        // Children always come after their parent
+        for (std::size_t i = m_nodes.size(); i > 0; i--) {
+            const std::uint32_t node = static_cast<std::uint32_t>(i - 1);
+            for (int slot = 0; slot < 2; slot++) {
+                const Node& n = m_nodes[node];
+                if (n.count[slot] > 0) {
+                    setSlot(node * 2 + slot, leafBox(n.child[slot], n.count[slot]));
+                }
+                else if (n.child[slot] != invalid) {
+                    aabb box = slotBox(n.child[slot], 0);
+                    box.grow(slotBox(n.child[slot], 1));
+                    setSlot(node * 2 + slot, box);
+                }
+            }
+        }
+        m_root = slotBox(0, 0);
+        m_root.grow(slotBox(0, 1));
+    }
+
+    void Bvh::refit(std::uint32_t object, const aabb& box) {
+        if (object >= m_positionOf.size())
+            return;
+        m_boxes[m_positionOf[object]] = box;
+
+        std::uint32_t ref = m_leafRef[object];
+        const Node& leaf = m_nodes[ref >> 1];
+        setSlot(ref, leafBox(leaf.child[ref & 1], leaf.count[ref & 1]));
+
+        for (std::uint32_t node = ref >> 1; m_parentRef[node] != invalid; node = m_parentRef[node] >> 1) {
+            aabb merged = slotBox(node, 0);
+            merged.grow(slotBox(node, 1));
+            setSlot(m_parentRef[node], merged);
+        }
+        m_root = slotBox(0, 0);
+        m_root.grow(slotBox(0, 1));
+    }
+
+    // ---------------------------
+    // Queries
+    // ---------------------------
+    void Bvh::cull(const Frustum& frustum, std::vector<std::uint32_t>& visible) const {
+        visible.clear();
+        if (m_nodes.empty())
+            return;
+
+        struct entry { std::uint32_t node; unsigned mask; };
+        std::vector<entry> stack;
+        stack.reserve(64);
+        stack.push_back({ 0, 0x3Fu });
+
+        while (!stack.empty()) {
+            entry e = stack.back();
+            stack.pop_back();
+            const Node& n = m_nodes[e.node];
+            for (int slot = 0; slot < 2; slot++) {
+                if (n.count[slot] == 0 && n.child[slot] == invalid)
+                    continue;
+                unsigned mask = e.mask;
+                if (mask && !classify(frustum, n.min[slot], n.max[slot], mask))
+                    continue;
+
+                if (n.count[slot] == 0) {
+                    if (mask == 0) {
+                        // Fully inside: the whole subtree is one run of objects
+                        auto begin = m_objects.begin() + m_first[n.child[slot]];
+                        visible.insert(visible.end(), begin, begin + m_count[n.child[slot]]);
+                    }
+                    else {
+                        stack.push_back({ n.child[slot], mask });
+                    }
+                    continue;
+                }
+                for (std::uint32_t i = n.child[slot]; i < n.child[slot] + n.count[slot]; i++) {
+                    unsigned objectMask = mask;
+                    if (!objectMask || classify(frustum, &m_boxes[i].min[0], &m_boxes[i].max[0], objectMask))
+                        visible.push_back(m_objects[i]);
+                }
+            }
+        }
+
+        auto& stats = cull_stats::global();
+        stats.visible += visible.size();
+        stats.culled += m_objects.size() - visible.size();
+    }
+
+    Bvh::Hit Bvh::raycast(const glm::vec3& origin, const glm::vec3& dir, float maxT,
+        const std::function<float(std::uint32_t, float)>& exact) const {
+        Hit best;
+        best.t = maxT;
+        if (m_nodes.empty())
+            return best;
+
+        const glm::vec3 inv(1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z);
+
+        struct entry { std::uint32_t node; float t; };
+        std::vector<entry> stack;
+        stack.reserve(64);
+        stack.push_back({ 0, 0.0f });
+
+        while (!stack.empty()) {
+            entry e = stack.back();
+            stack.pop_back();
+            if (e.t > best.t)
+                continue; // something nearer was found since it was pushed
+            const Node& n = m_nodes[e.node];
+
+            float tSlot[2];
+            bool hit[2];
+            for (int slot = 0; slot < 2; slot++) {
+                hit[slot] = !(n.count[slot] == 0 && n.child[slot] == invalid) &&
+                    slab(n.min[slot], n.max[slot], origin, inv, best.t, tSlot[slot]);
+            }
+
+            // Leaves first, then inner children with the nearer one on top
+            for (int slot = 0; slot < 2; slot++) {
+                if (!hit[slot] || n.count[slot] == 0)
+                    continue;
+                for (std::uint32_t i = n.child[slot]; i < n.child[slot] + n.count[slot]; i++) {
+                    float tBox;
+                    if (!slab(&m_boxes[i].min[0], &m_boxes[i].max[0], origin, inv, best.t, tBox))
+                        continue;
+                    float t = exact ? exact(m_objects[i], tBox) : tBox;
+                    if (t >= 0.0f && t < best.t) {
+                        best.t = t;
+                        best.object = m_objects[i];
+                    }
+                }
+            }
+
+            bool inner0 = hit[0] && n.count[0] == 0, inner1 = hit[1] && n.count[1] == 0;
+            if (inner0 && inner1) {
+                int nearSlot = tSlot[0] <= tSlot[1] ? 0 : 1;
+                stack.push_back({ n.child[1 - nearSlot], tSlot[1 - nearSlot] });
+                stack.push_back({ n.child[nearSlot], tSlot[nearSlot] });
+            }
+            else if (inner0) {
+                stack.push_back({ n.child[0], tSlot[0] });
+            }
+            else if (inner1) {
+                stack.push_back({ n.child[1], tSlot[1] });
+            }
+        }
+
+        if (best.object == invalid)
+            best.t = maxT;
+        return best;
+    }
+
+    Bvh::Stats Bvh::stats() const {
+        Stats s;
+        if (m_nodes.empty())
+            return s;
+
+        const float rootArea = std::max(m_root.area(), 1e-20f);
+        struct entry { std::uint32_t node; std::size_t depth; };
+        std::vector<entry> stack{ { 0, 1 } };
+        while (!stack.empty()) {
+            entry e = stack.back();
+            stack.pop_back();
+            s.nodes++;
+            s.depth = std::max(s.depth, e.depth);
+            for (int slot = 0; slot < 2; slot++) {
+                const Node& n = m_nodes[e.node];
+                if (n.count[slot] == 0 && n.child[slot] == invalid)
+                    continue;
+                float area = slotBox(e.node, slot).area() / rootArea;
+                if (n.count[slot] > 0) {
+                    s.leaves++;
+                    s.sahCost += area * n.count[slot];
+                }
+                else {
+                    s.sahCost += area; // one node visit
+                    stack.push_back({ n.child[slot], e.depth + 1 });
+                }
+            }
+        }
+        s.sahCost += 1.0; // the root itself
+        return s;
+    }
+
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "bounds.hpp"
+#include "Frustum.hpp"
+
+namespace gl {
+
+    /**
+     * @brief Bounding volume hierarchy over object boxes, for hierarchical
+     * frustum culling and ray casts.
+     *
+     * Built top-down with the binned surface area heuristic. Each node is
+     * one 64-byte cache line holding the boxes of both of its children, so
+     * a traversal step tests two boxes per memory fetch. Nodes live in one
+     * flat array with parents before children.
+     *
+     * refit() keeps the tree shape and only grows/shrinks boxes, which is
+     * cheap and fine for objects that move a little (a rotating picture);
+     * rebuild with build() once boxes have drifted far.
+     */
+    class Bvh {
+    public:
+        static constexpr std::uint32_t invalid = ~0u;
+
+        struct alignas(64) Node {
+            float min[2][3];
+            float max[2][3];
+            // count > 0: leaf, objects [child, child + count) of objects()
+            // count == 0: inner, child is a node index (invalid if the slot is empty)
+            std::uint32_t child[2];
+            std::uint32_t count[2];
+        };
+        static_assert(sizeof(Node) == 64, "Bvh::Node should fill one cache line");
+
+        struct Hit {
+            std::uint32_t object = invalid;
+            float t = 0.0f;
+        };
+
+        struct Stats {
+            std::size_t nodes = 0;
+            std::size_t leaves = 0;
+            std::size_t depth = 0;
+            double sahCost = 0.0; // expected traversal + intersection cost
+        };
+
+        // Boxes indexed by object id
+        void build(const std::vector<aabb>& boxes);
+
+        // Same objects, new boxes: recomputes every node bottom-up
+        void refit(const std::vector<aabb>& boxes);
+        // One object moved: recomputes only the nodes above it
+        void refit(std::uint32_t object, const aabb& box);
+
+        // Objects whose box intersects the frustum; counts into cull_stats
+        void cull(const Frustum& frustum, std::vector<std::uint32_t>& visible) const;
+
+        /**
+         * Nearest object along the ray within `maxT` (dir need not be
+         * normalized; t is in units of dir). Without `exact`, a box hit
+         * counts as a hit at the box entry; with it, `exact(object, tBox)`
+         * returns the object's own hit distance or a negative value to
+         * reject it, e.g. after testing triangles.
+         */
+        Hit raycast(const glm::vec3& origin, const glm::vec3& dir, float maxT = 1e30f,
+            const std::function<float(std::uint32_t object, float tBox)>& exact = nullptr) const;
+
+        std::size_t size() const { return m_objects.size(); }
+        bool empty() const { return m_nodes.empty(); }
+        const aabb& rootBox() const { return m_root; }
+        const std::vector<Node>& nodes() const { return m_nodes; }
+        // Object ids in leaf order
+        const std::vector<std::uint32_t>& objects() const { return m_objects; }
+        Stats stats() const;
+
+    private:
+        std::uint32_t buildNode(std::uint32_t first, std::uint32_t count, std::uint32_t parentRef,
+            const std::vector<aabb>& boxes, const std::vector<glm::vec3>& centroids);
+        void setSlot(std::uint32_t ref, const aabb& box);
+        aabb slotBox(std::uint32_t node, int slot) const;
+        aabb leafBox(std::uint32_t first, std::uint32_t count) const;
+
+        std::vector<Node> m_nodes;
+        std::vector<std::uint32_t> m_objects;    // object ids, leaf ranges contiguous
+        std::vector<aabb> m_boxes;               // boxes in leaf order, like m_objects
+        std::vector<std::uint32_t> m_positionOf; // object id -> index into m_objects
+        std::vector<std::uint32_t> m_parentRef;  // node -> parent node * 2 + slot
+        std::vector<std::uint32_t> m_first;      // node -> first object of its subtree
+        std::vector<std::uint32_t> m_count;      // node -> objects in its subtree
+        std::vector<std::uint32_t> m_leafRef;    // object id -> leaf node * 2 + slot
+        aabb m_root;
+    };
+
+}
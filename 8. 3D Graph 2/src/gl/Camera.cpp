@@ -106,6 +106,10 @@ namespace gl {
         return glm::lookAt(m_position, m_position + m_front, m_up);
     }
 
+    Frustum Camera::frustum(const glm::mat4& projection) const {
+        return Frustum(projection * getMatrix());
+    }
+
     //
     // Internal vector recomputation
     //
@@ -4,6 +4,8 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+#include "Frustum.hpp"
+
 namespace gl {
 
     class Camera {
@@ -41,6 +43,9 @@ namespace gl {
         // View matrix
         glm::mat4 getMatrix() const;
 
+        // Planes of projection * getMatrix()
+        Frustum frustum(const glm::mat4& projection) const;
+
     private:
         void updateVectors();
 
@@ -0,0 +1,118 @@
+#include "Frustum.hpp"
+
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define FRUSTUM_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace gl {
+
+    cull_stats& cull_stats::global() {
+        static cull_stats stats;
+        return stats;
+    }
+
+    // ---------------------------
+    // Frustum
+    // ---------------------------
+    Frustum::Frustum(const glm::mat4& viewProj) {
+        // Rows of the (column-major) matrix
+        glm::vec4 row[4];
+        for (int r = 0; r < 4; r++)
+            row[r] = glm::vec4(viewProj[0][r], viewProj[1][r], viewProj[2][r], viewProj[3][r]);
+
+        m_planes[0] = row[3] + row[0]; // left
+        m_planes[1] = row[3] - row[0]; // right
+        m_planes[2] = row[3] + row[1]; // bottom
+        m_planes[3] = row[3] - row[1]; // top
+        m_planes[4] = row[3] + row[2]; // near (GL clip depth -w..w)
+        m_planes[5] = row[3] - row[2]; // far
+
+        for (auto& p : m_planes) {
+            float len = glm::length(glm::vec3(p));
+            if (len > 0.0f)
+                p /= len;
+        }
+    }
+
+    bool Frustum::intersectsSphere(const glm::vec3& center, float radius) const {
+        for (const auto& p : m_planes) {
+            if (glm::dot(glm::vec3(p), center) + p.w < -radius)
+                return false;
+        }
+        return true;
+    }
+
+    bool Frustum::intersectsBox(const glm::vec3& min, const glm::vec3& max) const {
+        for (const auto& p : m_planes) {
+            // Corner furthest along the plane normal
+            glm::vec3 v(p.x >= 0 ? max.x : min.x, p.y >= 0 ? max.y : min.y, p.z >= 0 ? max.z : min.z);
+            if (glm::dot(glm::vec3(p), v) + p.w < 0.0f)
+                return false;
+        }
+        return true;
+    }
+
+    // ---------------------------
+    // CullBatch
+    // ---------------------------
+    void CullBatch::clear() {
+        m_x.clear();
+        m_y.clear();
+        m_z.clear();
+        m_r.clear();
+        m_count = 0;
+    }
+
+    std::size_t CullBatch::add(const glm::vec4& sphere) {
+        if (m_count % 4 == 0) {
+            for (auto* v : { &m_x, &m_y, &m_z, &m_r })
+                v->resize(m_count + 4, 0.0f);
+        }
+        m_x[m_count] = sphere.x;
+        m_y[m_count] = sphere.y;
+        m_z[m_count] = sphere.z;
+        m_r[m_count] = sphere.w;
+        return m_count++;
+    }
+
+    std::size_t CullBatch::cull(const Frustum& frustum) {
+        m_visible.resize(m_x.size());
+        std::size_t visible = 0;
+
+#ifdef FRUSTUM_SSE
+        for (std::size_t i = 0; i < m_x.size(); i += 4) {
+            __m128 x = _mm_loadu_ps(&m_x[i]), y = _mm_loadu_ps(&m_y[i]), z = _mm_loadu_ps(&m_z[i]);
+            __m128 negR = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&m_r[i]));
+
+            // Bit set where a sphere is fully behind any plane
+            __m128 outside = _mm_setzero_ps();
+            for (std::size_t p = 0; p < 6; p++) {
+                const glm::vec4& pl = frustum.plane(p);
+                __m128 d = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(pl.x)), _mm_mul_ps(y, _mm_set1_ps(pl.y)));
+                d = _mm_add_ps(d, _mm_mul_ps(z, _mm_set1_ps(pl.z)));
+                d = _mm_add_ps(d, _mm_set1_ps(pl.w));
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(d, negR));
+            }
+
+            int mask = _mm_movemask_ps(outside);
+            for (std::size_t k = 0; k < 4; k++)
+                m_visible[i + k] = !(mask & (1 << k));
+        }
+#else
+        for (std::size_t i = 0; i < m_x.size(); i++)
+            m_visible[i] = frustum.intersectsSphere(glm::vec3(m_x[i], m_y[i], m_z[i]), m_r[i]);
+#endif
+
+        for (std::size_t i = 0; i < m_count; i++)
+            visible += m_visible[i];
+
+        auto& stats = cull_stats::global();
+        stats.visible += visible;
+        stats.culled += m_count - visible;
+        return visible;
+    }
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace gl {
+
+    /**
+     * @brief Objects tested against the view frustum, and how many of
+     * them survived. Reset by whoever prints them.
+     */
+    struct cull_stats {
+        std::size_t visible = 0;
+        std::size_t culled = 0;
+
+        void reset() { *this = cull_stats(); }
+
+        static cull_stats& global();
+    };
+
+    /**
+     * @brief The six planes of a view-projection matrix (Gribb-Hartmann),
+     * normalized and pointing inwards: left, right, bottom, top, near, far.
+     */
+    class Frustum {
+    public:
+        Frustum() = default;
+        explicit Frustum(const glm::mat4& viewProj);
+
+        // (normal, distance): dot(normal, p) + distance >= 0 inside
+        const glm::vec4& plane(std::size_t i) const { return m_planes[i]; }
+
+        // Conservative: true unless fully outside one plane
+        bool intersectsSphere(const glm::vec3& center, float radius) const;
+        bool intersectsBox(const glm::vec3& min, const glm::vec3& max) const;
+
+    private:
+        glm::vec4 m_planes[6]{};
+    };
+
+    /**
+     * @brief Bounding spheres packed as separate x/y/z/radius arrays so
+     * cull() tests four of them per SSE instruction.
+     *
+     * Fill with add() each frame (world-space spheres, e.g. from
+     * Model::worldSphere), cull once, then draw whatever visible() says.
+     */
+    class CullBatch {
+    public:
+        void clear();
+        // Returns the sphere's index for visible()
+        std::size_t add(const glm::vec4& sphere);
+
+        // Marks every sphere, counts into cull_stats; returns the visible count
+        std::size_t cull(const Frustum& frustum);
+
+        bool visible(std::size_t i) const { return m_visible[i] != 0; }
+        std::size_t size() const { return m_count; }
+
+    private:
+        // Padded to a multiple of 4 with zero-radius spheres
+        std::vector<float> m_x, m_y, m_z, m_r;
+        std::vector<std::uint8_t> m_visible;
+        std::size_t m_count = 0;
+    };
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace gl {
+
+    /**
+     * @brief Read-only memory mapping of a whole file.
+     *
+     * The mapping stays valid until close() or destruction, so pointers into
+     * data() can be handed straight to glBufferData without a copy.
+     */
+    class MappedFile {
+    private:
+        const unsigned char* m_data = nullptr;
+        std::size_t m_size = 0;
+
+#ifdef _WIN32
+        void* m_file = nullptr;
+        void* m_mapping = nullptr;
+#else
+        int m_fd = -1;
+#endif
+
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        bool open(const std::string& path);
+        void close();
+
+        bool isOpen() const { return m_data != nullptr; }
+        const unsigned char* data() const { return m_data; }
+        std::size_t size() const { return m_size; }
+
+    private:
+        void moveFrom(MappedFile&& o) noexcept;
+    };
+
+}
@@ -1,9 +1,55 @@
 #include "Mesh.hpp"
 
 #include "MeshParser.hpp"
+#include "StateCache.hpp"
+
+#include <algorithm>
+#include <iostream>
 
 namespace gl {
 
+    namespace {
+        struct split_range {
+            std::size_t first, count;
+            unsigned int base;
+        };
+
+        /**
+         * Cuts a triangle list into runs whose indices all lie within 65536
+         * of the run's lowest index. Fails on anything that is not a list of
+         * whole triangles or that would need a draw per handful of triangles.
+         */
+        bool splitTriangles(const unsigned int* indices, std::size_t count,
+            unsigned int maxIndex, std::vector<split_range>& out) {
+            if (count % 3 != 0)
+                return false;
+
+            std::size_t first = 0;
+            unsigned int lo = ~0u, hi = 0;
+            for (std::size_t t = 0; t < count; t += 3) {
+                unsigned int tlo = std::min({ indices[t], indices[t + 1], indices[t + 2] });
+                unsigned int thi = std::max({ indices[t], indices[t + 1], indices[t + 2] });
+                if (thi - tlo > 0xFFFF)
+                    return false;
+
+                if (std::max(hi, thi) - std::min(lo, tlo) > 0xFFFF) {
+                    out.push_back({ first, t - first, lo });
+                    first = t;
+                    lo = tlo;
+                    hi = thi;
+                }
+                else {
+                    lo = std::min(lo, tlo);
+                    hi = std::max(hi, thi);
+                }
+            }
+            out.push_back({ first, count - first, lo });
+
+            // Well ordered meshes need about one run per 64k vertices
+            return out.size() <= 4 * (maxIndex / 0x10000 + 1);
+        }
+    }
+
     Mesh::~Mesh() {
         destroy();
     }
@@ -18,67 +64,205 @@ namespace gl {
         return *this;
     }
 
-    void Mesh::upload(const MeshData& data) {
-        this->upload(data.vertices, data.indices, data.layout);
+    void Mesh::upload(const MeshData& data, bool splitIndices) {
+        this->upload(data.vertices.data(), data.vertices.size(),
+            data.indices.data(), data.indices.size(), data.layout, splitIndices);
+        metadata = data.metadata;
     }
 
     void Mesh::upload(const std::vector<float>& vertexData,
         const std::vector<unsigned int>& indices,
+        const vertex_layout& layout, bool splitIndices) {
+        this->upload(vertexData.data(), vertexData.size() * sizeof(float),
+            indices.data(), indices.size(), layout, splitIndices);
+    }
+
+    void Mesh::upload(const void* vertexData, std::size_t vertexBytes,
+        const unsigned int* indices, std::size_t indexCount,
+        const vertex_layout& layout, bool splitIndices) {
+        unsigned int maxIndex = indexCount ? *std::max_element(indices, indices + indexCount) : 0;
+        GLenum type = indexTypeFor(maxIndex);
+
+        std::vector<split_range> runs;
+        if (type == GL_UNSIGNED_INT && splitIndices) {
+            if (splitTriangles(indices, indexCount, maxIndex, runs))
+                type = GL_UNSIGNED_SHORT;
+            else
+                std::cerr << "Note: indices are too scattered to split into 16-bit submeshes, keeping 32-bit\n";
+        }
+
+        if (type == GL_UNSIGNED_INT) {
+            upload(vertexData, vertexBytes, indices, indexCount, GL_UNSIGNED_INT, layout);
+            return;
+        }
+
+        // Narrow to 16 bits, relative to each run's base vertex
+        if (runs.empty())
+            runs.push_back({ 0, indexCount, 0 });
+
+        std::vector<unsigned short> narrow(indexCount);
+        for (const auto& r : runs)
+            for (std::size_t i = r.first; i < r.first + r.count; i++)
+                narrow[i] = static_cast<unsigned short>(indices[i] - r.base);
+
+        upload(vertexData, vertexBytes, narrow.data(), indexCount, GL_UNSIGNED_SHORT, layout);
+
+        if (runs.size() > 1) {
+            for (const auto& r : runs)
+                m_ranges.push_back({ static_cast<GLsizei>(r.count), r.first * sizeof(unsigned short),
+                    static_cast<GLint>(r.base) });
+        }
+    }
+
+    void Mesh::upload(const void* vertexData, std::size_t vertexBytes,
+        const void* indices, std::size_t indexCount, GLenum indexType,
         const vertex_layout& layout) {
         m_stride = layout.stride();
-        m_vertexCount = static_cast<GLsizei>(vertexData.size() * sizeof(float) / m_stride);
-        m_indexCount = static_cast<GLsizei>(indices.size());
-        m_hasEBO = !indices.empty();
+        m_vertexCount = static_cast<GLsizei>(vertexBytes / m_stride);
+        m_indexCount = static_cast<GLsizei>(indexCount);
+        m_indexType = indexType;
+        m_ranges.clear();
+        m_hasEBO = indexCount != 0;
+        m_bounds = gl::bounds::of(vertexData, vertexBytes, layout);
 
         if (!m_vao) glGenVertexArrays(1, &m_vao);
         if (!m_vbo) glGenBuffers(1, &m_vbo);
 
-        glBindVertexArray(m_vao);
+        StateCache::current().bindVertexArray(m_vao);
         glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-        glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), vertexData.data(), GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, vertexBytes, vertexData, GL_STATIC_DRAW);
 
         if (m_hasEBO) {
             if (!m_ebo) glGenBuffers(1, &m_ebo);
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * indexSize(indexType), indices, GL_STATIC_DRAW);
+        }
+
+        layout.enable();
+        m_nextAttribute = layout.nextIndex();
+        StateCache::current().bindVertexArray(0);
+    }
+
+    void Mesh::uploadInstances(const std::vector<float>& instanceData,
+        const vertex_layout& layout) {
+        uploadInstances(instanceData.data(), instanceData.size() * sizeof(float), layout);
+    }
+
+    void Mesh::uploadInstances(const void* data, std::size_t bytes,
+        const vertex_layout& layout) {
+        if (!m_vao) return;
+
+        m_instanceCount = static_cast<GLsizei>(bytes / layout.stride());
+
+        StateCache::current().bindVertexArray(m_vao);
+
+        if (!m_instanceVbo) glGenBuffers(1, &m_instanceVbo);
+        glBindBuffer(GL_ARRAY_BUFFER, m_instanceVbo);
+
+        // Orphan the old storage before refilling it so the driver can hand
+        // out fresh memory instead of stalling on draws still reading it
+        if (bytes <= m_instanceBytes) {
+            glBufferData(GL_ARRAY_BUFFER, m_instanceBytes, nullptr, GL_DYNAMIC_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, data);
+        }
+        else {
+            glBufferData(GL_ARRAY_BUFFER, bytes, data, GL_DYNAMIC_DRAW);
+            m_instanceBytes = bytes;
         }
 
         layout.enable();
-        glBindVertexArray(0);
+        StateCache::current().bindVertexArray(0);
     }
 
+    // The VAO stays bound afterwards, so drawing the same mesh again
+    // skips the bind; uploads bind their own VAO before touching buffers
     void Mesh::draw(GLenum mode) const {
         if (!m_vao) return;
-        glBindVertexArray(m_vao);
+        StateCache::current().bindVertexArray(m_vao);
+        drawBound(mode, 0);
+    }
+
+    void Mesh::drawInstanced(GLenum mode) const {
+        drawInstanced(m_instanceCount, mode);
+    }
+
+    void Mesh::drawInstanced(GLsizei count, GLenum mode) const {
+        if (!m_vao || count <= 0) return;
+        StateCache::current().bindVertexArray(m_vao);
+        drawBound(mode, count);
+    }
+
+    void Mesh::drawBound(GLenum mode, GLsizei instances) const {
+        if (!m_vao) return;
         if (m_hasEBO)
-            glDrawElements(mode, m_indexCount, GL_UNSIGNED_INT, nullptr);
+            drawElements(mode, instances);
+        else if (instances)
+            glDrawArraysInstanced(mode, 0, m_vertexCount, instances);
         else
             glDrawArrays(mode, 0, m_vertexCount);
-        glBindVertexArray(0);
+    }
+
+    // Expects the VAO bound; instances == 0 means a plain draw
+    void Mesh::drawElements(GLenum mode, GLsizei instances) const {
+        if (m_ranges.empty()) {
+            if (instances)
+                glDrawElementsInstanced(mode, m_indexCount, m_indexType, nullptr, instances);
+            else
+                glDrawElements(mode, m_indexCount, m_indexType, nullptr);
+            return;
+        }
+
+        for (const auto& r : m_ranges) {
+            const void* offset = reinterpret_cast<const void*>(r.offset);
+            if (instances)
+                glDrawElementsInstancedBaseVertex(mode, r.count, m_indexType, offset, instances, r.baseVertex);
+            else
+                glDrawElementsBaseVertex(mode, r.count, m_indexType, offset, r.baseVertex);
+        }
     }
 
     void Mesh::destroy() {
         if (m_vbo) glDeleteBuffers(1, &m_vbo);
         if (m_ebo) glDeleteBuffers(1, &m_ebo);
-        if (m_vao) glDeleteVertexArrays(1, &m_vao);
+        if (m_instanceVbo) glDeleteBuffers(1, &m_instanceVbo);
+        if (m_vao) {
+            StateCache::current().forgetVertexArray(m_vao);
+            glDeleteVertexArrays(1, &m_vao);
+        }
 
-        m_vao = m_vbo = m_ebo = 0;
+        m_vao = m_vbo = m_ebo = m_instanceVbo = 0;
         m_hasEBO = false;
         m_vertexCount = m_indexCount = 0;
+        m_indexType = GL_UNSIGNED_INT;
+        m_ranges.clear();
+        m_bounds = gl::bounds();
         m_stride = 0;
+        m_instanceCount = 0;
+        m_instanceBytes = 0;
+        m_nextAttribute = 0;
     }
 
     void Mesh::moveFrom(Mesh&& o) noexcept {
         m_vao = o.m_vao; o.m_vao = 0;
         m_vbo = o.m_vbo; o.m_vbo = 0;
         m_ebo = o.m_ebo; o.m_ebo = 0;
+        m_instanceVbo = o.m_instanceVbo; o.m_instanceVbo = 0;
 
         m_hasEBO = o.m_hasEBO; o.m_hasEBO = false;
 
         m_vertexCount = o.m_vertexCount; o.m_vertexCount = 0;
         m_indexCount = o.m_indexCount; o.m_indexCount = 0;
+        m_indexType = o.m_indexType;
+        m_ranges = std::move(o.m_ranges);
+        m_bounds = o.m_bounds;
 
         m_stride = o.m_stride; o.m_stride = 0;
+
+        metadata = std::move(o.metadata);
+
+        m_instanceCount = o.m_instanceCount; o.m_instanceCount = 0;
+        m_instanceBytes = o.m_instanceBytes; o.m_instanceBytes = 0;
+        m_nextAttribute = o.m_nextAttribute; o.m_nextAttribute = 0;
     }
 
     std::string Mesh::getMeta(const std::string& key) const {
@@ -89,4 +273,16 @@ namespace gl {
         metadata[key] = val;
     }
 
+    GLenum Mesh::indexTypeFor(unsigned int maxIndex) {
+        return maxIndex <= 0xFFFF ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    }
+
+    std::size_t Mesh::indexSize(GLenum type) {
+        switch (type) {
+        case GL_UNSIGNED_BYTE:  return 1;
+        case GL_UNSIGNED_SHORT: return 2;
+        default:                return 4;
+        }
+    }
+
 }
@@ -7,6 +7,7 @@
 #include <unordered_map>
 
 #include "vertex_layout.hpp"
+#include "bounds.hpp"
 
 namespace gl {
 
@@ -17,12 +18,29 @@ namespace gl {
         GLuint m_vao = 0;
         GLuint m_vbo = 0;
         GLuint m_ebo = 0;
+        GLuint m_instanceVbo = 0;
         bool   m_hasEBO = false;
 
         GLsizei m_vertexCount = 0;
         GLsizei m_indexCount = 0;
+        GLenum m_indexType = GL_UNSIGNED_INT;
         std::size_t m_stride = 0;
 
+        // 16-bit submeshes of a split mesh, drawn with a base vertex each
+        struct index_range {
+            GLsizei count;
+            std::size_t offset; // bytes into the index buffer
+            GLint baseVertex;
+        };
+        std::vector<index_range> m_ranges;
+
+        // Of the positions, computed on every vertex upload
+        gl::bounds m_bounds;
+
+        GLsizei m_instanceCount = 0;
+        std::size_t m_instanceBytes = 0;
+        GLuint m_nextAttribute = 0;
+
         std::unordered_map<std::string, std::string> metadata;
 
     public:
@@ -34,13 +52,52 @@ namespace gl {
         Mesh(Mesh&& other) noexcept;
         Mesh& operator=(Mesh&& other) noexcept;
 
+        /**
+         * 32-bit indices are stored as GL_UNSIGNED_SHORT whenever every index
+         * fits, and kept as GL_UNSIGNED_INT otherwise. With splitIndices set,
+         * triangle lists referencing more than 65536 vertices are cut into
+         * 16-bit submeshes instead, each drawn relative to its own base vertex.
+         */
         void upload(const std::vector<float>& vertexData,
             const std::vector<unsigned int>& indices,
-            const vertex_layout& layout);
+            const vertex_layout& layout, bool splitIndices = false);
         
-        void upload(const MeshData& data);
+        void upload(const MeshData& data, bool splitIndices = false);
+
+        // Raw variants: data may point straight into a mapped file
+        void upload(const void* vertexData, std::size_t vertexBytes,
+            const unsigned int* indices, std::size_t indexCount,
+            const vertex_layout& layout, bool splitIndices = false);
+
+        // Indices already in `indexType` (GL_UNSIGNED_BYTE/SHORT/INT), uploaded as is
+        void upload(const void* vertexData, std::size_t vertexBytes,
+            const void* indices, std::size_t indexCount, GLenum indexType,
+            const vertex_layout& layout);
+
+        /**
+         * Upload per-instance attributes (e.g. model matrices) into a second
+         * buffer attached to this mesh's VAO. The layout must be built with
+         * vertex_layout(instanceBaseIndex(), 1) so it continues after the
+         * mesh attributes and advances once per instance.
+         * Reuploading with the same or smaller size orphans and refills the
+         * existing buffer instead of growing it.
+         */
+        void uploadInstances(const void* data, std::size_t bytes,
+            const vertex_layout& layout);
+
+        void uploadInstances(const std::vector<float>& instanceData,
+            const vertex_layout& layout);
 
         void draw(GLenum mode = GL_TRIANGLES) const;
+
+        // Draws the uploaded instances in a single call
+        void drawInstanced(GLenum mode = GL_TRIANGLES) const;
+        void drawInstanced(GLsizei count, GLenum mode = GL_TRIANGLES) const;
+
+        // Same draws with vao() already bound by the caller, which keeps
+        // it bound (see RenderQueue); instances == 0 means a plain draw
+        void drawBound(GLenum mode = GL_TRIANGLES, GLsizei instances = 0) const;
+
         void destroy();
 
         GLuint vao() const { return m_vao; }
@@ -48,12 +105,24 @@ namespace gl {
         GLuint ebo() const { return m_ebo; }
         GLsizei vertexCount() const { return m_vertexCount; }
         GLsizei indexCount() const { return m_indexCount; }
+        GLenum indexType() const { return m_indexType; }
+        std::size_t submeshCount() const { return m_ranges.empty() ? 1 : m_ranges.size(); }
+        GLsizei instanceCount() const { return m_instanceCount; }
+        GLuint instanceBaseIndex() const { return m_nextAttribute; }
+        const gl::bounds& bounds() const { return m_bounds; }
 
         std::string getMeta(const std::string& key) const;
 
         void setMeta(const std::string& key, const std::string& val);
 
+        // Narrowest index type automatic selection picks for `maxIndex`.
+        // GL_UNSIGNED_BYTE is never chosen: several drivers widen it on the CPU.
+        static GLenum indexTypeFor(unsigned int maxIndex);
+        static std::size_t indexSize(GLenum type);
+
     private:
+        void drawElements(GLenum mode, GLsizei instances) const;
+
         void moveFrom(Mesh&& o) noexcept;
     };
 
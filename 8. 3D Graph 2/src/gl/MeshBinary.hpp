@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace gl {
+
+    /**
+     * @brief On-disk layout of compiled `.mob` meshes, the binary
+     * counterpart of the text `.mo` format.
+     *
+     *   [MeshBinaryHeader]
+     *   [MeshBinaryAttribute x attributeCount]   layout descriptor
+     *   [metadata: "key\0value\0" pairs]         metadataBytes long
+     *   [padding] [vertex blob]                  at vertexOffset
+     *   [padding] [index blob]                   at indexOffset
+     *
+     * Blobs are aligned to MeshBinaryAlignment so the mapped file can be
+     * handed straight to glBufferData. All fields are little-endian.
+     *
+     * Bump MeshBinaryVersion with every layout change; loadModel then
+     * ignores older files and reads the `.mo` source instead.
+     *   1: float attributes, 32-bit indices
+     *   2: attributes carry a semantic tag and may be half, normalized
+     *      or 2_10_10_10 packed
+     *   3: indexType picks 16- or 32-bit indices
+     */
+    constexpr char          MeshBinaryMagic[4] = { 'M', 'O', 'B', '\0' };
+    constexpr std::uint32_t MeshBinaryVersion = 3;
+    constexpr std::size_t   MeshBinaryAlignment = 64;
+
+    struct MeshBinaryHeader {
+        char          magic[4];
+        std::uint32_t version;
+        std::uint32_t attributeCount;
+        std::uint32_t metadataBytes;
+        std::uint64_t vertexOffset;
+        std::uint64_t vertexBytes;
+        std::uint64_t indexOffset;
+        std::uint64_t indexCount;
+        std::uint32_t indexType;     // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT (GL_UNSIGNED_BYTE is read too)
+        std::uint32_t reserved;
+    };
+
+    struct MeshBinaryAttribute {
+        std::uint32_t type;          // GL_FLOAT, GL_INT, ...
+        std::uint32_t components;
+        std::uint32_t normalized;
+        std::uint32_t semantic;      // vertex_layout::semantic
+    };
+
+    static_assert(sizeof(MeshBinaryHeader) == 56, "MeshBinaryHeader must be tightly packed");
+    static_assert(sizeof(MeshBinaryAttribute) == 16, "MeshBinaryAttribute must be tightly packed");
+
+}
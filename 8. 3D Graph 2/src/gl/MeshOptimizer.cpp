@@ -0,0 +1,284 @@
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace gl {
+
+    namespace {
+        // Triangles around each vertex, as one flat array
+        struct Adjacency {
+            std::vector<unsigned int> offsets; // vertexCount + 1
+            std::vector<unsigned int> triangles;
+            std::vector<unsigned int> live;    // triangles not yet emitted
+
+            Adjacency(const std::vector<unsigned int>& indices, std::size_t vertexCount)
+                : offsets(vertexCount + 1, 0), triangles(indices.size()), live(vertexCount, 0) {
+                for (unsigned int v : indices)
+                    live[v]++;
+                for (std::size_t v = 0; v < vertexCount; v++)
+                    offsets[v + 1] = offsets[v] + live[v];
+
+                std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+                for (std::size_t i = 0; i < indices.size(); i++)
+                    triangles[fill[indices[i]]++] = static_cast<unsigned int>(i / 3);
+            }
+        };
+
+        const float* findPositions(const MeshData& data) {
+            const vertex_layout::Attribute* a = data.positionAttribute();
+            return a ? reinterpret_cast<const float*>(data.vertices.data() + a->offset) : nullptr;
+        }
+
+        double elapsedMs(std::chrono::steady_clock::time_point since) {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+        }
+    }
+
+    MeshCacheStats MeshOptimizer::cacheStats(const std::vector<unsigned int>& indices,
+        std::size_t vertexCount, unsigned cacheSize) {
+        MeshCacheStats stats;
+        if (indices.empty())
+            return stats;
+
+        // A vertex is cached while fewer than cacheSize misses followed it
+        std::vector<std::size_t> insertedAt(vertexCount, 0);
+        std::vector<bool> used(vertexCount, false);
+        std::size_t time = cacheSize + 1, misses = 0, unique = 0;
+        for (unsigned int v : indices) {
+            if (time - insertedAt[v] > cacheSize) {
+                insertedAt[v] = time++;
+                misses++;
+            }
+            if (!used[v]) {
+                used[v] = true;
+                unique++;
+            }
+        }
+
+        stats.acmr = static_cast<double>(misses) / (indices.size() / 3);
+        stats.atvr = static_cast<double>(misses) / unique;
+        return stats;
+    }
+
+    /**
+     * Tipsify (Sander, Nehab, Barczak 2007): fan out around a focus vertex,
+     * then move the focus to the neighbour that will still be cached
+     * longest once its remaining triangles are emitted. Dead ends fall
+     * back to recently touched vertices, then to a linear scan.
+     */
+    void MeshOptimizer::optimizeVertexCache(std::vector<unsigned int>& indices, std::size_t vertexCount,
+        std::vector<std::size_t>* clusterStarts, unsigned cacheSize) {
+        const std::size_t triangleCount = indices.size() / 3;
+        Adjacency adj(indices, vertexCount);
+
+        std::vector<std::size_t> cachedAt(vertexCount, 0);
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<unsigned int> deadEnd, candidates, out;
+        out.reserve(indices.size());
+        deadEnd.reserve(indices.size());
+
+        std::size_t time = cacheSize + 1;
+        std::size_t scan = 0;
+        long focus = vertexCount ? 0 : -1;
+        bool restarted = true;
+
+        while (focus >= 0) {
+            if (restarted && clusterStarts && (clusterStarts->empty() || clusterStarts->back() != out.size() / 3))
+                clusterStarts->push_back(out.size() / 3);
+            restarted = false;
+
+            candidates.clear();
+            for (unsigned int k = adj.offsets[focus]; k < adj.offsets[focus + 1]; k++) {
+                unsigned int t = adj.triangles[k];
+                if (emitted[t])
+                    continue;
+                emitted[t] = true;
+                for (int c = 0; c < 3; c++) {
+                    unsigned int v = indices[t * 3 + c];
+                    out.push_back(v);
+                    deadEnd.push_back(v);
+                    candidates.push_back(v);
+                    adj.live[v]--;
+                    if (time - cachedAt[v] > cacheSize)
+                        cachedAt[v] = time++;
+                }
+            }
+
+            // Prefer the candidate that stays in cache through its own fan
+            long best = -1, bestPriority = -1;
+            for (unsigned int v : candidates) {
+                if (adj.live[v] == 0)
+                    continue;
+                long priority = 0;
+                if (time - cachedAt[v] + 2 * adj.live[v] <= cacheSize)
+                    priority = static_cast<long>(time - cachedAt[v]);
+                if (priority > bestPriority) {
+                    best = v;
+                    bestPriority = priority;
+                }
+            }
+
+            if (best < 0) {
+                restarted = true;
+                while (!deadEnd.empty() && best < 0) {
+                    unsigned int v = deadEnd.back();
+                    deadEnd.pop_back();
+                    if (adj.live[v] > 0)
+                        best = v;
+                }
+                while (best < 0 && scan < vertexCount) {
+                    if (adj.live[scan] > 0)
+                        best = static_cast<long>(scan);
+                    scan++;
+                }
+            }
+            focus = best;
+        }
+
+        indices.swap(out);
+    }
+
+    /**
+     * Sander et al.'s linear-speed overdraw ordering: draw the clusters
+     * facing away from the mesh centre first, as they tend to occlude the
+     * rest. Clusters keep their internal (cache friendly) order.
+     */
+    bool MeshOptimizer::optimizeOverdraw(const MeshData& data, std::vector<unsigned int>& indices,
+        const std::vector<std::size_t>& clusterStarts) {
+        const float* positions = findPositions(data);
+        const std::size_t stride = data.layout.stride() / sizeof(float);
+        if (!positions || data.layout.stride() % sizeof(float) != 0 || clusterStarts.size() < 2)
+            return false;
+
+        auto pos = [&](unsigned int v, int c) { return positions[v * stride + c]; };
+
+        const std::size_t triangleCount = indices.size() / 3;
+        struct Cluster {
+            std::size_t first, last;
+            float centroid[3];
+            float normal[3];
+            float area;
+            double sortKey;
+        };
+        std::vector<Cluster> clusters;
+        clusters.reserve(clusterStarts.size());
+        float meshCentroid[3] = { 0.0f, 0.0f, 0.0f };
+        float meshArea = 0.0f;
+
+        for (std::size_t i = 0; i < clusterStarts.size(); i++) {
+            Cluster cl{ clusterStarts[i], i + 1 < clusterStarts.size() ? clusterStarts[i + 1] : triangleCount,
+                { 0, 0, 0 }, { 0, 0, 0 }, 0.0f, 0.0 };
+
+            for (std::size_t t = cl.first; t < cl.last; t++) {
+                unsigned int a = indices[t * 3], b = indices[t * 3 + 1], c = indices[t * 3 + 2];
+                float e1[3], e2[3];
+                for (int k = 0; k < 3; k++) {
+                    e1[k] = pos(b, k) - pos(a, k);
+                    e2[k] = pos(c, k) - pos(a, k);
+                }
+                float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+                float area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+                // Area weighted, so slivers do not skew the cluster
+                for (int k = 0; k < 3; k++) {
+                    cl.normal[k] += n[k];
+                    cl.centroid[k] += area * (pos(a, k) + pos(b, k) + pos(c, k)) / 3.0f;
+                }
+                cl.area += area;
+            }
+
+            for (int k = 0; k < 3; k++)
+                meshCentroid[k] += cl.centroid[k];
+            meshArea += cl.area;
+            if (cl.area > 0.0f)
+                for (int k = 0; k < 3; k++)
+                    cl.centroid[k] /= cl.area;
+            clusters.push_back(cl);
+        }
+
+        if (meshArea > 0.0f)
+            for (int k = 0; k < 3; k++)
+                meshCentroid[k] /= meshArea;
+
+        for (auto& cl : clusters) {
+            cl.sortKey = 0.0;
+            for (int k = 0; k < 3; k++)
+                cl.sortKey += static_cast<double>(cl.centroid[k] - meshCentroid[k]) * cl.normal[k];
+        }
+        std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) {
+            return a.sortKey > b.sortKey;
+        });
+
+        std::vector<unsigned int> out;
+        out.reserve(indices.size());
+        for (const auto& cl : clusters)
+            out.insert(out.end(), indices.begin() + cl.first * 3, indices.begin() + cl.last * 3);
+        indices.swap(out);
+        return true;
+    }
+
+    // Renumbers vertices in the order the index buffer first uses them;
+    // unreferenced vertices move to the end
+    void MeshOptimizer::optimizeVertexFetch(MeshData& data) {
+        const std::size_t vertexCount = data.vertexCount();
+        const std::size_t stride = data.layout.stride();
+        const unsigned int unset = ~0u;
+
+        std::vector<unsigned int> remap(vertexCount, unset);
+        unsigned int next = 0;
+        for (unsigned int& v : data.indices) {
+            if (remap[v] == unset)
+                remap[v] = next++;
+            v = remap[v];
+        }
+        for (auto& r : remap)
+            if (r == unset)
+                r = next++;
+
+        std::vector<unsigned char> out(data.vertices.size());
+        for (std::size_t v = 0; v < vertexCount; v++)
+            std::memcpy(out.data() + remap[v] * stride, data.vertices.data() + v * stride, stride);
+        data.vertices.swap(out);
+    }
+
+    bool MeshOptimizer::optimize(MeshData& data, Result* result) {
+        const std::size_t vertexCount = data.vertexCount();
+        if (data.indices.empty() || data.indices.size() % 3 != 0)
+            return false;
+        if (*std::max_element(data.indices.begin(), data.indices.end()) >= vertexCount)
+            return false;
+
+        auto start = std::chrono::steady_clock::now();
+        Result r;
+        r.before = cacheStats(data.indices, vertexCount);
+
+        std::vector<std::size_t> clusterStarts;
+        optimizeVertexCache(data.indices, vertexCount, &clusterStarts);
+        if (optimizeOverdraw(data, data.indices, clusterStarts))
+            r.clusters = clusterStarts.size();
+        optimizeVertexFetch(data);
+
+        r.ms = elapsedMs(start);
+        r.after = cacheStats(data.indices, vertexCount);
+        if (result)
+            *result = r;
+        return true;
+    }
+
+    void MeshOptimizer::report(std::ostream& os, const std::string& name, const Result& result) {
+        auto flags = os.flags();
+        auto precision = os.precision(3);
+        os.setf(std::ios::fixed, std::ios::floatfield);
+        os << "[optimize] " << name << ": ACMR " << result.before.acmr << " -> " << result.after.acmr
+            << ", ATVR " << result.before.atvr << " -> " << result.after.atvr;
+        if (result.clusters)
+            os << ", " << result.clusters << " overdraw clusters";
+        os << " (" << result.ms << " ms)\n";
+        os.flags(flags);
+        os.precision(precision);
+    }
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "MeshParser.hpp"
+
+namespace gl {
+
+    // Post-transform cache behaviour of an index buffer
+    struct MeshCacheStats {
+        double acmr = 0.0;  // vertices transformed per triangle (0.5 is ideal for big grids)
+        double atvr = 0.0;  // vertices transformed per vertex (1.0 is ideal)
+    };
+
+    /**
+     * @brief Reorders imported triangle lists for the GPU.
+     *
+     *   1. triangles for post-transform vertex cache reuse (Tipsify)
+     *   2. Tipsify's clusters outside-in, so near surfaces hide the rest
+     *   3. vertices in first-use order, for fetch locality
+     *
+     * Only the order of triangles and vertices changes, never the mesh.
+     */
+    class MeshOptimizer {
+    public:
+        // FIFO cache modelled by Tipsify and the stats
+        static constexpr unsigned CacheSize = 16;
+
+        struct Result {
+            MeshCacheStats before, after;
+            std::size_t clusters = 0; // 0 when overdraw ordering was skipped
+            double ms = 0.0;
+        };
+
+        // Returns false (and leaves data alone) for anything but a triangle list
+        static bool optimize(MeshData& data, Result* result = nullptr);
+
+        static MeshCacheStats cacheStats(const std::vector<unsigned int>& indices,
+            std::size_t vertexCount, unsigned cacheSize = CacheSize);
+
+        // Steps of optimize(), usable on their own. `clusterStarts`
+        // receives the first triangle of each Tipsify cluster.
+        static void optimizeVertexCache(std::vector<unsigned int>& indices, std::size_t vertexCount,
+            std::vector<std::size_t>* clusterStarts = nullptr, unsigned cacheSize = CacheSize);
+        static bool optimizeOverdraw(const MeshData& data, std::vector<unsigned int>& indices,
+            const std::vector<std::size_t>& clusterStarts);
+        static void optimizeVertexFetch(MeshData& data);
+
+        static void report(std::ostream& os, const std::string& name, const Result& result);
+    };
+
+}
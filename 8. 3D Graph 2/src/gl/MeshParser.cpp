@@ -1,61 +1,497 @@
 #include "MeshParser.hpp"
+#include "MeshBinary.hpp"
+#include "MappedFile.hpp"
+#include "ThreadPool.hpp"
+#include "MeshQuantizer.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshWelder.hpp"
+#include "MeshSimplifier.hpp"
+#include "Model.hpp"
 #include <fstream>
-#include <sstream>
 #include <iostream>
-#include <cctype>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <functional>
+#include <filesystem>
+#include <memory>
+#include <mutex>
 
 namespace gl {
 
-    Mesh MeshParser::loadModel(const std::string& path) {  
+    namespace {
+        enum Section { NONE, VERTEX, INDEX };
+
+        // Data lines of one section, `end` is one past the last newline
+        struct TextRange {
+            Section section;
+            const char* begin;
+            const char* end;
+        };
+
+        inline bool isSpace(char c) {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+        }
+
+        std::string_view trimView(std::string_view s) {
+            while (!s.empty() && isSpace(s.back()))
+                s.remove_suffix(1);
+            while (!s.empty() && isSpace(s.front()))
+                s.remove_prefix(1);
+            return s;
+        }
+
+        // Line without its comment and surrounding whitespace, no copies
+        std::string_view trimLine(const char* begin, const char* end) {
+            const char* hash = static_cast<const char*>(std::memchr(begin, '#', end - begin));
+            return trimView({ begin, static_cast<std::size_t>((hash ? hash : end) - begin) });
+        }
+
+        vertex_layout::semantic parseSemantic(std::string_view name) {
+            using semantic = vertex_layout::semantic;
+            if (name == "position" || name == "pos")  return semantic::position;
+            if (name == "color" || name == "colour")  return semantic::color;
+            if (name == "normal")                     return semantic::normal;
+            if (name == "uv" || name == "texcoord")   return semantic::uv;
+            return semantic::none;
+        }
+
+        // Layout header, e.g. "float(3) float(3):color"
+        void readLayout(std::string_view line, vertex_layout& layout) {
+            std::size_t i = 0;
+            while (i < line.size()) {
+                while (i < line.size() && isSpace(line[i])) i++;
+                std::size_t start = i;
+                while (i < line.size() && !isSpace(line[i])) i++;
+                std::string_view token = line.substr(start, i - start);
+                if (token.empty())
+                    break;
+
+                int comps = 0;
+                auto paren = token.find('(');
+                if (paren != std::string_view::npos)
+                    std::from_chars(token.data() + paren + 1, token.data() + token.size(), comps);
+
+                std::size_t before = layout.attributes().size();
+                if (token.starts_with("float"))       layout.add<float>(comps);
+                else if (token.starts_with("int"))    layout.add<int>(comps);
+                else if (token.starts_with("uint"))   layout.add<unsigned int>(comps);
+                else if (token.starts_with("double")) layout.add<double>(comps);
+
+                // Optional meaning after the count, e.g. "float(3):color"
+                auto colon = token.find(':', paren);
+                if (colon != std::string_view::npos && layout.attributes().size() > before)
+                    layout.tag(parseSemantic(token.substr(colon + 1)));
+            }
+        }
+
+        // Calls fn(begin, end) for every whitespace separated token,
+        // skipping `#` comments
+        template<typename F>
+        void forEachToken(const char* p, const char* end, F&& fn) {
+            while (p < end) {
+                char c = *p;
+                if (isSpace(c)) {
+                    ++p;
+                    continue;
+                }
+                if (c == '#') {
+                    const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+                    p = nl ? nl + 1 : end;
+                    continue;
+                }
+
+                const char* start = p;
+                while (p < end && !isSpace(*p) && *p != '#')
+                    ++p;
+                fn(start, p);
+            }
+        }
+
+        std::size_t countTokens(const char* begin, const char* end) {
+            std::size_t n = 0;
+            forEachToken(begin, end, [&](const char*, const char*) { n++; });
+            return n;
+        }
+
+        // Parses a whole token as T into dst, false if it is malformed
+        template<typename T>
+        bool parseToken(const char* b, const char* e, unsigned char* dst) {
+            if (b < e && *b == '+')
+                ++b;
+            T v{};
+            auto [next, ec] = std::from_chars(b, e, v);
+            if (ec != std::errc() || next != e)
+                return false;
+            std::memcpy(dst, &v, sizeof(T));
+            return true;
+        }
+
+        // Type and byte offset of every scalar in a vertex
+        struct Column {
+            GLenum type;
+            std::size_t offset;
+        };
+
+        std::vector<Column> layoutColumns(const vertex_layout& layout) {
+            std::vector<Column> columns;
+            for (const auto& a : layout.attributes()) {
+                std::size_t size = vertex_layout::typeSize(a.type);
+                for (GLint c = 0; c < a.size; c++)
+                    columns.push_back({ a.type, a.offset + c * size });
+            }
+            return columns;
+        }
+
+        bool parseColumn(const Column& col, const char* b, const char* e, unsigned char* dst) {
+            switch (col.type) {
+            case GL_FLOAT:        return parseToken<float>(b, e, dst);
+            case GL_INT:          return parseToken<int>(b, e, dst);
+            case GL_UNSIGNED_INT: return parseToken<unsigned int>(b, e, dst);
+            case GL_DOUBLE:       return parseToken<double>(b, e, dst);
+            }
+            return false;
+        }
+
+        // Sections smaller than this are not worth splitting
+        constexpr std::size_t ParallelMinBytes = 1 << 20;
+        constexpr std::size_t ChunkMinBytes = 256 << 10;
+
+        // Part of a data range handled on its own; `first` is the index of
+        // its first token within the section, found by a prefix sum
+        struct TextChunk {
+            Section section;
+            const char* begin;
+            const char* end;
+            std::size_t tokens = 0;
+            std::size_t first = 0;
+        };
+
+        // Pool matching MeshParser::threadCount(), rebuilt when it changes.
+        // Callers hold a reference so a rebuild never pulls it from under them.
+        std::shared_ptr<ThreadPool> parserPool(unsigned threads) {
+            static std::mutex mutex;
+            static std::shared_ptr<ThreadPool> pool;
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!pool || pool->threadCount() != threads)
+                pool = std::make_shared<ThreadPool>(threads);
+            return pool;
+        }
+
+        // Splits ranges at line boundaries into roughly equal chunks
+        // (chunkBytes = 0 keeps one chunk per range)
+        std::vector<TextChunk> splitRanges(const std::vector<TextRange>& ranges, std::size_t chunkBytes) {
+            std::vector<TextChunk> chunks;
+            for (const auto& r : ranges) {
+                if (chunkBytes == 0) {
+                    chunks.push_back({ r.section, r.begin, r.end });
+                    continue;
+                }
+                const char* p = r.begin;
+                while (p < r.end) {
+                    const char* cut = r.end;
+                    if (static_cast<std::size_t>(r.end - p) > chunkBytes + chunkBytes / 2) {
+                        const char* nl = static_cast<const char*>(std::memchr(p + chunkBytes, '\n', r.end - (p + chunkBytes)));
+                        cut = nl ? nl + 1 : r.end;
+                    }
+                    chunks.push_back({ r.section, p, cut });
+                    p = cut;
+                }
+            }
+            return chunks;
+        }
+
+        // Validated pointers into a mapped `.mob` file
+        struct BinaryView {
+            const MeshBinaryHeader* header = nullptr;
+            const MeshBinaryAttribute* attributes = nullptr;
+            const char* metadata = nullptr;
+            const void* vertices = nullptr;
+            const void* indices = nullptr;
+        };
+
+        bool readBinaryView(const MappedFile& file, const std::string& path, BinaryView& view) {
+            auto fail = [&](const char* why) {
+                std::cerr << "Error: " << path << ": " << why << "\n";
+                return false;
+            };
+
+            const std::size_t size = file.size();
+            if (size < sizeof(MeshBinaryHeader))
+                return fail("truncated header");
+
+            view.header = reinterpret_cast<const MeshBinaryHeader*>(file.data());
+            const MeshBinaryHeader& h = *view.header;
+            if (std::memcmp(h.magic, MeshBinaryMagic, sizeof(h.magic)) != 0)
+                return fail("not a compiled mesh");
+            if (h.version != MeshBinaryVersion)
+                return fail("unsupported version");
+            if (h.indexType != GL_UNSIGNED_BYTE && h.indexType != GL_UNSIGNED_SHORT && h.indexType != GL_UNSIGNED_INT)
+                return fail("unsupported index type");
+
+            // Each range is checked as `offset > size || bytes > size - offset`
+            // so a corrupt header cannot wrap the sum past the check
+            if (h.attributeCount > (size - sizeof(MeshBinaryHeader)) / sizeof(MeshBinaryAttribute))
+                return fail("truncated layout");
+            const std::size_t attrEnd = sizeof(MeshBinaryHeader) + h.attributeCount * sizeof(MeshBinaryAttribute);
+            if (h.metadataBytes > size - attrEnd)
+                return fail("truncated layout");
+            if (h.vertexOffset % MeshBinaryAlignment != 0 || h.vertexOffset > size || h.vertexBytes > size - h.vertexOffset)
+                return fail("bad vertex blob");
+            if (h.indexOffset % MeshBinaryAlignment != 0 || h.indexOffset > size ||
+                h.indexCount > (size - h.indexOffset) / Mesh::indexSize(h.indexType))
+                return fail("bad index blob");
+
+            view.attributes = reinterpret_cast<const MeshBinaryAttribute*>(file.data() + sizeof(MeshBinaryHeader));
+            view.metadata = reinterpret_cast<const char*>(file.data() + attrEnd);
+            if (h.metadataBytes != 0 && view.metadata[h.metadataBytes - 1] != '\0')
+                return fail("unterminated metadata");
+            view.vertices = file.data() + h.vertexOffset;
+            view.indices = file.data() + h.indexOffset;
+            return true;
+        }
+
+        void readBinaryLayout(const BinaryView& view, vertex_layout& layout) {
+            for (std::uint32_t i = 0; i < view.header->attributeCount; i++) {
+                const auto& a = view.attributes[i];
+                layout.add(a.type, static_cast<GLint>(a.components), a.normalized != 0)
+                    .tag(static_cast<vertex_layout::semantic>(a.semantic));
+            }
+        }
+
+        template<typename F>
+        void readBinaryMetadata(const BinaryView& view, F&& onPair) {
+            const char* p = view.metadata;
+            const char* end = p + view.header->metadataBytes;
+            while (p < end) {
+                // Bounded by the block; readBinaryView made sure it ends in '\0'
+                const char* key = p;
+                p += strnlen(key, static_cast<std::size_t>(end - p)) + 1;
+                if (p >= end)
+                    break;
+                const char* val = p;
+                p += strnlen(val, static_cast<std::size_t>(end - p)) + 1;
+                onPair(key, val);
+            }
+        }
+
+        template<typename T>
+        void widenIndices(const void* src, std::size_t count, std::vector<unsigned int>& out) {
+            const T* p = static_cast<const T*>(src);
+            out.assign(p, p + count);
+        }
+
+        // "@key: true" style switches
+        bool isTrue(std::string_view val) {
+            return val == "true" || val == "1" || val == "yes";
+        }
+
+        bool metaFlag(const std::unordered_map<std::string, std::string>& metadata, const char* key) {
+            auto it = metadata.find(key);
+            return it != metadata.end() && isTrue(it->second);
+        }
+
+        // Magic and version only, without mapping the whole file
+        bool binaryVersionMatches(const std::string& path) {
+            MeshBinaryHeader h{};
+            std::ifstream in(path, std::ios::binary);
+            return in.read(reinterpret_cast<char*>(&h), sizeof(h)) &&
+                std::memcmp(h.magic, MeshBinaryMagic, sizeof(h.magic)) == 0 && h.version == MeshBinaryVersion;
+        }
+
+        // `path`, or its compiled `.mob` sibling when that is up to date
+        // and written in the current format
+        std::string resolveSource(const std::string& path, bool& binary) {
+            namespace fs = std::filesystem;
+            std::error_code ec;
+
+            binary = fs::path(path).extension() == ".mob";
+            if (!binary) {
+                std::string bin = MeshParser::binaryPath(path);
+                const bool hasSource = fs::exists(path, ec);
+                if (fs::exists(bin, ec) &&
+                    (!hasSource || (fs::last_write_time(bin, ec) >= fs::last_write_time(path, ec) && binaryVersionMatches(bin)))) {
+                    binary = true;
+                    return bin;
+                }
+            }
+            return path;
+        }
+    }
+
+    const vertex_layout::Attribute* MeshData::positionAttribute() const {
+        return layout.position();
+    }
+
+    bounds MeshData::bounds() const {
+        return gl::bounds::of(vertices.data(), vertices.size(), layout);
+    }
+
+    unsigned MeshParser::s_threads = 0;
+
+    void MeshParser::setThreadCount(unsigned threads) {
+        s_threads = threads;
+    }
+
+    unsigned MeshParser::threadCount() {
+        if (s_threads != 0)
+            return s_threads;
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::string MeshParser::binaryPath(const std::string& path) {
+        return std::filesystem::path(path).replace_extension(".mob").string();
+    }
+
+    Mesh MeshParser::loadModel(const std::string& path, const MeshLoadOptions& options) {  
+      bool binary;
+      std::string source = resolveSource(path, binary);
+
+      // Metadata driven steps were already applied by mo2bin
+      if (binary && !options.weld && !options.optimize && !options.quantize && !options.report)
+        return loadBinary(source, options);
+
       gl::Mesh mo;
       gl::MeshData md;
-      if(!parseFile(path, md)) {
+      if(!(binary ? parseBinary(source, md) : parseFile(source, md))) {
         throw std::runtime_error("Could not load model: " + path);
       }
-      mo.upload(md);
+
+      MeshMemory before = MeshMemory::of(md);
+      process(md, options, path);
+      if (options.report)
+        MeshQuantizer::report(std::cout, path, before, MeshMemory::of(md));
+
+      mo.upload(md, options.splitIndices || metaFlag(md.metadata, "split_indices"));
       return mo;
     }
 
+    Model MeshParser::loadLodModel(const std::string& path, const MeshLoadOptions& options) {
+      bool binary;
+      std::string source = resolveSource(path, binary);
+
+      MeshData md;
+      if (!(binary ? parseBinary(source, md) : parseFile(source, md))) {
+        throw std::runtime_error("Could not load model: " + path);
+      }
+
+      MeshMemory before = MeshMemory::of(md);
+      process(md, options, path);
+      if (options.report)
+        MeshQuantizer::report(std::cout, path, before, MeshMemory::of(md));
+
+      unsigned levels = options.lods;
+      auto lodsMeta = md.metadata.find("lods");
+      if (levels == 0 && lodsMeta != md.metadata.end()) {
+        const std::string& val = lodsMeta->second;
+        std::from_chars(val.data(), val.data() + val.size(), levels);
+      }
+
+      bool split = options.splitIndices || metaFlag(md.metadata, "split_indices");
+      Model model;
+      model.upload(md, split);
+
+      const vertex_layout::Attribute* posAttr = md.positionAttribute();
+      if (levels == 0 || !posAttr)
+        return model;
+
+      auto start = std::chrono::steady_clock::now();
+      std::vector<MeshSimplifier::Level> lods = MeshSimplifier::buildLods(md, levels);
+      bool optimize = options.optimize || metaFlag(md.metadata, "optimize");
+
+      std::vector<Mesh> meshes;
+      std::vector<float> errors;
+      for (auto& level : lods) {
+        if (optimize)
+          MeshOptimizer::optimize(level.data);
+        meshes.emplace_back();
+        meshes.back().upload(level.data, split);
+        errors.push_back(level.error);
+      }
+      if (options.report)
+        MeshSimplifier::report(std::cout, path, md, lods,
+          std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+      model.setLods(std::move(meshes), errors);
+      return model;
+    }
+
+    bool MeshParser::process(MeshData& data, const MeshLoadOptions& options, const std::string& name) {
+      bool changed = false;
+
+      // "@weld" is a switch or a list of epsilons (see MeshWelder)
+      std::vector<float> epsilon{ options.weldEpsilon };
+      bool weld = options.weld;
+      auto weldMeta = data.metadata.find("weld");
+      if (!weld && weldMeta != data.metadata.end()) {
+        const std::string& val = weldMeta->second;
+        bool off = val == "false" || val == "0" || val == "no";
+        weld = !off && MeshWelder::parseEpsilon(val, epsilon);
+        if (!off && !weld)
+          std::cerr << "Warning: " << name << ": bad @weld value \"" << val << "\"\n";
+      }
+      if (weld) {
+        MeshWelder::Result result;
+        if (MeshWelder::weld(data, epsilon, &result)) {
+          changed = true;
+          if (options.report)
+            MeshWelder::report(std::cout, name, result);
+        }
+      }
+
+      if (options.optimize || metaFlag(data.metadata, "optimize")) {
+        MeshOptimizer::Result result;
+        if (MeshOptimizer::optimize(data, &result)) {
+          changed = true;
+          if (options.report)
+            MeshOptimizer::report(std::cout, name, result);
+        }
+      }
+      if (options.quantize || metaFlag(data.metadata, "quantize"))
+        changed |= MeshQuantizer::quantize(data);
+      return changed;
+    }
+
     bool MeshParser::parseFile(const std::string& path, MeshData& out) {
-        std::ifstream file(path);
-        if (!file) {
-            std::cerr << "Error: cannot open " << path << "\n";
+        std::error_code ec;
+        if (std::filesystem::is_regular_file(path, ec) && std::filesystem::file_size(path, ec) == 0)
+            return true;
+
+        MappedFile file;
+        if (!file.open(path))
             return false;
-        }
 
-        enum Section { NONE, VERTEX, INDEX };
+        return parseBuffer({ reinterpret_cast<const char*>(file.data()), file.size() }, out);
+    }
+
+    bool MeshParser::parseBuffer(std::string_view text, MeshData& out) {
+        // First pass: find section headers, metadata and the ranges of
+        // data lines between them
+        std::vector<TextRange> ranges;
         Section section = NONE;
         bool headerParsed = false;
-        std::string line;
-
-        auto trim = [](std::string& s) {
-            while (!s.empty() && std::isspace((unsigned char)s.back()))
-                s.pop_back();
-            size_t start = 0;
-            while (start < s.size() && std::isspace((unsigned char)s[start]))
-                ++start;
-            s = s.substr(start);
-            };
 
-        while (std::getline(file, line)) {
-            // Remove comments
-            auto hash = line.find('#');
-            if (hash != std::string::npos)
-                line = line.substr(0, hash);
+        const char* p = text.data();
+        const char* end = p + text.size();
+        while (p < end) {
+            const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            const char* lineEnd = nl ? nl : end;
+            std::string_view line = trimLine(p, lineEnd);
+            const char* lineStart = p;
+            p = nl ? nl + 1 : end;
 
-            trim(line);
             if (line.empty())
                 continue;
 
             // Metadata: @key:value
             if (line[0] == '@') {
                 auto colon = line.find(':');
-                if (colon != std::string::npos) {
-                    std::string key = line.substr(1, colon - 1);
-                    std::string val = line.substr(colon + 1);
-                    trim(key);
-                    trim(val);
-                    out.metadata[key] = val;
+                if (colon != std::string_view::npos) {
+                    std::string_view key = trimView(line.substr(1, colon - 1));
+                    std::string_view val = trimView(line.substr(colon + 1));
+                    out.metadata[std::string(key)] = std::string(val);
                 }
                 continue;
             }
@@ -71,51 +507,221 @@ namespace gl {
                 continue;
             }
 
-            // Read vertex section
-            if (section == VERTEX) {
+            if (section == VERTEX && !headerParsed) {
                 // First line in vertex section defines layout
-                if (!headerParsed) {
-                    std::istringstream ss(line);
-                    std::string token;
-                    while (ss >> token) {
-                        if (token.rfind("float", 0) == 0) {
-                            int comps = std::stoi(token.substr(token.find('(') + 1));
-                            out.layout.add<float>(comps);
-                        }
-                        else if (token.rfind("int", 0) == 0) {
-                            int comps = std::stoi(token.substr(token.find('(') + 1));
-                            out.layout.add<int>(comps);
-                        }
-                        else if (token.rfind("uint", 0) == 0) {
-                            int comps = std::stoi(token.substr(token.find('(') + 1));
-                            out.layout.add<unsigned int>(comps);
-                        }
-                        else if (token.rfind("double", 0) == 0) {
-                            int comps = std::stoi(token.substr(token.find('(') + 1));
-                            out.layout.add<double>(comps);
-                        }
-                    }
-                    headerParsed = true;
-                    continue;
-                }
-
-                // Vertex data lines
-                std::istringstream ss(line);
-                float val;
-                while (ss >> val)
-                    out.vertices.push_back(val);
+                readLayout(line, out.layout);
+                headerParsed = true;
+                continue;
             }
 
-            // Read index section
-            else if (section == INDEX) {
-                std::istringstream ss(line);
-                unsigned int idx;
-                while (ss >> idx)
-                    out.indices.push_back(idx);
+            if (section == NONE)
+                continue;
+
+            // Extend the current range while data lines are contiguous
+            if (!ranges.empty() && ranges.back().section == section && ranges.back().end == lineStart)
+                ranges.back().end = p;
+            else
+                ranges.push_back({ section, lineStart, p });
+        }
+
+        std::size_t dataBytes = 0;
+        for (const auto& r : ranges)
+            dataBytes += r.end - r.begin;
+
+        // Large inputs are split into chunks handled in parallel; small
+        // ones run the same steps serially with one chunk per range
+        unsigned threads = threadCount();
+        bool parallel = threads > 1 && dataBytes >= ParallelMinBytes;
+        std::size_t chunkBytes = parallel ? std::max(ChunkMinBytes, dataBytes / (threads * 4)) : 0;
+        std::vector<TextChunk> chunks = splitRanges(ranges, chunkBytes);
+
+        std::shared_ptr<ThreadPool> pool = parallel ? parserPool(threads) : nullptr;
+        auto forEachChunk = [&](const std::function<void(std::size_t)>& fn) {
+            if (pool)
+                pool->parallelFor(chunks.size(), fn);
+            else
+                for (std::size_t i = 0; i < chunks.size(); i++) fn(i);
+        };
+
+        // Second pass: count tokens, so every chunk knows where its
+        // values land and the outputs are sized exactly once
+        forEachChunk([&](std::size_t i) {
+            chunks[i].tokens = countTokens(chunks[i].begin, chunks[i].end);
+        });
+
+        std::size_t vertexTokens = 0, indexTokens = 0;
+        for (auto& c : chunks) {
+            std::size_t& total = c.section == VERTEX ? vertexTokens : indexTokens;
+            c.first = total;
+            total += c.tokens;
+        }
+
+        const std::vector<Column> columns = layoutColumns(out.layout);
+        const std::size_t stride = out.layout.stride();
+        std::size_t vertexCount = columns.empty() ? 0 : vertexTokens / columns.size();
+        if (columns.empty() ? vertexTokens != 0 : vertexTokens % columns.size() != 0)
+            std::cerr << "Warning: vertex data does not fill a whole number of vertices\n";
+
+        std::size_t vertexBase = out.vertices.size();
+        std::size_t indexBase = out.indices.size();
+        out.vertices.resize(vertexBase + vertexCount * stride);
+        out.indices.resize(indexBase + indexTokens);
+
+        // Third pass: parse every value with its column's type straight
+        // into place, so the byte layout matches the declared stride
+        std::atomic<std::size_t> malformed{ 0 };
+        forEachChunk([&](std::size_t i) {
+            const TextChunk& c = chunks[i];
+            std::size_t bad = 0;
+
+            if (c.section == VERTEX) {
+                if (columns.empty())
+                    return;
+                unsigned char* base = out.vertices.data() + vertexBase;
+                std::size_t col = c.first % columns.size();
+                std::size_t vtx = c.first / columns.size();
+                forEachToken(c.begin, c.end, [&](const char* b, const char* e) {
+                    if (vtx >= vertexCount)
+                        return;
+                    unsigned char* dst = base + vtx * stride + columns[col].offset;
+                    if (!parseColumn(columns[col], b, e, dst)) {
+                        std::memset(dst, 0, vertex_layout::typeSize(columns[col].type));
+                        bad++;
+                    }
+                    if (++col == columns.size()) {
+                        col = 0;
+                        vtx++;
+                    }
+                });
             }
+            else {
+                unsigned int* dst = out.indices.data() + indexBase + c.first;
+                forEachToken(c.begin, c.end, [&](const char* b, const char* e) {
+                    if (!parseToken<unsigned int>(b, e, reinterpret_cast<unsigned char*>(dst))) {
+                        *dst = 0;
+                        bad++;
+                    }
+                    dst++;
+                });
+            }
+            malformed += bad;
+        });
+
+        if (malformed > 0)
+            std::cerr << "Warning: " << malformed << " malformed values read as 0\n";
+
+        return true;
+    }
+
+    Mesh MeshParser::loadBinary(const std::string& path, const MeshLoadOptions& options) {
+        MappedFile file;
+        BinaryView view;
+        if (!file.open(path) || !readBinaryView(file, path, view)) {
+            throw std::runtime_error("Could not load model: " + path);
         }
 
+        vertex_layout layout;
+        readBinaryLayout(view, layout);
+
+        Mesh mo;
+        bool split = options.splitIndices;
+        readBinaryMetadata(view, [&](const char* key, const char* val) {
+            mo.setMeta(key, val);
+            if (std::strcmp(key, "split_indices") == 0)
+                split |= isTrue(val);
+        });
+
+        // Zero-copy: GL reads straight out of the mapping. Only 32-bit
+        // indices that are to be split go through a narrowing copy.
+        const MeshBinaryHeader& h = *view.header;
+        if (h.indexType == GL_UNSIGNED_INT && split)
+            mo.upload(view.vertices, h.vertexBytes, static_cast<const unsigned int*>(view.indices),
+                h.indexCount, layout, true);
+        else
+            mo.upload(view.vertices, h.vertexBytes, view.indices, h.indexCount, h.indexType, layout);
+        return mo;
+    }
+
+    bool MeshParser::parseBinary(const std::string& path, MeshData& out) {
+        MappedFile file;
+        BinaryView view;
+        if (!file.open(path) || !readBinaryView(file, path, view))
+            return false;
+
+        readBinaryLayout(view, out.layout);
+        readBinaryMetadata(view, [&](const char* key, const char* val) {
+            out.metadata[key] = val;
+        });
+
+        const auto* v = static_cast<const unsigned char*>(view.vertices);
+        out.vertices.assign(v, v + view.header->vertexBytes);
+        switch (view.header->indexType) {
+        case GL_UNSIGNED_BYTE:  widenIndices<std::uint8_t>(view.indices, view.header->indexCount, out.indices); break;
+        case GL_UNSIGNED_SHORT: widenIndices<std::uint16_t>(view.indices, view.header->indexCount, out.indices); break;
+        default:                widenIndices<std::uint32_t>(view.indices, view.header->indexCount, out.indices); break;
+        }
         return true;
     }
 
+    bool MeshParser::writeBinary(const MeshData& data, const std::string& path) {
+        auto align = [](std::uint64_t n) {
+            return (n + MeshBinaryAlignment - 1) / MeshBinaryAlignment * MeshBinaryAlignment;
+        };
+
+        std::string meta;
+        for (const auto& [key, val] : data.metadata) {
+            meta.append(key).push_back('\0');
+            meta.append(val).push_back('\0');
+        }
+
+        const auto& attrs = data.layout.attributes();
+
+        MeshBinaryHeader h{};
+        std::memcpy(h.magic, MeshBinaryMagic, sizeof(h.magic));
+        h.version = MeshBinaryVersion;
+        h.attributeCount = static_cast<std::uint32_t>(attrs.size());
+        h.metadataBytes = static_cast<std::uint32_t>(meta.size());
+        h.vertexBytes = data.vertices.size();
+        h.vertexOffset = align(sizeof(h) + attrs.size() * sizeof(MeshBinaryAttribute) + meta.size());
+        h.indexCount = data.indices.size();
+        h.indexOffset = align(h.vertexOffset + h.vertexBytes);
+        unsigned int maxIndex = data.indices.empty() ? 0 : *std::max_element(data.indices.begin(), data.indices.end());
+        h.indexType = Mesh::indexTypeFor(maxIndex);
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "Error: cannot write " << path << "\n";
+            return false;
+        }
+
+        auto pad = [&](std::uint64_t to) {
+            static const char zeros[MeshBinaryAlignment] = {};
+            std::uint64_t at = static_cast<std::uint64_t>(file.tellp());
+            file.write(zeros, static_cast<std::streamsize>(to - at));
+        };
+
+        file.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        for (const auto& a : attrs) {
+            MeshBinaryAttribute ba{ a.type, static_cast<std::uint32_t>(a.size), a.normalized ? 1u : 0u,
+                static_cast<std::uint32_t>(a.meaning) };
+            file.write(reinterpret_cast<const char*>(&ba), sizeof(ba));
+        }
+        file.write(meta.data(), static_cast<std::streamsize>(meta.size()));
+
+        pad(h.vertexOffset);
+        file.write(reinterpret_cast<const char*>(data.vertices.data()), static_cast<std::streamsize>(h.vertexBytes));
+        pad(h.indexOffset);
+        if (h.indexType == GL_UNSIGNED_SHORT) {
+            std::vector<std::uint16_t> narrow(data.indices.begin(), data.indices.end());
+            file.write(reinterpret_cast<const char*>(narrow.data()),
+                static_cast<std::streamsize>(narrow.size() * sizeof(std::uint16_t)));
+        }
+        else {
+            file.write(reinterpret_cast<const char*>(data.indices.data()),
+                static_cast<std::streamsize>(data.indices.size() * sizeof(unsigned int)));
+        }
+
+        return static_cast<bool>(file);
+    }
+
 }
@@ -1,24 +1,85 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include "vertex_layout.hpp"
 #include "Mesh.hpp"
+#include "bounds.hpp"
 
 namespace gl {
 
+    class Model;
+
     struct MeshData {
-        std::vector<float> vertices;
+        // Interleaved vertex bytes, each attribute stored as its layout type
+        std::vector<unsigned char> vertices;
         std::vector<unsigned int> indices;
         vertex_layout layout;
         std::unordered_map<std::string, std::string> metadata;
+
+        std::size_t vertexCount() const {
+            return layout.stride() ? vertices.size() / layout.stride() : 0;
+        }
+
+        // Float xyz positions: the attribute tagged position, else the
+        // first attribute by convention. nullptr if that is not float(3+).
+        const vertex_layout::Attribute* positionAttribute() const;
+
+        // Box and sphere around the positions (empty without positions)
+        gl::bounds bounds() const;
+    };
+
+    // Import steps for MeshParser::loadModel. Each one can also be turned
+    // on by a mesh itself through metadata, e.g. "@quantize: true".
+    struct MeshLoadOptions {
+        bool weld = false;      // merge duplicate vertices, index soup (MeshWelder, "@weld")
+        float weldEpsilon = 0.0f; // float attribute tolerance, 0 = exact
+        bool optimize = false;  // reorder for vertex cache/overdraw/fetch (MeshOptimizer)
+        bool quantize = false;  // compact colors/normals/uvs (MeshQuantizer)
+        bool report = false;    // print vertex/index memory and cache stats per mesh
+        unsigned lods = 0;      // coarser levels built by loadLodModel ("@lods")
+        bool splitIndices = false; // 16-bit submeshes past 65536 vertices ("@split_indices")
     };
 
     class MeshParser {
     public:
         static bool parseFile(const std::string& path, MeshData& out);
 
-        static Mesh loadModel(const std::string& path);
+        // Parses `.mo` text already in memory (parseFile maps the file)
+        static bool parseBuffer(std::string_view text, MeshData& out);
+
+        // Loads `path`, preferring its compiled `.mob` sibling when that
+        // exists and is not older than the text file. Binaries with no
+        // import steps left to run are uploaded zero-copy.
+        static Mesh loadModel(const std::string& path, const MeshLoadOptions& options = {});
+
+        // Like loadModel, plus a chain of simplified levels (MeshSimplifier)
+        // for Model::selectLod. Always parses, never zero-copy.
+        static Model loadLodModel(const std::string& path, const MeshLoadOptions& options = {});
+
+        // Runs the import steps asked for by `options` or the metadata;
+        // returns true if the data changed. `name` labels the report.
+        static bool process(MeshData& data, const MeshLoadOptions& options = {},
+            const std::string& name = "");
+
+        // Compiled binary meshes (see MeshBinary.hpp). Indices are stored
+        // in the narrowest type that holds them and widened by parseBinary.
+        static bool writeBinary(const MeshData& data, const std::string& path);
+        static bool parseBinary(const std::string& path, MeshData& out);
+        static Mesh loadBinary(const std::string& path, const MeshLoadOptions& options = {});
+
+        // "models/cube.mo" -> "models/cube.mob"
+        static std::string binaryPath(const std::string& path);
+
+        // Threads used to parse large `:vertex`/`:index` sections
+        // (0 = one per hardware thread, 1 = serial). Output is identical
+        // for every setting.
+        static void setThreadCount(unsigned threads);
+        static unsigned threadCount();
+
+    private:
+        static unsigned s_threads;
     };
 
 }
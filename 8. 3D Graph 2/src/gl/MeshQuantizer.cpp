@@ -0,0 +1,144 @@
+#include "MeshQuantizer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace gl {
+
+    MeshMemory MeshMemory::of(const MeshData& data) {
+        MeshMemory m;
+        m.vertexCount = data.vertexCount();
+        m.stride = data.layout.stride();
+        m.vertexBytes = data.vertices.size();
+        unsigned int maxIndex = data.indices.empty() ? 0 : *std::max_element(data.indices.begin(), data.indices.end());
+        m.indexBytes = data.indices.size() * Mesh::indexSize(Mesh::indexTypeFor(maxIndex));
+        return m;
+    }
+
+    namespace {
+        enum class Encoding { Copy, Unorm8, Snorm2_10_10_10, Half };
+
+        struct Step {
+            vertex_layout::Attribute src;
+            Encoding encoding;
+            GLint components; // components written, including padding
+        };
+
+        // Colors only quantize when every component fits unorm
+        bool inUnitRange(const MeshData& data, const vertex_layout::Attribute& a) {
+            const std::size_t stride = data.layout.stride();
+            const std::size_t count = data.vertexCount();
+            for (std::size_t v = 0; v < count; v++) {
+                const unsigned char* p = data.vertices.data() + v * stride + a.offset;
+                for (GLint c = 0; c < a.size; c++) {
+                    float f;
+                    std::memcpy(&f, p + c * sizeof(float), sizeof(float));
+                    if (!(f >= 0.0f && f <= 1.0f))
+                        return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    bool MeshQuantizer::quantize(MeshData& data) {
+        using semantic = vertex_layout::semantic;
+
+        std::vector<Step> steps;
+        vertex_layout layout;
+        bool changed = false;
+
+        for (const auto& a : data.layout.attributes()) {
+            Step step{ a, Encoding::Copy, a.size };
+
+            if (a.type == GL_FLOAT && !a.normalized) {
+                if (a.meaning == semantic::color && (a.size == 3 || a.size == 4) && inUnitRange(data, a)) {
+                    step.encoding = Encoding::Unorm8;
+                    step.components = 4;
+                }
+                else if (a.meaning == semantic::normal && a.size == 3) {
+                    step.encoding = Encoding::Snorm2_10_10_10;
+                    step.components = 4;
+                }
+                else if (a.meaning == semantic::uv) {
+                    step.encoding = Encoding::Half;
+                    step.components = (a.size + 1) & ~1; // keep 4-byte alignment
+                }
+            }
+
+            switch (step.encoding) {
+            case Encoding::Copy:            layout.add(a.type, a.size, a.normalized); break;
+            case Encoding::Unorm8:          layout.add<unsigned char>(4, true); break;
+            case Encoding::Snorm2_10_10_10: layout.add<packed_2_10_10_10>(4, true); break;
+            case Encoding::Half:            layout.add<half>(step.components); break;
+            }
+            layout.tag(a.meaning);
+
+            changed |= step.encoding != Encoding::Copy;
+            steps.push_back(step);
+        }
+
+        if (!changed)
+            return false;
+
+        const std::size_t count = data.vertexCount();
+        const std::size_t oldStride = data.layout.stride();
+        const std::size_t newStride = layout.stride();
+        const auto& dstAttrs = layout.attributes();
+
+        std::vector<unsigned char> out(count * newStride, 0);
+        for (std::size_t v = 0; v < count; v++) {
+            const unsigned char* srcVertex = data.vertices.data() + v * oldStride;
+            unsigned char* dstVertex = out.data() + v * newStride;
+
+            for (std::size_t i = 0; i < steps.size(); i++) {
+                const Step& s = steps[i];
+                const unsigned char* src = srcVertex + s.src.offset;
+                unsigned char* dst = dstVertex + dstAttrs[i].offset;
+
+                float f[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+                if (s.encoding == Encoding::Unorm8 || s.encoding == Encoding::Snorm2_10_10_10)
+                    std::memcpy(f, src, s.src.size * sizeof(float));
+
+                switch (s.encoding) {
+                case Encoding::Copy:
+                    std::memcpy(dst, src, vertex_layout::attributeSize(s.src.type, s.src.size));
+                    break;
+                case Encoding::Unorm8:
+                    for (int c = 0; c < 4; c++)
+                        dst[c] = packUnorm8(f[c]);
+                    break;
+                case Encoding::Snorm2_10_10_10: {
+                    packed_2_10_10_10 n = packSnorm2_10_10_10(f[0], f[1], f[2]);
+                    std::memcpy(dst, &n, sizeof(n));
+                    break;
+                }
+                case Encoding::Half:
+                    for (GLint c = 0; c < s.src.size; c++) {
+                        float value;
+                        std::memcpy(&value, src + c * sizeof(float), sizeof(float));
+                        half h = toHalf(value);
+                        std::memcpy(dst + c * sizeof(half), &h, sizeof(h));
+                    }
+                    break;
+                }
+            }
+        }
+
+        data.vertices.swap(out);
+        data.layout = layout;
+        return true;
+    }
+
+    void MeshQuantizer::report(std::ostream& os, const std::string& name,
+        const MeshMemory& before, const MeshMemory& after) {
+        double ratio = before.total() ? 100.0 * after.total() / before.total() : 100.0;
+        os << "[mesh] " << name << ": " << after.vertexCount << " vertices, "
+            << "stride " << before.stride << " -> " << after.stride << " B, "
+            << "vertices " << before.vertexBytes << " -> " << after.vertexBytes << " B, "
+            << "indices " << before.indexBytes << " -> " << after.indexBytes << " B "
+            << "(" << static_cast<int>(ratio + 0.5) << "%)\n";
+    }
+
+}
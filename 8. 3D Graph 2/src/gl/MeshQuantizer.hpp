@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+#include "MeshParser.hpp"
+
+namespace gl {
+
+    // Vertex and index memory of a mesh
+    struct MeshMemory {
+        std::size_t vertexCount = 0;
+        std::size_t stride = 0;
+        std::size_t vertexBytes = 0;
+        std::size_t indexBytes = 0;
+
+        std::size_t total() const { return vertexBytes + indexBytes; }
+
+        static MeshMemory of(const MeshData& data);
+    };
+
+    /**
+     * @brief Converts tagged float attributes to compact vertex formats.
+     *
+     *   color  (3-4 floats in [0, 1]) -> 4 x unorm8
+     *   normal (3 floats)             -> snorm 2_10_10_10
+     *   uv     (floats)               -> half floats
+     *
+     * Positions and untagged attributes are kept as they are. Every
+     * attribute stays 4-byte aligned.
+     */
+    class MeshQuantizer {
+    public:
+        // Returns false when nothing could be compacted
+        static bool quantize(MeshData& data);
+
+        static void report(std::ostream& os, const std::string& name,
+            const MeshMemory& before, const MeshMemory& after);
+    };
+
+}
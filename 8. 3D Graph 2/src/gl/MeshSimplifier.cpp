@@ -0,0 +1,318 @@
+#include "MeshSimplifier.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace gl {
+
+    namespace {
+        struct Vec3 {
+            double x, y, z;
+        };
+
+        Vec3 operator-(const Vec3& a, const Vec3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+        Vec3 cross(const Vec3& a, const Vec3& b) { return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x }; }
+        double dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+        // Symmetric 4x4 plane quadric plus the area it was built from
+        struct Quadric {
+            double xx = 0, xy = 0, xz = 0, xw = 0, yy = 0, yz = 0, yw = 0, zz = 0, zw = 0, ww = 0;
+            double weight = 0;
+
+            void addPlane(const Vec3& n, double d, double w) {
+                xx += w * n.x * n.x; xy += w * n.x * n.y; xz += w * n.x * n.z; xw += w * n.x * d;
+                yy += w * n.y * n.y; yz += w * n.y * n.z; yw += w * n.y * d;
+                zz += w * n.z * n.z; zw += w * n.z * d;
+                ww += w * d * d;
+                weight += w;
+            }
+
+            Quadric& operator+=(const Quadric& q) {
+                xx += q.xx; xy += q.xy; xz += q.xz; xw += q.xw;
+                yy += q.yy; yz += q.yz; yw += q.yw;
+                zz += q.zz; zw += q.zw; ww += q.ww;
+                weight += q.weight;
+                return *this;
+            }
+
+            // Area weighted squared distance of p to the planes
+            double evaluate(const Vec3& p) const {
+                double r = xx * p.x * p.x + 2 * xy * p.x * p.y + 2 * xz * p.x * p.z + 2 * xw * p.x
+                    + yy * p.y * p.y + 2 * yz * p.y * p.z + 2 * yw * p.y
+                    + zz * p.z * p.z + 2 * zw * p.z + ww;
+                return r > 0 ? r : 0;
+            }
+        };
+
+        // Distance-like error of moving to p, in position units
+        double collapseError(const Quadric& a, const Quadric& b, const Vec3& p) {
+            double weight = a.weight + b.weight;
+            return weight > 0 ? std::sqrt((a.evaluate(p) + b.evaluate(p)) / weight) : 0.0;
+        }
+
+        struct Collapse {
+            double error;
+            unsigned int from, to;
+        };
+
+        std::uint64_t edgeKey(unsigned int a, unsigned int b) {
+            return a < b ? (std::uint64_t(a) << 32) | b : (std::uint64_t(b) << 32) | a;
+        }
+    }
+
+    bool MeshSimplifier::simplify(const MeshData& in, MeshData& out, std::size_t targetTriangles,
+        float maxError, Result* result) {
+        auto start = std::chrono::steady_clock::now();
+
+        const vertex_layout::Attribute* posAttr = in.positionAttribute();
+        const std::size_t vertexCount = in.vertexCount();
+        const std::size_t stride = in.layout.stride();
+        if (!posAttr || in.indices.empty() || in.indices.size() % 3 != 0)
+            return false;
+
+        std::vector<Vec3> pos(vertexCount);
+        for (std::size_t v = 0; v < vertexCount; v++) {
+            float f[3];
+            std::memcpy(f, in.vertices.data() + v * stride + posAttr->offset, sizeof(f));
+            pos[v] = { f[0], f[1], f[2] };
+        }
+
+        std::vector<unsigned int> idx = in.indices;
+        const std::size_t trianglesBefore = idx.size() / 3;
+
+        // Vertices sharing a position with another one sit on a seam
+        std::vector<unsigned int> canon(vertexCount);
+        std::vector<bool> locked(vertexCount, false);
+        {
+            std::vector<unsigned int> order(vertexCount);
+            for (std::size_t v = 0; v < vertexCount; v++)
+                order[v] = static_cast<unsigned int>(v);
+            auto less = [&](unsigned int a, unsigned int b) {
+                const Vec3& p = pos[a];
+                const Vec3& q = pos[b];
+                return p.x != q.x ? p.x < q.x : p.y != q.y ? p.y < q.y : p.z < q.z;
+            };
+            std::sort(order.begin(), order.end(), less);
+            for (std::size_t i = 0; i < vertexCount;) {
+                std::size_t j = i + 1;
+                while (j < vertexCount && !less(order[i], order[j]))
+                    j++;
+                for (std::size_t k = i; k < j; k++) {
+                    canon[order[k]] = order[i];
+                    locked[order[k]] = j - i > 1;
+                }
+                i = j;
+            }
+        }
+
+        // Edges used by a single triangle are open borders
+        {
+            std::vector<std::uint64_t> edges;
+            edges.reserve(idx.size());
+            for (std::size_t t = 0; t < idx.size(); t += 3)
+                for (int e = 0; e < 3; e++)
+                    edges.push_back(edgeKey(canon[idx[t + e]], canon[idx[t + (e + 1) % 3]]));
+            std::sort(edges.begin(), edges.end());
+
+            std::vector<bool> borderCanon(vertexCount, false);
+            for (std::size_t i = 0; i < edges.size();) {
+                std::size_t j = i + 1;
+                while (j < edges.size() && edges[j] == edges[i])
+                    j++;
+                if (j - i == 1) {
+                    borderCanon[edges[i] >> 32] = true;
+                    borderCanon[edges[i] & 0xFFFFFFFFu] = true;
+                }
+                i = j;
+            }
+            for (std::size_t v = 0; v < vertexCount; v++)
+                if (borderCanon[canon[v]])
+                    locked[v] = true;
+        }
+
+        std::vector<Quadric> quadrics(vertexCount);
+        for (std::size_t t = 0; t < idx.size(); t += 3) {
+            const Vec3& a = pos[idx[t]];
+            const Vec3& b = pos[idx[t + 1]];
+            const Vec3& c = pos[idx[t + 2]];
+            Vec3 n = cross(b - a, c - a);
+            double len = std::sqrt(dot(n, n));
+            if (len <= 0)
+                continue;
+            n = { n.x / len, n.y / len, n.z / len };
+            double area = len * 0.5;
+            for (int k = 0; k < 3; k++)
+                quadrics[idx[t + k]].addPlane(n, -dot(n, a), area);
+        }
+
+        std::vector<unsigned int> remap(vertexCount);
+        std::vector<bool> touched(vertexCount);
+        std::vector<unsigned int> adjOffsets(vertexCount + 1), adjTriangles;
+        std::vector<Collapse> collapses;
+        double worst = 0.0;
+
+        // Each pass collapses the cheapest edges whose neighbourhoods do
+        // not overlap, then rebuilds everything from the new triangles
+        while (idx.size() / 3 > targetTriangles) {
+            const std::size_t triangles = idx.size() / 3;
+
+            std::fill(adjOffsets.begin(), adjOffsets.end(), 0);
+            for (unsigned int v : idx)
+                adjOffsets[v + 1]++;
+            for (std::size_t v = 0; v < vertexCount; v++)
+                adjOffsets[v + 1] += adjOffsets[v];
+            adjTriangles.resize(idx.size());
+            {
+                std::vector<unsigned int> fill(adjOffsets.begin(), adjOffsets.end() - 1);
+                for (std::size_t i = 0; i < idx.size(); i++)
+                    adjTriangles[fill[idx[i]]++] = static_cast<unsigned int>(i / 3);
+            }
+
+            collapses.clear();
+            for (std::size_t t = 0; t < idx.size(); t += 3) {
+                for (int e = 0; e < 3; e++) {
+                    unsigned int a = idx[t + e], b = idx[t + (e + 1) % 3];
+                    if (!locked[a])
+                        collapses.push_back({ collapseError(quadrics[a], quadrics[b], pos[b]), a, b });
+                    if (!locked[b])
+                        collapses.push_back({ collapseError(quadrics[a], quadrics[b], pos[a]), b, a });
+                }
+            }
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse& x, const Collapse& y) {
+                return x.error < y.error;
+            });
+
+            for (std::size_t v = 0; v < vertexCount; v++)
+                remap[v] = static_cast<unsigned int>(v);
+            std::fill(touched.begin(), touched.end(), false);
+
+            std::size_t removed = 0;
+            std::size_t applied = 0;
+            for (const Collapse& c : collapses) {
+                if (triangles - removed <= targetTriangles || c.error > maxError)
+                    break;
+                if (touched[c.from] || touched[c.to])
+                    continue;
+
+                // Reject collapses that fold a remaining triangle over
+                bool flips = false;
+                std::size_t shared = 0;
+                for (unsigned int k = adjOffsets[c.from]; k < adjOffsets[c.from + 1] && !flips; k++) {
+                    const unsigned int* tri = &idx[adjTriangles[k] * 3];
+                    if (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to) {
+                        shared++;
+                        continue;
+                    }
+                    Vec3 p[3], q[3];
+                    for (int i = 0; i < 3; i++) {
+                        if (remap[tri[i]] != tri[i])
+                            flips = true; // neighbour collapsed earlier this pass
+                        p[i] = pos[tri[i]];
+                        q[i] = tri[i] == c.from ? pos[c.to] : p[i];
+                    }
+                    Vec3 before = cross(p[1] - p[0], p[2] - p[0]);
+                    Vec3 after = cross(q[1] - q[0], q[2] - q[0]);
+                    if (dot(before, after) <= 0)
+                        flips = true;
+                }
+                if (flips)
+                    continue;
+
+                remap[c.from] = c.to;
+                quadrics[c.to] += quadrics[c.from];
+                worst = std::max(worst, c.error);
+                removed += shared;
+                applied++;
+
+                for (unsigned int k = adjOffsets[c.from]; k < adjOffsets[c.from + 1]; k++)
+                    for (int i = 0; i < 3; i++)
+                        touched[idx[adjTriangles[k] * 3 + i]] = true;
+            }
+
+            if (applied == 0)
+                break;
+
+            std::size_t write = 0;
+            for (std::size_t t = 0; t < idx.size(); t += 3) {
+                unsigned int a = remap[idx[t]], b = remap[idx[t + 1]], c = remap[idx[t + 2]];
+                if (a == b || b == c || a == c)
+                    continue;
+                idx[write++] = a;
+                idx[write++] = b;
+                idx[write++] = c;
+            }
+            idx.resize(write);
+        }
+
+        // Keep only referenced vertices, in first-use order
+        const unsigned int unset = ~0u;
+        std::vector<unsigned int> compact(vertexCount, unset);
+        out.vertices.clear();
+        out.indices.resize(idx.size());
+        unsigned int next = 0;
+        for (std::size_t i = 0; i < idx.size(); i++) {
+            unsigned int v = idx[i];
+            if (compact[v] == unset) {
+                compact[v] = next++;
+                const unsigned char* src = in.vertices.data() + v * stride;
+                out.vertices.insert(out.vertices.end(), src, src + stride);
+            }
+            out.indices[i] = compact[v];
+        }
+        out.layout = in.layout;
+        out.metadata = in.metadata;
+
+        if (result) {
+            result->trianglesBefore = trianglesBefore;
+            result->trianglesAfter = idx.size() / 3;
+            result->error = static_cast<float>(worst);
+            result->ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+        return true;
+    }
+
+    std::vector<MeshSimplifier::Level> MeshSimplifier::buildLods(const MeshData& base, unsigned levels, float ratio) {
+        std::vector<Level> lods;
+        lods.reserve(levels);
+        const MeshData* source = &base;
+        float error = 0.0f;
+
+        for (unsigned i = 0; i < levels; i++) {
+            std::size_t triangles = source->indices.size() / 3;
+            std::size_t target = static_cast<std::size_t>(triangles * ratio);
+
+            Level level;
+            Result r;
+            if (target == 0 || !simplify(*source, level.data, target, 1e30f, &r))
+                break;
+            // Not worth a level of its own
+            if (r.trianglesAfter > triangles - triangles / 10)
+                break;
+
+            // Errors of successive levels add up relative to the base
+            error += r.error;
+            level.error = error;
+            lods.push_back(std::move(level));
+            source = &lods.back().data;
+        }
+        return lods;
+    }
+
+    void MeshSimplifier::report(std::ostream& os, const std::string& name, const MeshData& base,
+        const std::vector<Level>& levels, double ms) {
+        auto flags = os.flags();
+        auto precision = os.precision(4);
+        os << "[lod] " << name << ": " << base.indices.size() / 3;
+        for (const auto& l : levels)
+            os << " -> " << l.data.indices.size() / 3 << " (err " << l.error << ")";
+        os.setf(std::ios::fixed, std::ios::floatfield);
+        os.precision(2);
+        os << " triangles (" << ms << " ms)\n";
+        os.flags(flags);
+        os.precision(precision);
+    }
+
+}
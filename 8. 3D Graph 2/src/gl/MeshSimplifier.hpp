@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "MeshParser.hpp"
+
+namespace gl {
+
+    /**
+     * @brief Quadric error metric (Garland-Heckbert) mesh simplification.
+     *
+     * Edges are collapsed onto one of their existing vertices, so every
+     * level keeps the source's vertex attributes untouched. Vertices on
+     * open borders and attribute seams (several vertices at one position)
+     * never move, which keeps the silhouette and uv/color seams intact
+     * at the cost of stopping early on heavily seamed meshes.
+     */
+    class MeshSimplifier {
+    public:
+        struct Result {
+            std::size_t trianglesBefore = 0;
+            std::size_t trianglesAfter = 0;
+            float error = 0.0f; // largest collapse error, in position units
+            double ms = 0.0;
+        };
+
+        // One level of a LOD chain; `error` is relative to the base mesh
+        struct Level {
+            MeshData data;
+            float error = 0.0f;
+        };
+
+        /**
+         * Simplifies `in` down to about `targetTriangles` triangles, or less
+         * far when the next collapse would move the surface by more than
+         * `maxError`. `out` only holds the vertices still referenced.
+         */
+        static bool simplify(const MeshData& in, MeshData& out, std::size_t targetTriangles,
+            float maxError = 1e30f, Result* result = nullptr);
+
+        // Up to `levels` coarser levels, each about `ratio` of the previous
+        // triangle count. Stops early once a level barely shrinks.
+        static std::vector<Level> buildLods(const MeshData& base, unsigned levels, float ratio = 0.5f);
+
+        static void report(std::ostream& os, const std::string& name, const MeshData& base,
+            const std::vector<Level>& levels, double ms);
+    };
+
+}
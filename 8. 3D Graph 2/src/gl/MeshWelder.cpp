@@ -0,0 +1,170 @@
+#include "MeshWelder.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace gl {
+
+    namespace {
+        // How one attribute contributes to the vertex key
+        struct KeyPart {
+            std::size_t offset;     // in the vertex
+            std::size_t bytes;      // raw bytes copied when not snapped
+            GLenum type;
+            GLint components;
+            double epsilon;         // > 0: float components snapped to a grid
+        };
+
+        std::uint64_t hashKey(const unsigned char* key, std::size_t words) {
+            std::uint64_t h = 0x9E3779B97F4A7C15ull;
+            for (std::size_t w = 0; w < words; w++) {
+                std::uint64_t k;
+                std::memcpy(&k, key + w * 8, 8);
+                k *= 0xFF51AFD7ED558CCDull;
+                k ^= k >> 33;
+                h = (h ^ k) * 0xC4CEB9FE1A85EC53ull;
+            }
+            return h ^ (h >> 29);
+        }
+    }
+
+    bool MeshWelder::weld(MeshData& data, const std::vector<float>& epsilon, Result* result) {
+        auto start = std::chrono::steady_clock::now();
+
+        const std::size_t vertexCount = data.vertexCount();
+        const std::size_t stride = data.layout.stride();
+        if (vertexCount == 0)
+            return false;
+        if (!data.indices.empty() && data.indices.size() % 3 != 0)
+            return false;
+
+        // Key layout: snapped components become 64-bit grid cells
+        std::vector<KeyPart> parts;
+        std::size_t keyBytes = 0;
+        const auto& attrs = data.layout.attributes();
+        for (std::size_t i = 0; i < attrs.size(); i++) {
+            const auto& a = attrs[i];
+            double eps = epsilon.empty() ? 0.0 : epsilon[epsilon.size() == 1 ? 0 : std::min(i, epsilon.size() - 1)];
+            bool snapped = eps > 0.0 && (a.type == GL_FLOAT || a.type == GL_DOUBLE);
+            KeyPart part{ a.offset, vertex_layout::attributeSize(a.type, a.size), a.type, a.size, snapped ? eps : 0.0 };
+            keyBytes += snapped ? a.size * sizeof(std::int64_t) : part.bytes;
+            parts.push_back(part);
+        }
+        const std::size_t keyWords = (keyBytes + 7) / 8;
+        const std::size_t keyStride = keyWords * 8;
+
+        std::vector<unsigned char> keys(vertexCount * keyStride, 0);
+        for (std::size_t v = 0; v < vertexCount; v++) {
+            const unsigned char* src = data.vertices.data() + v * stride;
+            unsigned char* dst = keys.data() + v * keyStride;
+            for (const auto& p : parts) {
+                if (p.epsilon <= 0.0) {
+                    std::memcpy(dst, src + p.offset, p.bytes);
+                    dst += p.bytes;
+                    continue;
+                }
+                for (GLint c = 0; c < p.components; c++) {
+                    double value;
+                    if (p.type == GL_FLOAT) {
+                        float f;
+                        std::memcpy(&f, src + p.offset + c * sizeof(float), sizeof(float));
+                        value = f;
+                    }
+                    else {
+                        std::memcpy(&value, src + p.offset + c * sizeof(double), sizeof(double));
+                    }
+                    std::int64_t cell = static_cast<std::int64_t>(std::floor(value / p.epsilon + 0.5));
+                    std::memcpy(dst, &cell, sizeof(cell));
+                    dst += sizeof(cell);
+                }
+            }
+        }
+
+        // Open addressing over vertex ids, load factor <= 1/2
+        std::size_t tableSize = 1;
+        while (tableSize < vertexCount * 2)
+            tableSize <<= 1;
+        const unsigned int empty = ~0u;
+        std::vector<unsigned int> table(tableSize, empty);
+
+        std::vector<unsigned int> remap(vertexCount);
+        std::vector<unsigned char> welded;
+        welded.reserve(data.vertices.size());
+        unsigned int unique = 0;
+        for (std::size_t v = 0; v < vertexCount; v++) {
+            const unsigned char* key = keys.data() + v * keyStride;
+            std::size_t slot = hashKey(key, keyWords) & (tableSize - 1);
+            while (table[slot] != empty &&
+                std::memcmp(keys.data() + static_cast<std::size_t>(table[slot]) * keyStride, key, keyStride) != 0)
+                slot = (slot + 1) & (tableSize - 1);
+
+            if (table[slot] == empty) {
+                // Keys of kept vertices move down so table entries index them
+                table[slot] = unique;
+                std::memmove(keys.data() + static_cast<std::size_t>(unique) * keyStride, key, keyStride);
+                const unsigned char* src = data.vertices.data() + v * stride;
+                welded.insert(welded.end(), src, src + stride);
+                remap[v] = unique++;
+            }
+            else {
+                remap[v] = table[slot];
+            }
+        }
+
+        if (data.indices.empty()) {
+            data.indices.resize(vertexCount);
+            for (std::size_t v = 0; v < vertexCount; v++)
+                data.indices[v] = remap[v];
+        }
+        else {
+            for (unsigned int& i : data.indices)
+                i = i < vertexCount ? remap[i] : i;
+        }
+        data.vertices.swap(welded);
+
+        if (result) {
+            result->verticesBefore = vertexCount;
+            result->verticesAfter = unique;
+            result->ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+        return true;
+    }
+
+    bool MeshWelder::parseEpsilon(std::string_view text, std::vector<float>& epsilon) {
+        epsilon.clear();
+        if (text == "true" || text == "yes" || text == "1" || text == "exact")
+            return true;
+
+        const char* p = text.data();
+        const char* end = p + text.size();
+        while (p < end) {
+            while (p < end && (*p == ' ' || *p == '\t'))
+                p++;
+            if (p == end)
+                break;
+            float eps;
+            auto [next, ec] = std::from_chars(p, end, eps);
+            if (ec != std::errc() || eps < 0.0f)
+                return false;
+            epsilon.push_back(eps);
+            p = next;
+        }
+        return !epsilon.empty();
+    }
+
+    void MeshWelder::report(std::ostream& os, const std::string& name, const Result& result) {
+        double ratio = result.verticesAfter ? static_cast<double>(result.verticesBefore) / result.verticesAfter : 0.0;
+        auto flags = os.flags();
+        auto precision = os.precision(2);
+        os.setf(std::ios::fixed, std::ios::floatfield);
+        os << "[weld] " << name << ": " << result.verticesBefore << " -> " << result.verticesAfter
+            << " vertices (" << ratio << "x fewer, " << result.ms << " ms)\n";
+        os.flags(flags);
+        os.precision(precision);
+    }
+
+}
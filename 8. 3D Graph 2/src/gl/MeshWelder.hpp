@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MeshParser.hpp"
+
+namespace gl {
+
+    /**
+     * @brief Collapses duplicate vertices and indexes the mesh.
+     *
+     * Triangle soup (no `:index` section) gets an index buffer; indexed
+     * meshes have their indices remapped. Vertices are hashed on their
+     * bytes, with float components first snapped to a grid of the
+     * attribute's epsilon (0 = exact). Each group keeps its first vertex.
+     */
+    class MeshWelder {
+    public:
+        struct Result {
+            std::size_t verticesBefore = 0;
+            std::size_t verticesAfter = 0;
+            double ms = 0.0;
+        };
+
+        // `epsilon[i]` applies to attribute i; a single value applies to all
+        static bool weld(MeshData& data, const std::vector<float>& epsilon = {}, Result* result = nullptr);
+
+        // "@weld" values: "true"/"exact", or epsilons like "0.001 0 0.01"
+        static bool parseEpsilon(std::string_view text, std::vector<float>& epsilon);
+
+        static void report(std::ostream& os, const std::string& name, const Result& result);
+    };
+
+}
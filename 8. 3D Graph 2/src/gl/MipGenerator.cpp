@@ -0,0 +1,225 @@
+#include "MipGenerator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+
+namespace gl {
+
+    namespace {
+        // Premultiplied RGBA, linear light when the source was sRGB
+        struct linear_image {
+            int width = 0;
+            int height = 0;
+            std::vector<float> px;
+        };
+
+        // Source texels and normalised weights of every destination texel
+        // along one axis; edges are clamped
+        struct axis_weights {
+            int taps = 0;
+            std::vector<int> index;
+            std::vector<float> weight;
+        };
+
+        constexpr float kaiserRadius = 3.0f;
+        constexpr float kaiserAlpha = 4.0f;
+
+        const std::array<float, 256>& srgbToLinear() {
+            static const std::array<float, 256> table = [] {
+                std::array<float, 256> t{};
+                for (int i = 0; i < 256; i++) {
+                    float v = i / 255.0f;
+                    t[i] = v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f);
+                }
+                return t;
+            }();
+            return table;
+        }
+
+        unsigned char linearToSrgb(float v) {
+            v = v <= 0.0031308f ? v * 12.92f : 1.055f * std::pow(v, 1.0f / 2.4f) - 0.055f;
+            return static_cast<unsigned char>(std::lround(std::min(1.0f, std::max(0.0f, v)) * 255.0f));
+        }
+
+        unsigned char toByte(float v) {
+            return static_cast<unsigned char>(std::lround(std::min(1.0f, std::max(0.0f, v)) * 255.0f));
+        }
+
+        double besselI0(double x) {
+            double sum = 1.0, term = 1.0;
+            for (int k = 1; k < 32 && term > 1e-12 * sum; k++) {
+                term *= (x / (2.0 * k)) * (x / (2.0 * k));
+                sum += term;
+            }
+            return sum;
+        }
+
+        // Kernel over output texels: t = 1 is one destination texel away
+        // (one source texel when upscaling)
+        float kernel(mip_filter filter, float t) {
+            t = std::fabs(t);
+            if (filter == mip_filter::box)
+                return t < 0.5f ? 1.0f : t == 0.5f ? 0.5f : 0.0f;
+
+            if (t >= kaiserRadius)
+                return 0.0f;
+            const float x = static_cast<float>(std::numbers::pi) * t;
+            const float sinc = t < 1e-6f ? 1.0f : std::sin(x) / x;
+            const float r = t / kaiserRadius;
+            static const double norm = besselI0(kaiserAlpha);
+            return sinc * static_cast<float>(besselI0(kaiserAlpha * std::sqrt(1.0 - r * r)) / norm);
+        }
+
+        axis_weights weightsFor(int src, int dst, mip_filter filter) {
+            const float scale = static_cast<float>(src) / dst;
+            // Upscaling keeps the kernel one source texel wide, else no tap is in reach
+            const float support = std::max(scale, 1.0f);
+            const float radius = (filter == mip_filter::box ? 0.5f : kaiserRadius) * support;
+
+            axis_weights w;
+            w.taps = static_cast<int>(std::ceil(radius * 2.0f)) + 1;
+            w.index.resize(static_cast<std::size_t>(dst) * w.taps);
+            w.weight.resize(w.index.size());
+            for (int i = 0; i < dst; i++) {
+                const float center = (i + 0.5f) * scale;
+                const int left = static_cast<int>(std::floor(center - radius));
+                float sum = 0.0f;
+                for (int k = 0; k < w.taps; k++) {
+                    const int j = left + k;
+                    const float weight = kernel(filter, (j + 0.5f - center) / support);
+                    w.index[i * w.taps + k] = std::min(src - 1, std::max(0, j));
+                    w.weight[i * w.taps + k] = weight;
+                    sum += weight;
+                }
+                if (sum == 0.0f)
+                    sum = 1.0f;
+                for (int k = 0; k < w.taps; k++)
+                    w.weight[i * w.taps + k] /= sum;
+            }
+            return w;
+        }
+
+        // Horizontal pass into a (dst.width x src.height) image, then vertical
+        void resample(const linear_image& src, linear_image& dst, mip_filter filter, ThreadPool& pool) {
+            const axis_weights h = weightsFor(src.width, dst.width, filter);
+            const axis_weights v = weightsFor(src.height, dst.height, filter);
+
+            std::vector<float> tmp(static_cast<std::size_t>(dst.width) * src.height * 4);
+            pool.parallelFor(src.height, [&](std::size_t y) {
+                const float* row = src.px.data() + y * src.width * 4;
+                float* out = tmp.data() + y * dst.width * 4;
+                for (int x = 0; x < dst.width; x++) {
+                    float acc[4] = {};
+                    for (int k = 0; k < h.taps; k++) {
+                        const float w = h.weight[x * h.taps + k];
+                        const float* p = row + h.index[x * h.taps + k] * 4;
+                        for (int ch = 0; ch < 4; ch++)
+                            acc[ch] += w * p[ch];
+                    }
+                    std::copy(acc, acc + 4, out + x * 4);
+                }
+            });
+
+            dst.px.assign(static_cast<std::size_t>(dst.width) * dst.height * 4, 0.0f);
+            pool.parallelFor(dst.height, [&](std::size_t y) {
+                float* out = dst.px.data() + y * dst.width * 4;
+                for (int k = 0; k < v.taps; k++) {
+                    const float w = v.weight[y * v.taps + k];
+                    const float* row = tmp.data() + static_cast<std::size_t>(v.index[y * v.taps + k]) * dst.width * 4;
+                    for (int i = 0; i < dst.width * 4; i++)
+                        out[i] += w * row[i];
+                }
+            });
+        }
+
+        linear_image toLinear(const unsigned char* rgba, int width, int height, bool srgb, ThreadPool& pool) {
+            const auto& decode = srgbToLinear();
+            linear_image img;
+            img.width = width;
+            img.height = height;
+            img.px.resize(static_cast<std::size_t>(width) * height * 4);
+            pool.parallelFor(height, [&](std::size_t y) {
+                for (std::size_t i = y * width * 4; i < (y + 1) * width * 4; i += 4) {
+                    const float a = rgba[i + 3] / 255.0f;
+                    for (int ch = 0; ch < 3; ch++)
+                        img.px[i + ch] = (srgb ? decode[rgba[i + ch]] : rgba[i + ch] / 255.0f) * a;
+                    img.px[i + 3] = a;
+                }
+            });
+            return img;
+        }
+
+        mip_level toLevel(const linear_image& img, bool srgb, ThreadPool& pool) {
+            mip_level level;
+            level.width = img.width;
+            level.height = img.height;
+            level.rgba.resize(static_cast<std::size_t>(img.width) * img.height * 4);
+            pool.parallelFor(img.height, [&](std::size_t y) {
+                for (int x = 0; x < img.width; x++) {
+                    const std::size_t i = (y * img.width + x) * 4;
+                    const float a = std::min(1.0f, std::max(0.0f, img.px[i + 3]));
+                    const float unpremultiply = a > 0.0f ? 1.0f / a : 0.0f;
+                    for (int ch = 0; ch < 3; ch++) {
+                        const float c = img.px[i + ch] * unpremultiply;
+                        level.rgba[i + ch] = srgb ? linearToSrgb(c) : toByte(c);
+                    }
+                    level.rgba[i + 3] = toByte(a);
+                }
+            });
+            return level;
+        }
+    }
+
+    const char* MipGenerator::name(mip_filter filter) {
+        return filter == mip_filter::box ? "box" : "kaiser";
+    }
+
+    bool MipGenerator::parse(const std::string& name, mip_filter& filter) {
+        if (name == "box") filter = mip_filter::box;
+        else if (name == "kaiser") filter = mip_filter::kaiser;
+        else return false;
+        return true;
+    }
+
+    std::vector<mip_level> MipGenerator::build(const unsigned char* rgba, int width, int height,
+        mip_filter filter, bool srgb, ThreadPool& pool) {
+        std::vector<mip_level> chain;
+        if (!rgba || width <= 0 || height <= 0)
+            return chain;
+
+        mip_level top;
+        top.width = width;
+        top.height = height;
+        top.rgba.assign(rgba, rgba + static_cast<std::size_t>(width) * height * 4);
+        chain.push_back(std::move(top));
+
+        linear_image current = toLinear(rgba, width, height, srgb, pool);
+
+        while (current.width > 1 || current.height > 1) {
+            linear_image next;
+            next.width = std::max(1, current.width / 2);
+            next.height = std::max(1, current.height / 2);
+            resample(current, next, filter, pool);
+            chain.push_back(toLevel(next, srgb, pool));
+            current = std::move(next);
+        }
+        return chain;
+    }
+
+    mip_level MipGenerator::resize(const unsigned char* rgba, int width, int height, int dstWidth, int dstHeight,
+        mip_filter filter, bool srgb, ThreadPool& pool) {
+        if (!rgba || width <= 0 || height <= 0 || dstWidth <= 0 || dstHeight <= 0)
+            return {};
+        if (dstWidth == width && dstHeight == height)
+            return { width, height, std::vector<unsigned char>(rgba, rgba + static_cast<std::size_t>(width) * height * 4) };
+
+        linear_image next;
+        next.width = dstWidth;
+        next.height = dstHeight;
+        resample(toLinear(rgba, width, height, srgb, pool), next, filter, pool);
+        return toLevel(next, srgb, pool);
+    }
+
+}
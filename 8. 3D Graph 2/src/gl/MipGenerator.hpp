@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "ThreadPool.hpp"
+
+namespace gl {
+
+    enum class mip_filter {
+        box,    // 2x2 average (wider at odd sizes); soft, never rings
+        kaiser, // Kaiser-windowed sinc over 3 texels each side; sharper
+    };
+
+    struct mip_level {
+        int width = 0;
+        int height = 0;
+        std::vector<unsigned char> rgba; // tightly packed RGBA8
+    };
+
+    /**
+     * @brief Offline mip chain generation.
+     *
+     * Each level is resampled from the one above with a separable filter.
+     * Colour is filtered in linear light (sRGB decoded first, encoded
+     * again after) and weighted by alpha, so dark fringes don't creep in
+     * around transparent texels; alpha itself is filtered as stored. Rows
+     * of every pass are spread over the thread pool.
+     */
+    class MipGenerator {
+    public:
+        static const char* name(mip_filter filter);
+        static bool parse(const std::string& name, mip_filter& filter);
+
+        // Level 0 (a copy of the input) down to 1x1. With `srgb` false the
+        // colour channels are treated as plain data, e.g. normal maps.
+        static std::vector<mip_level> build(const unsigned char* rgba, int width, int height,
+            mip_filter filter, bool srgb = true, ThreadPool& pool = ThreadPool::shared());
+
+        // One resample straight to dstWidth x dstHeight, same filtering
+        static mip_level resize(const unsigned char* rgba, int width, int height, int dstWidth, int dstHeight,
+            mip_filter filter, bool srgb = true, ThreadPool& pool = ThreadPool::shared());
+    };
+
+}
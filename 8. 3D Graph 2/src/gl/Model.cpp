@@ -3,76 +3,75 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace gl {
 
     // ---------------------------
     // Constructor
     // ---------------------------
     Model::Model()
-        : m_position(0.0f), m_rotation(1, 0, 0, 0), m_scale(1.0f) {
+        : m_lod(0) {
     }
 
     Model::Model(Mesh&& mesh)
         : m_mesh(std::move(mesh)),
-        m_position(0.0f),
-        m_rotation(1, 0, 0, 0),
-        m_scale(1.0f) {
+        m_lod(0) {
     }
 
     // ---------------------------
     // Transform Setters
     // ---------------------------
-    void Model::setPosition(const glm::vec3& p) { m_position = p; }
-    void Model::setRotation(const glm::quat& q) { m_rotation = q; }
+    void Model::setPosition(const glm::vec3& p) { m_transform.setPosition(p); }
+    void Model::setRotation(const glm::quat& q) { m_transform.setRotation(q); }
     void Model::setEuler(float pitch, float yaw, float roll) {
-        m_rotation = glm::quat(glm::vec3(pitch, yaw, roll));
+        m_transform.setRotation(glm::quat(glm::vec3(pitch, yaw, roll)));
     }
-    void Model::setScale(const glm::vec3& s) { m_scale = s; }
+    void Model::setScale(const glm::vec3& s) { m_transform.setScale(s); }
 
     // ---------------------------
     // Transform Operations
     // ---------------------------
     void Model::translate(const glm::vec3& delta) {
-        m_position += delta;
+        m_transform.setPosition(m_transform.position() + delta);
     }
 
     void Model::rotateEuler(float pitch, float yaw, float roll) {
         glm::quat q = glm::quat(glm::vec3(pitch, yaw, roll));
-        m_rotation = q * m_rotation;
+        m_transform.setRotation(q * m_transform.rotation());
     }
 
     void Model::rotateQuat(const glm::quat& q) {
-        m_rotation = q * m_rotation;
+        m_transform.setRotation(q * m_transform.rotation());
     }
 
     // Axis-specific rotation helpers
     void Model::rotateX(float radians) {
-        m_rotation = glm::angleAxis(radians, glm::vec3(1, 0, 0)) * m_rotation;
+        m_transform.setRotation(glm::angleAxis(radians, glm::vec3(1, 0, 0)) * m_transform.rotation());
     }
 
     void Model::rotateY(float radians) {
-        m_rotation = glm::angleAxis(radians, glm::vec3(0, 1, 0)) * m_rotation;
+        m_transform.setRotation(glm::angleAxis(radians, glm::vec3(0, 1, 0)) * m_transform.rotation());
     }
 
     void Model::rotateZ(float radians) {
-        m_rotation = glm::angleAxis(radians, glm::vec3(0, 0, 1)) * m_rotation;
+        m_transform.setRotation(glm::angleAxis(radians, glm::vec3(0, 0, 1)) * m_transform.rotation());
     }
 
     void Model::scaleBy(const glm::vec3& factor) {
-        m_scale *= factor;
+        m_transform.setScale(m_transform.scale() * factor);
     }
 
     // ---------------------------
     // Model Matrix
     // ---------------------------
-    glm::mat4 Model::modelMatrix() const {
-        glm::mat4 m(1.0f);
-
-        m = glm::translate(m, m_position);
-        m *= glm::mat4_cast(m_rotation);
-        m = glm::scale(m, m_scale);
+    const glm::mat4& Model::modelMatrix() const {
+        return m_transform.world();
+    }
 
-        return m;
+    const glm::mat4& Model::mvp(const glm::mat4& viewProj) const {
+        return m_transform.mvp(viewProj);
     }
 
     // ---------------------------
@@ -84,15 +83,70 @@ namespace gl {
         m_mesh.upload(v, idx, layout);
     }
 
-    void Model::upload(const MeshData& data) {
-        m_mesh.upload(data);
+    void Model::upload(const MeshData& data, bool splitIndices) {
+        m_mesh.upload(data, splitIndices);
     }
 
     void Model::draw(GLenum mode) const {
-        m_mesh.draw(mode);
+        lodMesh(m_lod).draw(mode);
+    }
+
+    glm::vec4 Model::worldSphere() const {
+        return m_mesh.bounds().sphere(modelMatrix());
+    }
+
+    aabb Model::worldBox() const {
+        return m_mesh.bounds().box(modelMatrix());
     }
 
     Mesh& Model::mesh() { return m_mesh; }
     const Mesh& Model::mesh() const { return m_mesh; }
 
+    // ---------------------------
+    // Level of Detail
+    // ---------------------------
+    void Model::setLods(std::vector<Mesh>&& lods, const std::vector<float>& errors) {
+        m_lods = std::move(lods);
+        m_lodErrors = errors;
+        m_lodErrors.resize(m_lods.size(), 0.0f);
+        m_lod = 0;
+    }
+
+    float Model::projectedSize(const Camera& camera, const glm::mat4& projection, float viewportHeight) const {
+        glm::vec4 sphere = worldSphere();
+        float distance = glm::length(glm::vec3(sphere) - camera.getPosition());
+        float radius = sphere.w;
+        if (distance <= radius)
+            return viewportHeight;
+
+        // projection[1][1] = 1 / tan(fovy / 2)
+        return 2.0f * radius / distance * projection[1][1] * 0.5f * viewportHeight;
+    }
+
+    std::size_t Model::selectLod(const Camera& camera, const glm::mat4& projection,
+        float viewportHeight, float pixelError) {
+        m_lod = 0;
+        if (m_lods.empty() || m_mesh.bounds().radius <= 0.0f)
+            return m_lod;
+
+        // Models filling the screen keep full detail
+        float size = projectedSize(camera, projection, viewportHeight);
+        if (size >= viewportHeight)
+            return m_lod;
+
+        // Pixels per mesh unit at the model's distance
+        float pixelsPerUnit = size / (2.0f * m_mesh.bounds().radius);
+        for (std::size_t i = m_lods.size(); i > 0; i--) {
+            if (m_lodErrors[i - 1] * pixelsPerUnit <= pixelError) {
+                m_lod = i;
+                break;
+            }
+        }
+        return m_lod;
+    }
+
+    const Mesh& Model::lodMesh(std::size_t level) const {
+        return level == 0 || level > m_lods.size() ? m_mesh : m_lods[level - 1];
+    }
+
 }
\ No newline at end of file
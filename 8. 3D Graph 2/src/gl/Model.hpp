@@ -3,6 +3,10 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include "Mesh.hpp"
+#include "Camera.hpp"
+#include "TransformStore.hpp"
+
+#include <vector>
 
 namespace gl {
 
@@ -10,9 +14,14 @@ namespace gl {
     private:
         Mesh m_mesh;
 
-        glm::vec3 m_position;
-        glm::quat m_rotation;
-        glm::vec3 m_scale;
+        // Position/rotation/scale live in TransformStore::shared()
+        transform_handle m_transform;
+
+        // Coarser versions of m_mesh, finest first, and how far (in mesh
+        // units) each one strays from it
+        std::vector<Mesh> m_lods;
+        std::vector<float> m_lodErrors;
+        std::size_t m_lod;
 
     public:
         Model();
@@ -42,20 +51,49 @@ namespace gl {
 
         void scaleBy(const glm::vec3& factor);
 
-        // Model Matrix
-        glm::mat4 modelMatrix() const;
+        // Current position/rotation/scale and the store slot behind them
+        const transform_handle& transform() const { return m_transform; }
+
+        // Model Matrix, rebuilt only after the transform changed
+        const glm::mat4& modelMatrix() const;
+        // viewProj * modelMatrix(), cached while neither side changes
+        const glm::mat4& mvp(const glm::mat4& viewProj) const;
+
+        // Mesh bounds in world space; the sphere as (center, radius)
+        glm::vec4 worldSphere() const;
+        aabb worldBox() const;
 
         // Mesh interface
         void upload(const std::vector<float>& v,
             const std::vector<unsigned int>& idx,
             const vertex_layout& layout);
 
-        void upload(const MeshData& data);
+        void upload(const MeshData& data, bool splitIndices = false);
 
+        // Draws the level picked by the last selectLod (the full mesh by default)
         void draw(GLenum mode = GL_TRIANGLES) const;
 
         Mesh& mesh();
         const Mesh& mesh() const;
+
+        // Level of detail
+        void setLods(std::vector<Mesh>&& lods, const std::vector<float>& errors);
+
+        /**
+         * Picks the coarsest level whose error, projected at the model's
+         * distance from the camera, stays under `pixelError` pixels.
+         * `projection` is the perspective matrix and `viewportHeight` the
+         * framebuffer height in pixels. Returns the level (0 = full mesh).
+         */
+        std::size_t selectLod(const Camera& camera, const glm::mat4& projection,
+            float viewportHeight, float pixelError = 1.0f);
+
+        // Height of the model's bounding sphere on screen, in pixels
+        float projectedSize(const Camera& camera, const glm::mat4& projection, float viewportHeight) const;
+
+        std::size_t lod() const { return m_lod; }
+        std::size_t lodCount() const { return m_lods.size() + 1; }
+        const Mesh& lodMesh(std::size_t level) const;
     };
 
 }
\ No newline at end of file
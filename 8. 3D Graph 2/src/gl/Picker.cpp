@@ -0,0 +1,269 @@
+#include "Picker.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define PICKER_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace gl {
+
+    namespace {
+        // Spreads the low 10 bits so two zero bits sit between each
+        std::uint32_t spreadBits(std::uint32_t x) {
+            x = (x | (x << 16)) & 0x030000FF;
+            x = (x | (x << 8)) & 0x0300F00F;
+            x = (x | (x << 4)) & 0x030C30C3;
+            x = (x | (x << 2)) & 0x09249249;
+            return x;
+        }
+
+#ifdef PICKER_SSE
+        inline __m128 cross(__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz, __m128& cy, __m128& cz) {
+            cy = _mm_sub_ps(_mm_mul_ps(az, bx), _mm_mul_ps(ax, bz));
+            cz = _mm_sub_ps(_mm_mul_ps(ax, by), _mm_mul_ps(ay, bx));
+            return _mm_sub_ps(_mm_mul_ps(ay, bz), _mm_mul_ps(az, by));
+        }
+
+        inline __m128 dot(__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz) {
+            return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+        }
+#endif
+    }
+
+    // ---------------------------
+    // PickMesh
+    // ---------------------------
+    bool PickMesh::build(const MeshData& data) {
+        const vertex_layout::Attribute* pos = data.positionAttribute();
+        if (!pos)
+            return false;
+        return build(data.vertices.data() + pos->offset, data.vertexCount(), data.layout.stride(),
+            data.indices.data(), data.indices.size());
+    }
+
+    bool PickMesh::build(const void* vertices, std::size_t vertexCount, std::size_t stride,
+        const unsigned int* indices, std::size_t indexCount) {
+        m_packets.clear();
+        m_triangles.clear();
+        m_triangleCount = 0;
+        m_bvh.build({});
+
+        const std::size_t corners = indexCount ? indexCount : vertexCount;
+        if (corners < 3 || stride < sizeof(float) * 3)
+            return false;
+        const std::size_t triangles = corners / 3;
+
+        auto position = [&](std::size_t corner) {
+            std::size_t v = indexCount ? indices[corner] : corner;
+            glm::vec3 p(0.0f);
+            if (v < vertexCount)
+                std::memcpy(&p[0], static_cast<const unsigned char*>(vertices) + v * stride, sizeof(float) * 3);
+            return p;
+        };
+
+        // Morton order of the centroids keeps each packet's triangles close
+        aabb centroidBox;
+        std::vector<glm::vec3> centroids(triangles);
+        for (std::size_t t = 0; t < triangles; t++) {
+            centroids[t] = (position(t * 3) + position(t * 3 + 1) + position(t * 3 + 2)) / 3.0f;
+            centroidBox.grow(centroids[t]);
+        }
+        glm::vec3 scale = 1023.0f / glm::max(centroidBox.extent(), glm::vec3(1e-20f));
+        std::vector<std::uint32_t> codes(triangles);
+        for (std::size_t t = 0; t < triangles; t++) {
+            glm::vec3 q = (centroids[t] - centroidBox.min) * scale;
+            codes[t] = (spreadBits(static_cast<std::uint32_t>(q.x)) << 2) |
+                (spreadBits(static_cast<std::uint32_t>(q.y)) << 1) | spreadBits(static_cast<std::uint32_t>(q.z));
+        }
+        std::vector<std::uint32_t> order(triangles);
+        std::iota(order.begin(), order.end(), 0u);
+        std::sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) { return codes[a] < codes[b]; });
+
+        // Unused lanes stay degenerate (zero edges) and never hit
+        const std::size_t packets = (triangles + 3) / 4;
+        m_packets.assign(packets, Packet{});
+        m_triangles.assign(packets * 4, invalid);
+        std::vector<aabb> boxes(packets);
+        for (std::size_t i = 0; i < triangles; i++) {
+            std::uint32_t t = order[i];
+            Packet& p = m_packets[i / 4];
+            std::size_t lane = i % 4;
+            glm::vec3 a = position(t * 3), b = position(t * 3 + 1), c = position(t * 3 + 2);
+            glm::vec3 e1 = b - a, e2 = c - a;
+            for (int k = 0; k < 3; k++) {
+                p.v0[k][lane] = a[k];
+                p.e1[k][lane] = e1[k];
+                p.e2[k][lane] = e2[k];
+            }
+            m_triangles[i] = t;
+            boxes[i / 4].grow(a);
+            boxes[i / 4].grow(b);
+            boxes[i / 4].grow(c);
+        }
+
+        m_bvh.build(boxes);
+        m_triangleCount = triangles;
+        return true;
+    }
+
+    void PickMesh::intersect(const Packet& p, std::uint32_t packet, const glm::vec3& origin,
+        const glm::vec3& dir, Hit& best) const {
+#ifdef PICKER_SSE
+        const __m128 dx = _mm_set1_ps(dir.x), dy = _mm_set1_ps(dir.y), dz = _mm_set1_ps(dir.z);
+        const __m128 e1x = _mm_loadu_ps(p.e1[0]), e1y = _mm_loadu_ps(p.e1[1]), e1z = _mm_loadu_ps(p.e1[2]);
+        const __m128 e2x = _mm_loadu_ps(p.e2[0]), e2y = _mm_loadu_ps(p.e2[1]), e2z = _mm_loadu_ps(p.e2[2]);
+
+        // Möller-Trumbore, both faces count
+        __m128 py, pz;
+        __m128 px = cross(dx, dy, dz, e2x, e2y, e2z, py, pz);
+        __m128 det = dot(e1x, e1y, e1z, px, py, pz);
+        __m128 absDet = _mm_andnot_ps(_mm_set1_ps(-0.0f), det);
+        __m128 valid = _mm_cmpgt_ps(absDet, _mm_set1_ps(1e-12f));
+        __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+        __m128 tx = _mm_sub_ps(_mm_set1_ps(origin.x), _mm_loadu_ps(p.v0[0]));
+        __m128 ty = _mm_sub_ps(_mm_set1_ps(origin.y), _mm_loadu_ps(p.v0[1]));
+        __m128 tz = _mm_sub_ps(_mm_set1_ps(origin.z), _mm_loadu_ps(p.v0[2]));
+        __m128 u = _mm_mul_ps(dot(tx, ty, tz, px, py, pz), invDet);
+
+        __m128 qy, qz;
+        __m128 qx = cross(tx, ty, tz, e1x, e1y, e1z, qy, qz);
+        __m128 v = _mm_mul_ps(dot(dx, dy, dz, qx, qy, qz), invDet);
+        __m128 t = _mm_mul_ps(dot(e2x, e2y, e2z, qx, qy, qz), invDet);
+
+        const __m128 zero = _mm_setzero_ps();
+        valid = _mm_and_ps(valid, _mm_cmpge_ps(u, zero));
+        valid = _mm_and_ps(valid, _mm_cmpge_ps(v, zero));
+        valid = _mm_and_ps(valid, _mm_cmple_ps(_mm_add_ps(u, v), _mm_set1_ps(1.0f)));
+        valid = _mm_and_ps(valid, _mm_cmpge_ps(t, zero));
+        valid = _mm_and_ps(valid, _mm_cmplt_ps(t, _mm_set1_ps(best.t)));
+
+        int mask = _mm_movemask_ps(valid);
+        if (!mask)
+            return;
+
+        alignas(16) float ts[4], us[4], vs[4];
+        _mm_store_ps(ts, t);
+        _mm_store_ps(us, u);
+        _mm_store_ps(vs, v);
+        for (int lane = 0; lane < 4; lane++) {
+            if ((mask & (1 << lane)) && ts[lane] < best.t) {
+                best.t = ts[lane];
+                best.u = us[lane];
+                best.v = vs[lane];
+                best.triangle = m_triangles[packet * 4 + lane];
+            }
+        }
+#else
+        for (int lane = 0; lane < 4; lane++) {
+            glm::vec3 e1(p.e1[0][lane], p.e1[1][lane], p.e1[2][lane]);
+            glm::vec3 e2(p.e2[0][lane], p.e2[1][lane], p.e2[2][lane]);
+            glm::vec3 pv = glm::cross(dir, e2);
+            float det = glm::dot(e1, pv);
+            if (std::abs(det) <= 1e-12f)
+                continue;
+            float invDet = 1.0f / det;
+            glm::vec3 tv = origin - glm::vec3(p.v0[0][lane], p.v0[1][lane], p.v0[2][lane]);
+            float u = glm::dot(tv, pv) * invDet;
+            glm::vec3 qv = glm::cross(tv, e1);
+            float v = glm::dot(dir, qv) * invDet;
+            float t = glm::dot(e2, qv) * invDet;
+            if (u >= 0 && v >= 0 && u + v <= 1 && t >= 0 && t < best.t) {
+                best.t = t;
+                best.u = u;
+                best.v = v;
+                best.triangle = m_triangles[packet * 4 + lane];
+            }
+        }
+#endif
+    }
+
+    PickMesh::Hit PickMesh::raycast(const glm::vec3& origin, const glm::vec3& dir, float maxT) const {
+        Hit best;
+        best.t = maxT;
+        // The Bvh accepts exactly the hits that improve `best`, so both agree on the nearest
+        m_bvh.raycast(origin, dir, maxT, [&](std::uint32_t packet, float) {
+            float before = best.t;
+            intersect(m_packets[packet], packet, origin, dir, best);
+            return best.t < before ? best.t : -1.0f;
+        });
+        if (best.triangle == invalid)
+            best.t = maxT;
+        return best;
+    }
+
+    // ---------------------------
+    // Picker
+    // ---------------------------
+    Picker::Ray Picker::unproject(const glm::vec2& cursor, const glm::vec2& viewport,
+        const glm::mat4& projection, const glm::mat4& view) {
+        glm::vec2 ndc(2.0f * cursor.x / viewport.x - 1.0f, 1.0f - 2.0f * cursor.y / viewport.y);
+        glm::mat4 inv = glm::inverse(projection * view);
+
+        glm::vec4 nearPoint = inv * glm::vec4(ndc.x, ndc.y, -1.0f, 1.0f);
+        glm::vec4 farPoint = inv * glm::vec4(ndc.x, ndc.y, 1.0f, 1.0f);
+        glm::vec3 a = glm::vec3(nearPoint) / nearPoint.w;
+        glm::vec3 b = glm::vec3(farPoint) / farPoint.w;
+        return { a, glm::normalize(b - a) };
+    }
+
+    std::uint32_t Picker::add(const PickMesh& mesh, const glm::mat4& model) {
+        m_objects.push_back({ &mesh, model, glm::inverse(model) });
+        m_boxes.push_back(mesh.box().transformed(model));
+        m_rebuild = true;
+        return static_cast<std::uint32_t>(m_objects.size() - 1);
+    }
+
+    void Picker::setTransform(std::uint32_t object, const glm::mat4& model) {
+        Object& o = m_objects[object];
+        if (o.model == model)
+            return;
+        o.model = model;
+        o.inverse = glm::inverse(model);
+        m_boxes[object] = o.mesh->box().transformed(model);
+        if (!m_rebuild)
+            m_bvh.refit(object, m_boxes[object]);
+    }
+
+    void Picker::clear() {
+        m_objects.clear();
+        m_boxes.clear();
+        m_bvh.build({});
+        m_rebuild = false;
+    }
+
+    Picker::Hit Picker::pick(const Ray& ray, float maxT) {
+        if (m_rebuild) {
+            m_bvh.build(m_boxes);
+            m_rebuild = false;
+        }
+
+        Hit best;
+        best.t = maxT;
+        m_bvh.raycast(ray.origin, ray.dir, maxT, [&](std::uint32_t object, float) {
+            // Affine transforms keep t, so mesh-space hits compare directly
+            const Object& o = m_objects[object];
+            glm::vec3 origin = glm::vec3(o.inverse * glm::vec4(ray.origin, 1.0f));
+            glm::vec3 dir = glm::vec3(o.inverse * glm::vec4(ray.dir, 0.0f));
+            PickMesh::Hit hit = o.mesh->raycast(origin, dir, best.t);
+            if (hit.triangle == PickMesh::invalid)
+                return -1.0f;
+            best.object = object;
+            best.triangle = hit.triangle;
+            best.t = hit.t;
+            return hit.t;
+        });
+
+        if (best.object != invalid)
+            best.point = ray.origin + ray.dir * best.t;
+        else
+            best.t = maxT;
+        return best;
+    }
+
+}
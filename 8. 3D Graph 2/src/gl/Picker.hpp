@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Bvh.hpp"
+#include "MeshParser.hpp"
+
+namespace gl {
+
+    /**
+     * @brief CPU copy of a mesh's triangles, laid out for ray casts.
+     *
+     * Triangles are put in Morton order and packed four to a packet
+     * (vertex 0 and both edges, one SoA lane per triangle), and a Bvh is
+     * built over the packets. A cast walks the Bvh and runs
+     * Möller-Trumbore on whole packets, four triangles per SSE op.
+     * Everything is in mesh space.
+     */
+    class PickMesh {
+    public:
+        static constexpr std::uint32_t invalid = ~0u;
+
+        struct Hit {
+            std::uint32_t triangle = invalid; // index in the source index buffer / 3
+            float t = 0.0f;
+            float u = 0.0f, v = 0.0f;         // barycentrics of vertices 1 and 2
+        };
+
+        // Float xyz positions, `stride` bytes apart; no indices = triangle list
+        bool build(const void* vertices, std::size_t vertexCount, std::size_t stride,
+            const unsigned int* indices, std::size_t indexCount);
+        // Uses MeshData::positionAttribute()
+        bool build(const MeshData& data);
+
+        Hit raycast(const glm::vec3& origin, const glm::vec3& dir, float maxT = 1e30f) const;
+
+        std::size_t triangleCount() const { return m_triangleCount; }
+        const aabb& box() const { return m_bvh.rootBox(); }
+
+    private:
+        struct Packet {
+            float v0[3][4];
+            float e1[3][4];
+            float e2[3][4];
+        };
+
+        // Nearest hit among the four, if nearer than `best.t`
+        void intersect(const Packet& p, std::uint32_t packet, const glm::vec3& origin,
+            const glm::vec3& dir, Hit& best) const;
+
+        std::vector<Packet> m_packets;
+        std::vector<std::uint32_t> m_triangles; // packet * 4 + lane -> source triangle
+        std::size_t m_triangleCount = 0;
+        Bvh m_bvh;
+    };
+
+    /**
+     * @brief Picks objects under the cursor by casting a ray through the
+     * scene on the CPU, so nothing waits on the GPU (no glReadPixels).
+     *
+     * Objects are PickMeshes placed with a model matrix. A Bvh over their
+     * world boxes finds candidates, then the ray is moved into each
+     * candidate's mesh space for the exact triangle test.
+     */
+    class Picker {
+    public:
+        static constexpr std::uint32_t invalid = ~0u;
+
+        struct Ray {
+            glm::vec3 origin;
+            glm::vec3 dir; // normalized, so t is a world distance
+        };
+
+        struct Hit {
+            std::uint32_t object = invalid;
+            std::uint32_t triangle = invalid;
+            float t = 0.0f;
+            glm::vec3 point{ 0.0f };
+        };
+
+        /**
+         * World ray through `cursor` (pixels, origin top-left as GLFW
+         * reports it) for a viewport of `viewport` pixels, starting on
+         * the near plane.
+         */
+        static Ray unproject(const glm::vec2& cursor, const glm::vec2& viewport,
+            const glm::mat4& projection, const glm::mat4& view);
+
+        // The mesh must outlive the picker
+        std::uint32_t add(const PickMesh& mesh, const glm::mat4& model);
+        void setTransform(std::uint32_t object, const glm::mat4& model);
+        void clear();
+
+        Hit pick(const Ray& ray, float maxT = 1e30f);
+        Hit pick(const glm::vec2& cursor, const glm::vec2& viewport,
+            const glm::mat4& projection, const glm::mat4& view) {
+            return pick(unproject(cursor, viewport, projection, view));
+        }
+
+        std::size_t size() const { return m_objects.size(); }
+
+    private:
+        struct Object {
+            const PickMesh* mesh;
+            glm::mat4 model;
+            glm::mat4 inverse;
+        };
+
+        std::vector<Object> m_objects;
+        std::vector<aabb> m_boxes;
+        Bvh m_bvh;
+        bool m_rebuild = false;
+    };
+
+}
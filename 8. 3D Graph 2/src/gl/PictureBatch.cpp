@@ -0,0 +1,123 @@
+#include "PictureBatch.hpp"
+#include "Shader.hpp"
+#include "TexModel.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <chrono>
+#include <iostream>
+
+namespace gl {
+
+    PictureBatch::PictureBatch(int layerSize, int maxImageSize, std::size_t uploadBudget)
+        : m_atlas(layerSize, maxImageSize), m_budget(uploadBudget) {
+        // Unit quad, scaled to each picture by its instance matrix
+        std::vector<float> vertices = {
+            -0.5f, -0.5f, 0.0f,   0.0f, 0.0f,
+             0.5f, -0.5f, 0.0f,   1.0f, 0.0f,
+             0.5f,  0.5f, 0.0f,   1.0f, 1.0f,
+            -0.5f,  0.5f, 0.0f,   0.0f, 1.0f
+        };
+        std::vector<unsigned> indices = {
+            0,1,2,
+            2,3,0
+        };
+
+        vertex_layout layout;
+        layout.add<float>(3); // pos
+        layout.add<float>(2); // uv
+        m_quad.upload(vertices, indices, layout);
+    }
+
+    PictureBatch::~PictureBatch() {
+        // The job writes into the atlas
+        if (m_job.valid())
+            m_job.wait();
+    }
+
+    void PictureBatch::add(const TexModel& picture) {
+        if (m_job.valid() || m_packed) {
+            std::cerr << "[PictureBatch] Already built, " << picture.path() << " ignored\n";
+            return;
+        }
+        m_pictures.push_back(&picture);
+    }
+
+    bool PictureBatch::pack(ThreadPool& pool) {
+        m_regions.clear();
+        for (const TexModel* p : m_pictures)
+            m_regions.push_back(m_atlas.add(p->path(), p->flipped()));
+        return m_atlas.pack(pool);
+    }
+
+    void PictureBatch::buildAsync(ThreadPool& pool) {
+        if (m_job.valid() || m_packed)
+            return;
+        m_job = pool.submit([this, &pool] { m_packResult = pack(pool); });
+    }
+
+    bool PictureBatch::build(ThreadPool& pool) {
+        if (m_job.valid())
+            m_job.get();
+        else if (!m_packed)
+            m_packResult = pack(pool);
+        m_packed = true;
+        m_failed = !m_packResult || !m_atlas.upload();
+        if (m_failed)
+            return false;
+        update();
+        return true;
+    }
+
+    GLsizei PictureBatch::update(const Frustum* frustum) {
+        if (m_job.valid()) {
+            if (m_job.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                return 0;
+            m_job.get();
+            m_packed = true;
+            m_failed = !m_packResult;
+        }
+        if (!m_packed || m_failed || !m_atlas.upload(m_budget))
+            return 0;
+
+        m_instances.clear();
+        for (std::size_t i = 0; i < m_pictures.size(); i++) {
+            if (m_regions[i] < 0)
+                continue;
+            const TexModel& p = *m_pictures[i];
+            if (frustum) {
+                const glm::vec4 s = p.worldSphere();
+                if (!frustum->intersectsSphere(glm::vec3(s), s.w))
+                    continue;
+            }
+            const atlas_region& r = m_atlas.region(m_regions[i]);
+            m_instances.push_back({
+                glm::scale(p.modelMatrix(), glm::vec3(p.widthWorld(), p.heightWorld(), 1.0f)),
+                r.uvRect,
+                static_cast<float>(r.layer) });
+        }
+
+        m_instanceCount = static_cast<GLsizei>(m_instances.size());
+        if (m_instanceCount > 0) {
+            vertex_layout layout(m_quad.instanceBaseIndex(), 1);
+            for (int c = 0; c < 4; c++)
+                layout.add<float>(4); // mat4 = 4 vec4 columns
+            layout.add<float>(4);     // uvRect
+            layout.add<float>(1);     // layer
+            m_quad.uploadInstances(m_instances.data(), m_instances.size() * sizeof(picture_instance), layout);
+        }
+        return m_instanceCount;
+    }
+
+    RenderQueue::Draw PictureBatch::draw(Shader& shader) const {
+        RenderQueue::Draw d;
+        d.shader = &shader;
+        d.mesh = &m_quad;
+        d.texture = m_atlas.texture().id();
+        d.textureTarget = GL_TEXTURE_2D_ARRAY;
+        d.matrixUniform = {}; // per-instance matrices, camera from the Frame block
+        d.instances = m_instanceCount;
+        return d;
+    }
+
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <future>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "Frustum.hpp"
+#include "Mesh.hpp"
+#include "RenderQueue.hpp"
+#include "TextureAtlas.hpp"
+#include "ThreadPool.hpp"
+
+namespace gl {
+
+    class Shader;
+    class TexModel;
+
+    // Per-instance attributes of shaders/pictures, locations 2..7
+    struct picture_instance {
+        glm::mat4 model;  // the picture's transform, scaled to its size
+        glm::vec4 uvRect; // atlas_region::uvRect
+        float layer;
+    };
+
+    static_assert(sizeof(picture_instance) == 21 * sizeof(float), "picture_instance must be tightly packed");
+
+    /**
+     * @brief Draws any number of TexModel pictures with one instanced call.
+     *
+     * Their images go into one TextureAtlas; every picture becomes an
+     * instance of a shared unit quad carrying its model matrix, atlas
+     * rectangle and layer. update() refreshes the instances of the
+     * pictures inside the frustum once per frame, draw() hands the lot to
+     * the RenderQueue as a single draw with a single texture binding.
+     *
+     * Pictures are read again from TexModel::path(), so they may be loaded
+     * with TexModel::loadQuad() and never get a texture of their own. They
+     * must stay where they are while the batch exists.
+     */
+    class PictureBatch {
+    public:
+        explicit PictureBatch(int layerSize = 2048, int maxImageSize = 2048,
+            std::size_t uploadBudget = 4u << 20);
+        ~PictureBatch();
+
+        PictureBatch(const PictureBatch&) = delete;
+        PictureBatch& operator=(const PictureBatch&) = delete;
+
+        void add(const TexModel& picture);
+
+        // Decodes and packs on the pool; update() uploads the result within
+        // the budget and ready() turns true after the last row
+        void buildAsync(ThreadPool& pool = ThreadPool::shared());
+        // Decodes, packs and uploads right away
+        bool build(ThreadPool& pool = ThreadPool::shared());
+
+        // GL thread, once per frame. Continues a pending build, then writes
+        // one instance per picture inside `frustum` (every picture without
+        // one); returns the instance count, 0 until ready()
+        GLsizei update(const Frustum* frustum = nullptr);
+
+        bool ready() const { return m_atlas.uploaded(); }
+        bool failed() const { return m_failed; }
+
+        // One instanced draw of what the last update() kept
+        RenderQueue::Draw draw(Shader& shader) const;
+
+        std::size_t size() const { return m_pictures.size(); }
+        GLsizei instances() const { return m_instanceCount; }
+        const TextureAtlas& atlas() const { return m_atlas; }
+        const Mesh& mesh() const { return m_quad; }
+
+    private:
+        // Worker side of build(): decode and pack, no GL
+        bool pack(ThreadPool& pool);
+
+        std::vector<const TexModel*> m_pictures;
+        std::vector<int> m_regions; // atlas index per picture, -1 if it failed to load
+
+        TextureAtlas m_atlas;
+        std::size_t m_budget;
+        std::future<void> m_job;
+        bool m_packResult = false; // written by the job, read after it
+        bool m_packed = false;
+        bool m_failed = false;
+
+        Mesh m_quad;
+        std::vector<picture_instance> m_instances;
+        GLsizei m_instanceCount = 0;
+    };
+
+}
@@ -0,0 +1,152 @@
+#include "RenderQueue.hpp"
+#include "Mesh.hpp"
+#include "Shader.hpp"
+#include "StateCache.hpp"
+
+#include <cstring>
+
+namespace gl {
+
+    render_stats& render_stats::global() {
+        static render_stats stats;
+        return stats;
+    }
+
+    namespace {
+        // Key fields, most significant first. GL names are small integers
+        // handed out in order, so their low bits are enough to group equal
+        // state; a collision only costs an extra switch, never a wrong one.
+        constexpr int passBits = 2, shaderBits = 10, textureBits = 16, meshBits = 16, depthBits = 20;
+
+        std::uint64_t field(std::uint64_t value, int bits) {
+            return value & ((std::uint64_t(1) << bits) - 1);
+        }
+
+        // Positive floats order like their bit patterns; keep the top bits
+        // below the sign
+        std::uint64_t depthField(float depth, bool backToFront) {
+            if (!(depth > 0.0f))
+                depth = 0.0f;
+            std::uint32_t bits;
+            std::memcpy(&bits, &depth, sizeof(bits));
+            std::uint64_t d = bits >> (31 - depthBits);
+            return backToFront ? field(~d, depthBits) : d;
+        }
+
+        // Binding changes a sequence of draws needs, for render_stats::unsorted
+        struct state_tracker {
+            GLuint program = ~0u;
+            GLuint texture = ~0u;
+            GLuint vao = ~0u;
+
+            bool setProgram(GLuint p) { return p != program ? (program = p, true) : false; }
+            bool setTexture(GLuint t) { return t != texture ? (texture = t, true) : false; }
+            bool setVao(GLuint v) { return v != vao ? (vao = v, true) : false; }
+        };
+    }
+
+    std::uint64_t RenderQueue::key(const Draw& draw) {
+        const std::uint64_t shader = field(draw.shader ? draw.shader->getProgramID() : 0, shaderBits);
+        const std::uint64_t texture = field(draw.texture, textureBits);
+        const std::uint64_t mesh = field(draw.mesh ? draw.mesh->vao() : 0, meshBits);
+        const std::uint64_t pass = field(static_cast<std::uint64_t>(draw.pass), passBits);
+
+        std::uint64_t k = pass << (64 - passBits);
+        if (draw.pass == Pass::transparent) {
+            // Blending needs the order right before it needs fewer switches
+            k |= depthField(draw.depth, true) << (shaderBits + textureBits + meshBits);
+            k |= shader << (textureBits + meshBits);
+            k |= texture << meshBits;
+            k |= mesh;
+        } else {
+            k |= shader << (textureBits + meshBits + depthBits);
+            k |= texture << (meshBits + depthBits);
+            k |= mesh << depthBits;
+            k |= depthField(draw.depth, false);
+        }
+        return k;
+    }
+
+    void RenderQueue::submit(const Draw& draw) {
+        if (!draw.shader || !draw.mesh)
+            return;
+        m_items.push_back({ key(draw), static_cast<std::uint32_t>(m_draws.size()) });
+        m_draws.push_back(draw);
+    }
+
+    void RenderQueue::clear() {
+        m_draws.clear();
+        m_items.clear();
+    }
+
+    // LSD radix sort, one byte per pass; stable, so equal keys keep
+    // submission order. Bytes that are the same in every key are skipped.
+    void RenderQueue::sort() {
+        const std::size_t n = m_items.size();
+        m_scratch.resize(n);
+
+        for (int shift = 0; shift < 64; shift += 8) {
+            std::size_t counts[256] = {};
+            for (const Item& it : m_items)
+                counts[(it.key >> shift) & 0xFF]++;
+            if (counts[(m_items[0].key >> shift) & 0xFF] == n)
+                continue;
+
+            std::size_t offset = 0;
+            for (std::size_t& c : counts) {
+                std::size_t count = c;
+                c = offset;
+                offset += count;
+            }
+            for (const Item& it : m_items)
+                m_scratch[counts[(it.key >> shift) & 0xFF]++] = it;
+            m_items.swap(m_scratch);
+        }
+    }
+
+    void RenderQueue::flush() {
+        auto& stats = render_stats::global();
+        if (m_draws.empty())
+            return;
+
+        // What submission order would have cost, without issuing anything
+        {
+            state_tracker naive;
+            for (const Draw& d : m_draws) {
+                stats.unsorted += naive.setProgram(d.shader->getProgramID());
+                if (d.texture)
+                    stats.unsorted += naive.setTexture(d.texture);
+                stats.unsorted += naive.setVao(d.mesh->vao());
+            }
+        }
+
+        sort();
+
+        // StateCache drops whatever is already bound, including state left
+        // over from the previous frame
+        StateCache& state = StateCache::current();
+        for (const Item& it : m_items) {
+            const Draw& d = m_draws[it.draw];
+
+            if (d.shader->use())
+                stats.programs++;
+            if (d.texture && state.bindTexture(0, d.textureTarget, d.texture))
+                stats.textures++;
+            if (state.bindVertexArray(d.mesh->vao()))
+                stats.vaos++;
+
+            if (!d.matrixUniform.empty())
+                d.shader->setUniform(d.matrixUniform, d.matrix);
+            if (d.mode >= 0) {
+                d.shader->setUniform("u_mode", d.mode);
+                d.shader->setUniform("u_solidColor", d.color);
+            }
+
+            d.mesh->drawBound(d.primitive, d.instances);
+            stats.draws++;
+        }
+
+        clear();
+    }
+
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+namespace gl {
+
+    class Mesh;
+    class Shader;
+
+    /**
+     * @brief Per-frame render queue counters. `unsorted` is how many state
+     * changes the draws would have needed in submission order, to compare
+     * against what the sorted flush actually issued.
+     */
+    struct render_stats {
+        std::size_t draws = 0;     // draw calls issued
+        std::size_t programs = 0;  // glUseProgram
+        std::size_t textures = 0;  // glBindTexture
+        std::size_t vaos = 0;      // glBindVertexArray
+        std::size_t unsorted = 0;  // programs + textures + vaos in submission order
+
+        std::size_t changes() const { return programs + textures + vaos; }
+        void reset() { *this = render_stats(); }
+
+        static render_stats& global();
+    };
+
+    /**
+     * @brief Collects a frame's draws, sorts them by state and issues them
+     * with as few program, texture and VAO switches as possible.
+     *
+     * Each submitted draw gets a 64-bit key; flush() radix-sorts the
+     * (key, index) pairs and walks them through StateCache, so GL only
+     * hears about a program, texture or VAO when it actually changes.
+     * Opaque draws sort by state first and front to back within equal
+     * state; transparent ones strictly back to front, state second.
+     *
+     * Per-draw uniforms go through Shader::setUniform, which already skips
+     * unchanged values.
+     */
+    class RenderQueue {
+    public:
+        enum class Pass : std::uint8_t {
+            opaque = 0,
+            transparent = 1,
+            overlay = 2,
+        };
+
+        struct Draw {
+            Shader* shader = nullptr;
+            const Mesh* mesh = nullptr;
+            GLuint texture = 0;                      // on unit 0; 0 leaves the unit alone
+            GLenum textureTarget = GL_TEXTURE_2D;    // or GL_TEXTURE_2D_ARRAY for atlases
+            std::string_view matrixUniform = "model"; // empty: no per-draw matrix
+            glm::mat4 matrix{ 1.0f };                // model matrix; the camera is in the Frame block
+            int mode = -1;                           // "u_mode" if >= 0
+            glm::vec4 color{ 1.0f };                 // "u_solidColor", sent along with mode
+            GLsizei instances = 0;                   // > 0 draws that many instances
+            GLenum primitive = GL_TRIANGLES;
+            Pass pass = Pass::opaque;
+            float depth = 0.0f;                      // distance to the camera, >= 0
+        };
+
+        // Copies the draw; pointers must stay valid until flush()
+        void submit(const Draw& draw);
+
+        // Sorts, issues and clears; counts into render_stats
+        void flush();
+
+        void clear();
+        std::size_t size() const { return m_draws.size(); }
+
+        static std::uint64_t key(const Draw& draw);
+
+    private:
+        struct Item {
+            std::uint64_t key;
+            std::uint32_t draw;
+        };
+
+        void sort();
+
+        std::vector<Draw> m_draws;
+        std::vector<Item> m_items, m_scratch;
+    };
+
+}
@@ -0,0 +1,323 @@
+#include "SceneGraph.hpp"
+#include "Model.hpp"
+#include "TexModel.hpp"
+#include "Shader.hpp"
+
+#include <algorithm>
+
+namespace gl {
+
+    namespace {
+        const std::uint32_t noPosition = ~0u;
+    }
+
+    // ---------------------------
+    // Hierarchy
+    // ---------------------------
+    SceneGraph::node SceneGraph::create(node parent) {
+        return allocate(parent);
+    }
+
+    SceneGraph::node SceneGraph::create(Model& model, node parent) {
+        node n = allocate(parent);
+        m_model[n] = &model;
+        return n;
+    }
+
+    SceneGraph::node SceneGraph::create(TexModel& model, node parent) {
+        node n = allocate(parent);
+        m_texModel[n] = &model;
+        return n;
+    }
+
+    SceneGraph::node SceneGraph::allocate(node parent) {
+        node n;
+        if (!m_free.empty()) {
+            n = m_free.back();
+            m_free.pop_back();
+        }
+        else {
+            n = static_cast<node>(m_used.size());
+            m_parent.push_back(none);
+            m_firstChild.push_back(none);
+            m_nextSibling.push_back(none);
+            m_prevSibling.push_back(none);
+            m_lastChild.push_back(none);
+            m_slot.push_back(TransformStore::invalid);
+            m_model.push_back(nullptr);
+            m_texModel.push_back(nullptr);
+            m_used.push_back(0);
+            m_dirty.push_back(0);
+            m_position.push_back(noPosition);
+        }
+
+        m_slot[n] = m_locals.create();
+        m_model[n] = nullptr;
+        m_texModel[n] = nullptr;
+        m_used[n] = 1;
+        m_dirty[n] = 0;
+        link(n, parent < m_used.size() && m_used[parent] ? parent : none);
+        m_reorder = true;
+        return n;
+    }
+
+    void SceneGraph::destroy(node n) {
+        if (n >= m_used.size() || !m_used[n])
+            return;
+        unlink(n);
+
+        std::vector<node> stack{ n };
+        while (!stack.empty()) {
+            node cur = stack.back();
+            stack.pop_back();
+            for (node c = m_firstChild[cur]; c != none; c = m_nextSibling[c])
+                stack.push_back(c);
+
+            m_locals.destroy(m_slot[cur]);
+            m_slot[cur] = TransformStore::invalid;
+            m_parent[cur] = m_firstChild[cur] = m_lastChild[cur] = none;
+            m_nextSibling[cur] = m_prevSibling[cur] = none;
+            m_model[cur] = nullptr;
+            m_texModel[cur] = nullptr;
+            m_used[cur] = 0;
+            m_dirty[cur] = 0;
+            m_position[cur] = noPosition;
+            m_free.push_back(cur);
+        }
+        m_reorder = true;
+    }
+
+    bool SceneGraph::setParent(node n, node parent) {
+        if (n >= m_used.size() || !m_used[n])
+            return false;
+        if (parent != none && (parent >= m_used.size() || !m_used[parent]))
+            return false;
+        for (node p = parent; p != none; p = m_parent[p]) {
+            if (p == n)
+                return false;
+        }
+        if (m_parent[n] == parent)
+            return true;
+
+        unlink(n);
+        link(n, parent);
+        m_reorder = true;
+        return true;
+    }
+
+    // Appends `n` to the children of `parent` (or to the roots)
+    void SceneGraph::link(node n, node parent) {
+        node& first = parent == none ? m_firstRoot : m_firstChild[parent];
+        node& last = parent == none ? m_lastRoot : m_lastChild[parent];
+
+        m_parent[n] = parent;
+        m_prevSibling[n] = last;
+        m_nextSibling[n] = none;
+        if (last != none)
+            m_nextSibling[last] = n;
+        else
+            first = n;
+        last = n;
+    }
+
+    void SceneGraph::unlink(node n) {
+        node parent = m_parent[n];
+        node& first = parent == none ? m_firstRoot : m_firstChild[parent];
+        node& last = parent == none ? m_lastRoot : m_lastChild[parent];
+
+        if (m_prevSibling[n] != none)
+            m_nextSibling[m_prevSibling[n]] = m_nextSibling[n];
+        else
+            first = m_nextSibling[n];
+        if (m_nextSibling[n] != none)
+            m_prevSibling[m_nextSibling[n]] = m_prevSibling[n];
+        else
+            last = m_prevSibling[n];
+
+        m_parent[n] = m_prevSibling[n] = m_nextSibling[n] = none;
+    }
+
+    // ---------------------------
+    // Local transform
+    // ---------------------------
+    void SceneGraph::setPosition(node n, const glm::vec3& p) {
+        m_locals.setPosition(m_slot[n], p);
+        markDirty(n);
+    }
+
+    void SceneGraph::setRotation(node n, const glm::quat& q) {
+        m_locals.setRotation(m_slot[n], q);
+        markDirty(n);
+    }
+
+    void SceneGraph::setScale(node n, const glm::vec3& s) {
+        m_locals.setScale(m_slot[n], s);
+        markDirty(n);
+    }
+
+    void SceneGraph::translate(node n, const glm::vec3& delta) {
+        setPosition(n, position(n) + delta);
+    }
+
+    void SceneGraph::markDirty(node n) {
+        if (!m_dirty[n]) {
+            m_dirty[n] = 1;
+            m_dirtyNodes.push_back(n);
+        }
+    }
+
+    // ---------------------------
+    // World transforms
+    // ---------------------------
+    void SceneGraph::rebuildOrder() {
+        const std::size_t live = m_used.size() - m_free.size();
+        m_order.resize(live);
+        m_orderParent.resize(live);
+        m_subtreeEnd.resize(live);
+        m_world.resize(live);
+
+        // Iterative depth-first walk over the sibling lists
+        std::uint32_t pos = 0;
+        for (node root = m_firstRoot; root != none; root = m_nextSibling[root]) {
+            node n = root;
+            while (true) {
+                m_position[n] = pos;
+                m_order[pos] = n;
+                m_orderParent[pos] = m_parent[n] == none ? noPosition : m_position[m_parent[n]];
+                pos++;
+
+                if (m_firstChild[n] != none) {
+                    n = m_firstChild[n];
+                    continue;
+                }
+
+                // Close finished subtrees until one has a next sibling
+                while (true) {
+                    m_subtreeEnd[m_position[n]] = pos;
+                    if (n == root || m_nextSibling[n] != none)
+                        break;
+                    n = m_parent[n];
+                }
+                if (n == root)
+                    break;
+                n = m_nextSibling[n];
+            }
+        }
+        m_reorder = false;
+    }
+
+    void SceneGraph::update() {
+        m_stats = Stats();
+
+        std::vector<std::uint32_t> starts;
+        if (m_reorder) {
+            rebuildOrder();
+            m_stats.reordered = true;
+            if (!m_order.empty())
+                starts.push_back(0);
+            for (node n : m_dirtyNodes)
+                m_dirty[n] = 0;
+        }
+        else {
+            starts.reserve(m_dirtyNodes.size());
+            for (node n : m_dirtyNodes) {
+                if (!m_dirty[n])
+                    continue;
+                m_dirty[n] = 0;
+                starts.push_back(m_position[n]);
+            }
+            std::sort(starts.begin(), starts.end());
+        }
+        m_dirtyNodes.clear();
+
+        // A full rebuild is one "subtree" spanning every root
+        std::uint32_t covered = 0;
+        for (std::uint32_t start : starts) {
+            if (start < covered)
+                continue; // inside a subtree already walked
+            std::uint32_t end = m_stats.reordered ? static_cast<std::uint32_t>(m_order.size()) : m_subtreeEnd[start];
+
+            for (std::uint32_t p = start; p < end; p++) {
+                const glm::mat4& local = m_locals.world(m_slot[m_order[p]]);
+                std::uint32_t parent = m_orderParent[p];
+                m_world[p] = parent == noPosition ? local : m_world[parent] * local;
+            }
+            m_stats.updated += end - start;
+            m_stats.subtrees++;
+            covered = end;
+        }
+    }
+
+    const std::vector<std::uint32_t>& SceneGraph::collect(node root, const Frustum* frustum) const {
+        // After a hierarchy change the order and world matrices are those
+        // of the last update(): ids in it may have been destroyed or
+        // reused, and new nodes have no position yet. Draw nothing until
+        // the next update() rather than stale or out-of-range entries.
+        m_drawList.clear();
+        if (m_reorder)
+            return m_drawList;
+
+        std::uint32_t begin = 0, end = static_cast<std::uint32_t>(m_order.size());
+        if (root != none) {
+            if (root >= m_position.size() || m_position[root] == noPosition)
+                return m_drawList;
+            begin = m_position[root];
+            end = m_subtreeEnd[begin];
+        }
+
+        // One sphere per drawable node, tested together before any uniform goes out
+        if (frustum) {
+            m_cull.clear();
+            for (std::uint32_t p = begin; p < end; p++) {
+                node n = m_order[p];
+                if (m_model[n])
+                    m_cull.add(m_model[n]->mesh().bounds().sphere(m_world[p]));
+                else if (m_texModel[n])
+                    m_cull.add(m_texModel[n]->mesh().bounds().sphere(m_world[p]));
+            }
+            m_cull.cull(*frustum);
+        }
+
+        std::size_t drawable = 0;
+        for (std::uint32_t p = begin; p < end; p++) {
+            node n = m_order[p];
+            if (!m_model[n] && !m_texModel[n])
+                continue;
+            if (frustum && !m_cull.visible(drawable++))
+                continue;
+            m_drawList.push_back(p);
+        }
+        return m_drawList;
+    }
+
+    void SceneGraph::draw(const Shader& shader, std::string_view uniform,
+        node root, const Frustum* frustum) const {
+        for (std::uint32_t p : collect(root, frustum)) {
+            node n = m_order[p];
+            shader.setUniform(uniform, m_world[p]);
+            if (m_model[n])
+                m_model[n]->draw();
+            else
+                m_texModel[n]->draw();
+        }
+    }
+
+    void SceneGraph::submit(RenderQueue& queue, const RenderQueue::Draw& draw, const glm::mat4& viewProj,
+        node root, const Frustum* frustum) const {
+        RenderQueue::Draw d = draw;
+        for (std::uint32_t p : collect(root, frustum)) {
+            node n = m_order[p];
+            if (m_model[n]) {
+                d.mesh = &m_model[n]->lodMesh(m_model[n]->lod());
+                d.texture = draw.texture;
+            } else {
+                d.mesh = &m_texModel[n]->mesh();
+                d.texture = m_texModel[n]->texture().id();
+            }
+            d.matrix = m_world[p];
+            d.depth = (viewProj * m_world[p][3]).w; // clip w of the node's origin
+            queue.submit(d);
+        }
+    }
+
+}
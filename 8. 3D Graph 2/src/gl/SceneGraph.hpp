@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "TransformStore.hpp"
+#include "Frustum.hpp"
+#include "RenderQueue.hpp"
+
+namespace gl {
+
+    class Model;
+    class TexModel;
+    class Shader;
+
+    /**
+     * @brief Parent/child hierarchy of transforms, optionally carrying a
+     * Model or TexModel to draw at the node.
+     *
+     * Nodes are kept in a flat array in depth-first order, so a node's
+     * parent always comes before it and its subtree is the contiguous
+     * range right after it. update() walks that array once per dirty
+     * subtree: moving one node costs the size of its subtree, not of
+     * the whole graph. The order is rebuilt lazily after any change to
+     * the hierarchy itself (create, destroy, setParent).
+     *
+     * A node's own position/rotation/scale is local to its parent. For
+     * nodes wrapping a model, it takes the place of the model's own
+     * transform, which the graph never reads.
+     */
+    class SceneGraph {
+    public:
+        using node = std::uint32_t;
+        static constexpr node none = ~0u;
+
+        struct Stats {
+            std::size_t updated = 0;  // world matrices recomputed by the last update()
+            std::size_t subtrees = 0; // dirty subtrees it walked
+            bool reordered = false;   // hierarchy changed, order rebuilt
+        };
+
+        node create(node parent = none);
+        node create(Model& model, node parent = none);
+        node create(TexModel& model, node parent = none);
+
+        // Removes `n` and everything below it
+        void destroy(node n);
+
+        // none makes `n` a root; refuses to parent a node under itself
+        bool setParent(node n, node parent);
+        node parent(node n) const { return m_parent[n]; }
+
+        // Local transform, relative to the parent
+        void setPosition(node n, const glm::vec3& p);
+        void setRotation(node n, const glm::quat& q);
+        void setScale(node n, const glm::vec3& s);
+        void translate(node n, const glm::vec3& delta);
+
+        glm::vec3 position(node n) const { return m_locals.position(m_slot[n]); }
+        glm::quat rotation(node n) const { return m_locals.rotation(m_slot[n]); }
+        glm::vec3 scale(node n) const { return m_locals.scale(m_slot[n]); }
+
+        // Recomputes world matrices of every dirty subtree
+        void update();
+
+        // parent world * local, as of the last update()
+        const glm::mat4& world(node n) const { return m_world[m_position[n]]; }
+
+        // Sets `uniform` to the world matrix and draws every model in the
+        // subtree of `root` (the whole graph for none), in depth-first order.
+        // With a frustum, models whose bounding sphere is outside it are skipped.
+        // Draws nothing while a hierarchy change is waiting for update().
+        void draw(const Shader& shader, std::string_view uniform,
+            node root = none, const Frustum* frustum = nullptr) const;
+
+        // Same selection as draw(), queued instead: one copy of `draw` per
+        // model with its mesh, texture and world matrix filled in, and the
+        // depth taken through viewProj
+        void submit(RenderQueue& queue, const RenderQueue::Draw& draw, const glm::mat4& viewProj,
+            node root = none, const Frustum* frustum = nullptr) const;
+
+        std::size_t size() const { return m_order.size(); }
+        const Stats& stats() const { return m_stats; }
+
+    private:
+        node allocate(node parent);
+        void link(node n, node parent);
+        void unlink(node n);
+        void markDirty(node n);
+        void rebuildOrder();
+
+        // Indexed by node id
+        std::vector<node> m_parent;
+        std::vector<node> m_firstChild, m_lastChild;
+        std::vector<node> m_prevSibling, m_nextSibling;
+        std::vector<TransformStore::id> m_slot;
+        std::vector<Model*> m_model;
+        std::vector<TexModel*> m_texModel;
+        std::vector<std::uint8_t> m_used, m_dirty;
+        std::vector<std::uint32_t> m_position; // index into the ordered arrays
+        std::vector<node> m_free;
+        std::vector<node> m_dirtyNodes;
+        node m_firstRoot = none, m_lastRoot = none;
+
+        // Depth-first order
+        std::vector<node> m_order;
+        std::vector<std::uint32_t> m_orderParent; // position of the parent, or ~0u
+        std::vector<std::uint32_t> m_subtreeEnd;  // one past the last descendant
+        std::vector<glm::mat4> m_world;
+        bool m_reorder = false;
+
+        TransformStore m_locals;
+        Stats m_stats;
+        mutable CullBatch m_cull;
+        mutable std::vector<std::uint32_t> m_drawList; // positions, see collect()
+
+        // Positions of the drawable nodes under `root` that pass the frustum
+        const std::vector<std::uint32_t>& collect(node root, const Frustum* frustum) const;
+    };
+
+}
@@ -1,4 +1,5 @@
 #include "Shader.hpp"
+#include "StateCache.hpp"
 
 #include <fstream>
 #include <sstream>
@@ -32,9 +33,13 @@ namespace gl {
                 glDeleteShader(shader);
             }
             m_shaderObjects.clear();
+            StateCache::current().forgetProgram(m_programID);
             glDeleteProgram(m_programID);
             m_programID = 0;
             m_isLinked = false;
+            m_uniforms.clear();
+            m_uniformTable.clear();
+            m_uniformNames = 0;
         }
     }
 
@@ -90,14 +95,16 @@ namespace gl {
         }
 
         m_isLinked = true;
+        reflectUniforms();
+        bindBlocks();
         return true;
     }
 
-    void Shader::use() {
+    bool Shader::use() {
         if(!m_isLinked) {
             linkProgram();
         }
-        glUseProgram(m_programID);
+        return StateCache::current().useProgram(m_programID);
     }
 
     bool gl::Shader::attach(const std::filesystem::path& directory) {
@@ -195,85 +202,198 @@ namespace gl {
         }
     }
 
-    // -------------------- Uniform Utilities --------------------
-    void gl::Shader::setUniform(const std::string& name, int value) const {
-        GLint loc = glGetUniformLocation(m_programID, name.c_str());
-        if (loc == -1) {
-            std::cerr << "Uniform not found: " << name << "\n";
-            return;
+    // -------------------- Uniform Reflection --------------------
+    void Shader::reflectUniforms() {
+        m_uniforms.clear();
+        m_uniformTable.clear();
+        m_uniformNames = 0;
+
+        GLint count = 0, maxLength = 0;
+        glGetProgramiv(m_programID, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(m_programID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+        std::string name(static_cast<std::size_t>(maxLength), '\0');
+        for (GLint i = 0; i < count; i++) {
+            GLsizei length = 0;
+            uniform_slot slot;
+            glGetActiveUniform(m_programID, i, maxLength, &length, &slot.size, &slot.type, name.data());
+            slot.name.assign(name.data(), length);
+
+            // Uniform block members have no location of their own
+            slot.location = glGetUniformLocation(m_programID, slot.name.c_str());
+            if (slot.location == -1)
+                continue;
+
+            int index = static_cast<int>(m_uniforms.size());
+            m_uniforms.push_back(std::move(slot));
+
+            // Arrays are reported as "name[0]": make "name" resolve too
+            std::string_view key = m_uniforms.back().name;
+            addUniformName(key, index);
+            if (key.ends_with("[0]"))
+                addUniformName(key.substr(0, key.size() - 3), index);
         }
-        glUniform1i(loc, value);
     }
 
-    void gl::Shader::setUniform(const std::string& name, float value) const {
-        GLint loc = glGetUniformLocation(m_programID, name.c_str());
-        if (loc == -1) {
-            std::cerr << "Uniform not found: " << name << "\n";
-            return;
+    namespace {
+        std::unordered_map<std::string, GLuint>& blockBindings() {
+            static std::unordered_map<std::string, GLuint> bindings;
+            return bindings;
         }
-        glUniform1f(loc, value);
     }
 
-    void gl::Shader::setUniform(const std::string& name, bool value) const {
-        GLint loc = glGetUniformLocation(m_programID, name.c_str());
-        if (loc == -1) {
-            std::cerr << "Uniform not found: " << name << "\n";
-            return;
-        }
-        glUniform1i(loc, value ? 1 : 0);
+    void Shader::bindBlock(const std::string& block, GLuint binding) {
+        blockBindings()[block] = binding;
     }
 
-    void gl::Shader::setUniform(const std::string& name, const glm::vec2& value) const {
-        GLint loc = glGetUniformLocation(m_programID, name.c_str());
-        if (loc == -1) {
-            std::cerr << "Uniform not found: " << name << "\n";
-            return;
+    void Shader::bindBlocks() {
+        GLint count = 0, maxLength = 0;
+        glGetProgramiv(m_programID, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+        glGetProgramiv(m_programID, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength);
+
+        std::string name(static_cast<std::size_t>(maxLength), '\0');
+        for (GLint i = 0; i < count; i++) {
+            GLsizei length = 0;
+            glGetActiveUniformBlockName(m_programID, i, maxLength, &length, name.data());
+
+            auto it = blockBindings().find(std::string(name.data(), length));
+            if (it == blockBindings().end()) {
+                std::cerr << "Warning: no buffer registered for uniform block " << std::string_view(name.data(), length) << "\n";
+                continue;
+            }
+            glUniformBlockBinding(m_programID, static_cast<GLuint>(i), it->second);
         }
-        glUniform2fv(loc, 1, glm::value_ptr(value));
     }
 
-    void gl::Shader::setUniform(const std::string& name, const glm::vec3& value) const {
-        GLint loc = glGetUniformLocation(m_programID, name.c_str());
-        if (loc == -1) {
-            std::cerr << "Uniform not found: " << name << "\n";
-            return;
+    void Shader::addUniformName(std::string_view name, int slot) const {
+        // Keep the load factor at or below 1/2
+        if ((m_uniformNames + 1) * 2 > m_uniformTable.size()) {
+            std::vector<uniform_bucket> old = std::move(m_uniformTable);
+            m_uniformTable.assign(old.empty() ? 16 : old.size() * 2, uniform_bucket{});
+            m_uniformNames = 0;
+            for (const auto& b : old) {
+                if (b.slot == -1)
+                    continue;
+                std::size_t mask = m_uniformTable.size() - 1;
+                std::size_t i = b.hash & mask;
+                while (m_uniformTable[i].slot != -1)
+                    i = (i + 1) & mask;
+                m_uniformTable[i] = b;
+                m_uniformNames++;
+            }
         }
-        glUniform3fv(loc, 1, glm::value_ptr(value));
+
+        std::size_t hash = std::hash<std::string_view>{}(name);
+        std::size_t mask = m_uniformTable.size() - 1;
+        std::size_t i = hash & mask;
+        while (m_uniformTable[i].slot != -1)
+            i = (i + 1) & mask;
+        m_uniformTable[i] = { hash, slot };
+        m_uniformNames++;
     }
 
-    void gl::Shader::setUniform(const std::string& name, const glm::vec4& value) const {
-        GLint loc = glGetUniformLocation(m_programID, name.c_str());
-        if (loc == -1) {
-            std::cerr << "Uniform not found: " << name << "\n";
-            return;
+    uniform_slot* Shader::findUniform(std::string_view name) const {
+        auto& stats = uniform_stats::global();
+        if (!m_isLinked)
+            return nullptr;
+
+        std::size_t hash = std::hash<std::string_view>{}(name);
+        if (!m_uniformTable.empty()) {
+            std::size_t mask = m_uniformTable.size() - 1;
+            for (std::size_t i = hash & mask; m_uniformTable[i].slot != -1; i = (i + 1) & mask) {
+                const auto& b = m_uniformTable[i];
+                if (b.hash != hash)
+                    continue;
+
+                // Aliases ("arr" for "arr[0]") are a prefix of the slot name
+                uniform_slot& slot = m_uniforms[b.slot];
+                if (std::string_view(slot.name).substr(0, name.size()) == name &&
+                    (slot.name.size() == name.size() || slot.name.compare(name.size(), std::string::npos, "[0]") == 0)) {
+                    stats.hits++;
+                    return &slot;
+                }
+            }
         }
-        glUniform4fv(loc, 1, glm::value_ptr(value));
+
+        // Not reflected (e.g. "arr[3]" or an inactive name): ask GL once
+        // and remember the answer, so a missing uniform only warns once
+        stats.misses++;
+        uniform_slot slot;
+        slot.name = std::string(name);
+        slot.location = glGetUniformLocation(m_programID, slot.name.c_str());
+        if (slot.location == -1)
+            std::cerr << "Uniform not found: " << name << "\n";
+
+        int index = static_cast<int>(m_uniforms.size());
+        m_uniforms.push_back(std::move(slot));
+        addUniformName(m_uniforms.back().name, index);
+        return &m_uniforms.back();
+    }
+
+    std::size_t Shader::activeUniformCount() const {
+        return m_uniforms.size();
     }
 
-    void gl::Shader::setUniform(const std::string& name, const glm::mat3& value) const {
-        GLint loc = glGetUniformLocation(m_programID, name.c_str());
-        if (loc == -1) {
+    // -------------------- Uniform Utilities --------------------
+    template<typename T, typename Upload>
+    void Shader::setCached(std::string_view name, const T& value, Upload upload) const {
+        uniform_slot* slot = findUniform(name);
+        if (!slot) {
             std::cerr << "Uniform not found: " << name << "\n";
             return;
         }
-        glUniformMatrix3fv(loc, 1, GL_FALSE, glm::value_ptr(value));
-    }
+        if (slot->location == -1)
+            return;
 
-    void gl::Shader::setUniform(const std::string& name, const glm::mat4& value) const {
-        GLint loc = glGetUniformLocation(m_programID, name.c_str());
-        if (loc == -1) {
-            std::cerr << "Uniform not found: " << name << "\n";
+        auto& stats = uniform_stats::global();
+        if (!slot->update(&value, sizeof(T))) {
+            stats.skipped++;
             return;
         }
-        glUniformMatrix4fv(loc, 1, GL_FALSE, glm::value_ptr(value));
+        stats.issued++;
+        upload(slot->location);
+    }
+
+    void gl::Shader::setUniform(std::string_view name, int value) const {
+        setCached(name, value, [&](GLint loc) { glProgramUniform1i(m_programID, loc, value); });
+    }
+
+    void gl::Shader::setUniform(std::string_view name, float value) const {
+        setCached(name, value, [&](GLint loc) { glProgramUniform1f(m_programID, loc, value); });
+    }
+
+    void gl::Shader::setUniform(std::string_view name, bool value) const {
+        setUniform(name, value ? 1 : 0);
+    }
+
+    void gl::Shader::setUniform(std::string_view name, const glm::vec2& value) const {
+        setCached(name, value, [&](GLint loc) { glProgramUniform2fv(m_programID, loc, 1, glm::value_ptr(value)); });
+    }
+
+    void gl::Shader::setUniform(std::string_view name, const glm::vec3& value) const {
+        setCached(name, value, [&](GLint loc) { glProgramUniform3fv(m_programID, loc, 1, glm::value_ptr(value)); });
+    }
+
+    void gl::Shader::setUniform(std::string_view name, const glm::vec4& value) const {
+        setCached(name, value, [&](GLint loc) { glProgramUniform4fv(m_programID, loc, 1, glm::value_ptr(value)); });
+    }
+
+    void gl::Shader::setUniform(std::string_view name, const glm::mat3& value) const {
+        setCached(name, value, [&](GLint loc) { glProgramUniformMatrix3fv(m_programID, loc, 1, GL_FALSE, glm::value_ptr(value)); });
+    }
+
+    void gl::Shader::setUniform(std::string_view name, const glm::mat4& value) const {
+        setCached(name, value, [&](GLint loc) { glProgramUniformMatrix4fv(m_programID, loc, 1, GL_FALSE, glm::value_ptr(value)); });
     }
 
     gl::unif gl::Shader::getUniform(const std::string& name) {
         if (!m_isLinked) {
             std::cerr << "Warning: getting uniform before program is linked.\n";
+            GLint loc = glGetUniformLocation(m_programID, name.c_str());
+            return gl::unif(m_programID, name, loc);
         }
-        GLint loc = glGetUniformLocation(m_programID, name.c_str());
-        return gl::unif(m_programID, name, loc);
+        uniform_slot* slot = findUniform(name);
+        return gl::unif(m_programID, name, slot->location, slot);
     }
 
 
@@ -2,8 +2,11 @@
 
 #include "unif.hpp"
 #include <string>
+#include <string_view>
 #include <filesystem>
 #include <unordered_map>
+#include <deque>
+#include <vector>
 #include <glad/glad.h>  // Make sure to include glad or GLEW before GLFW
 #include <glm/glm.hpp>
 
@@ -15,6 +18,17 @@ namespace gl {
         std::unordered_map<GLenum, GLuint> m_shaderObjects;
         bool m_isLinked;
 
+        // Active uniforms reflected after linking. Slots live in a deque so
+        // pointers handed out to gl::unif stay valid while names are added;
+        // the table is an open-addressed (linear probing) name -> slot index.
+        struct uniform_bucket {
+            std::size_t hash = 0;
+            int slot = -1;
+        };
+        mutable std::deque<uniform_slot> m_uniforms;
+        mutable std::vector<uniform_bucket> m_uniformTable;
+        mutable std::size_t m_uniformNames = 0;
+
     public:
         // Constructors / Destructor
         Shader();
@@ -26,7 +40,8 @@ namespace gl {
         bool attach(GLenum type, const std::string& source);
         bool attach(const std::filesystem::path& directory);
         bool linkProgram();
-        void use();
+        // Links on first use; false when the program was already current
+        bool use();
         void unload();
 
         // Getters
@@ -40,20 +55,38 @@ namespace gl {
     public:
 
         // Uniform utilities
-        void setUniform(const std::string& name, int value) const;
-        void setUniform(const std::string& name, float value) const;
-        void setUniform(const std::string& name, bool value) const;
+        // Names resolve through the reflected table and calls whose value
+        // matches the last one uploaded are skipped (see uniform_stats)
+        void setUniform(std::string_view name, int value) const;
+        void setUniform(std::string_view name, float value) const;
+        void setUniform(std::string_view name, bool value) const;
 
-        void setUniform(const std::string& name, const glm::vec2& value) const;
-        void setUniform(const std::string& name, const glm::vec3& value) const;
-        void setUniform(const std::string& name, const glm::vec4& value) const;
+        void setUniform(std::string_view name, const glm::vec2& value) const;
+        void setUniform(std::string_view name, const glm::vec3& value) const;
+        void setUniform(std::string_view name, const glm::vec4& value) const;
 
-        void setUniform(const std::string& name, const glm::mat3& value) const;
-        void setUniform(const std::string& name, const glm::mat4& value) const;
+        void setUniform(std::string_view name, const glm::mat3& value) const;
+        void setUniform(std::string_view name, const glm::mat4& value) const;
 
+        // The returned unif shares this shader's value shadow; it stays
+        // valid until the program is relinked or unloaded
         unif getUniform(const std::string& name);
 
+        std::size_t activeUniformCount() const;
+
+        // Uniform blocks named `block` in programs linked from now on are
+        // pointed at `binding` (GLSL 330 has no layout(binding = N))
+        static void bindBlock(const std::string& block, GLuint binding);
+
     private:
+        void reflectUniforms();
+        void bindBlocks();
+        uniform_slot* findUniform(std::string_view name) const;
+        void addUniformName(std::string_view name, int slot) const;
+
+        template<typename T, typename Upload>
+        void setCached(std::string_view name, const T& value, Upload upload) const;
+
         std::string loadFileContent(const std::filesystem::path& filePath);
         bool compileShader(GLuint shader, const std::string& source);
     };
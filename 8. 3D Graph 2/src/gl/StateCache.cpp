@@ -0,0 +1,169 @@
+#include "StateCache.hpp"
+
+namespace gl {
+
+    state_stats& state_stats::global() {
+        static state_stats stats;
+        return stats;
+    }
+
+    namespace {
+        thread_local StateCache* s_current = nullptr;
+    }
+
+    StateCache& StateCache::current() {
+        if (s_current)
+            return *s_current;
+        thread_local StateCache fallback;
+        return fallback;
+    }
+
+    void StateCache::makeCurrent(StateCache* cache) {
+        s_current = cache;
+    }
+
+    std::size_t StateCache::targetIndex(GLenum target) {
+        switch (target) {
+        case GL_TEXTURE_2D:       return t_2d;
+        case GL_TEXTURE_2D_ARRAY: return t_2dArray;
+        case GL_TEXTURE_CUBE_MAP: return t_cube;
+        default:                  return t_count;
+        }
+    }
+
+    std::size_t StateCache::capabilityIndex(GLenum capability) {
+        switch (capability) {
+        case GL_DEPTH_TEST:   return c_depth;
+        case GL_BLEND:        return c_blend;
+        case GL_CULL_FACE:    return c_cull;
+        case GL_SCISSOR_TEST: return c_scissor;
+        default:              return c_count;
+        }
+    }
+
+    bool StateCache::change(bool differs) {
+        if (m_debug) {
+            auto& stats = state_stats::global();
+            if (differs)
+                stats.issued++;
+            else
+                stats.elided++;
+        }
+        return differs;
+    }
+
+    bool StateCache::useProgram(GLuint program) {
+        if (!change(m_program != program))
+            return false;
+        m_program = program;
+        glUseProgram(program);
+        return true;
+    }
+
+    bool StateCache::bindVertexArray(GLuint vao) {
+        if (!change(m_vao != vao))
+            return false;
+        m_vao = vao;
+        glBindVertexArray(vao);
+        return true;
+    }
+
+    bool StateCache::activeTexture(GLuint unit) {
+        if (!change(m_activeUnit != unit))
+            return false;
+        m_activeUnit = unit;
+        glActiveTexture(GL_TEXTURE0 + unit);
+        return true;
+    }
+
+    bool StateCache::bindTexture(GLuint unit, GLenum target, GLuint texture) {
+        std::size_t t = targetIndex(target);
+        if (unit < textureUnits && t < t_count && m_textures[unit][t] == texture)
+            return change(false);
+
+        activeTexture(unit);
+        return bindTexture(target, texture);
+    }
+
+    bool StateCache::bindTexture(GLenum target, GLuint texture) {
+        std::size_t t = targetIndex(target);
+        bool known = m_activeUnit < textureUnits && t < t_count;
+        if (!change(!known || m_textures[m_activeUnit][t] != texture))
+            return false;
+        if (known)
+            m_textures[m_activeUnit][t] = texture;
+        glBindTexture(target, texture);
+        return true;
+    }
+
+    bool StateCache::enable(GLenum capability, bool on) {
+        std::size_t c = capabilityIndex(capability);
+        if (!change(c == c_count || m_capabilities[c] != static_cast<std::int8_t>(on)))
+            return false;
+        if (c < c_count)
+            m_capabilities[c] = on;
+        if (on)
+            glEnable(capability);
+        else
+            glDisable(capability);
+        return true;
+    }
+
+    bool StateCache::blendFunc(GLenum source, GLenum destination) {
+        if (!change(m_blendSource != source || m_blendDestination != destination))
+            return false;
+        m_blendSource = source;
+        m_blendDestination = destination;
+        glBlendFunc(source, destination);
+        return true;
+    }
+
+    bool StateCache::depthFunc(GLenum func) {
+        if (!change(m_depthFunc != func))
+            return false;
+        m_depthFunc = func;
+        glDepthFunc(func);
+        return true;
+    }
+
+    bool StateCache::depthMask(bool write) {
+        if (!change(m_depthMask != static_cast<std::int8_t>(write)))
+            return false;
+        m_depthMask = write;
+        glDepthMask(write ? GL_TRUE : GL_FALSE);
+        return true;
+    }
+
+    // GL falls back to 0 for whatever was bound
+    void StateCache::forgetProgram(GLuint program) {
+        if (m_program == program)
+            m_program = unknown;
+    }
+
+    void StateCache::forgetVertexArray(GLuint vao) {
+        if (m_vao == vao)
+            m_vao = 0;
+    }
+
+    void StateCache::forgetTexture(GLuint texture) {
+        for (auto& unit : m_textures) {
+            for (GLuint& bound : unit) {
+                if (bound == texture)
+                    bound = 0;
+            }
+        }
+    }
+
+    void StateCache::invalidate() {
+        m_program = m_vao = m_activeUnit = unknown;
+        for (auto& unit : m_textures) {
+            for (GLuint& bound : unit)
+                bound = unknown;
+        }
+        for (auto& c : m_capabilities)
+            c = -1;
+        m_blendSource = m_blendDestination = m_depthFunc = unknown;
+        m_depthMask = -1;
+    }
+
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glad/glad.h>
+
+namespace gl {
+
+    /**
+     * @brief GL state calls routed through StateCache, counted only while
+     * the cache is in debug mode. Reset by whoever prints them.
+     */
+    struct state_stats {
+        std::size_t issued = 0;  // calls that reached the driver
+        std::size_t elided = 0;  // calls dropped, the state already matched
+
+        void reset() { *this = state_stats(); }
+
+        static state_stats& global();
+    };
+
+    /**
+     * @brief Shadow of the binding state of one GL context: program, VAO,
+     * active unit, textures per unit and target, and the depth/blend/cull
+     * switches. Each setter returns true when it had to call GL, false
+     * when the state already matched and the call was dropped.
+     *
+     * Everything starts out unknown, so the first call of each kind always
+     * goes through. Code that changes state behind the cache's back must
+     * call invalidate(). Deleting a bound object unbinds it in GL, so
+     * owners call the forget* functions before deleting; otherwise a new
+     * object given the same name would look bound already.
+     *
+     * Window::init makes its context's cache current on the calling
+     * thread; without a window (benchmarks, tools) a fallback is used.
+     */
+    class StateCache {
+    public:
+        static constexpr GLuint textureUnits = 16;
+
+        StateCache() { invalidate(); }
+
+        static StateCache& current();
+        static void makeCurrent(StateCache* cache);
+
+        bool useProgram(GLuint program);
+        bool bindVertexArray(GLuint vao);
+
+        bool activeTexture(GLuint unit);
+        // Switches the active unit only if `texture` is not bound there yet
+        bool bindTexture(GLuint unit, GLenum target, GLuint texture);
+        // On whatever unit is active, the way uploads bind
+        bool bindTexture(GLenum target, GLuint texture);
+
+        bool enable(GLenum capability, bool on = true);
+        bool disable(GLenum capability) { return enable(capability, false); }
+        bool blendFunc(GLenum source, GLenum destination);
+        bool depthFunc(GLenum func);
+        bool depthMask(bool write);
+
+        void forgetProgram(GLuint program);
+        void forgetVertexArray(GLuint vao);
+        void forgetTexture(GLuint texture);
+
+        // Marks everything unknown
+        void invalidate();
+
+        // Counts every call into state_stats
+        void setDebug(bool debug) { m_debug = debug; }
+        bool debug() const { return m_debug; }
+
+    private:
+        static constexpr GLuint unknown = ~0u;
+
+        // Texture targets shadowed per unit; others always go through
+        enum : std::size_t { t_2d, t_2dArray, t_cube, t_count };
+        static std::size_t targetIndex(GLenum target);
+
+        // Capabilities shadowed by enable(); others always go through
+        enum : std::size_t { c_depth, c_blend, c_cull, c_scissor, c_count };
+        static std::size_t capabilityIndex(GLenum capability);
+
+        // Counts and returns whether the call must be made
+        bool change(bool differs);
+
+        GLuint m_program = unknown;
+        GLuint m_vao = unknown;
+        GLuint m_activeUnit = unknown;
+        GLuint m_textures[textureUnits][t_count];
+        std::int8_t m_capabilities[c_count]; // -1 unknown
+        GLenum m_blendSource = unknown, m_blendDestination = unknown;
+        GLenum m_depthFunc = unknown;
+        std::int8_t m_depthMask = -1;
+        bool m_debug = false;
+    };
+
+}
@@ -1,4 +1,7 @@
 #include "TexModel.hpp"
+#include "TextureFile.hpp"
+
+#include "../ext/stb_image.h"
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
@@ -13,11 +16,9 @@ namespace gl {
     // Constructor
     // --------------------------------------------------
     TexModel::TexModel()
-        : m_position(0.0f),
-        m_rotation(1, 0, 0, 0),
-        m_scale(1.0f),
-        m_widthWorld(0),
-        m_heightWorld(0) {
+        : m_widthWorld(0),
+        m_heightWorld(0),
+        m_flip(true) {
     }
 
     // --------------------------------------------------
@@ -25,14 +26,57 @@ namespace gl {
     // --------------------------------------------------
     bool TexModel::load(const std::string& path, float pixelsPerUnit, bool flipVertically) {
         std::cout << "is loading" << std::endl;
-        if (!m_texture.loadFromFile(path, flipVertically)) {
+        texture_handle texture = TextureCache::shared().load(path, flipVertically);
+        if (!texture) {
             return false;
         }
         std::cout << "loading ok" << std::endl;
 
-        int w = m_texture.width();
-        int h = m_texture.height();
+        m_texture = std::move(texture);
+        m_path = path;
+        m_flip = flipVertically;
+        buildQuad(m_texture->width(), m_texture->height(), pixelsPerUnit);
+        return true;
+    }
+
+    bool TexModel::load(TextureLoader& loader, const std::string& path, float pixelsPerUnit, bool flipVertically) {
+        int w = 0, h = 0;
+        if (!readHeader(path, w, h))
+            return false;
+
+        texture_handle texture = TextureCache::shared().load(loader, path, flipVertically);
+        if (!texture)
+            return false;
+
+        m_texture = std::move(texture);
+        m_path = path;
+        m_flip = flipVertically;
+        buildQuad(w, h, pixelsPerUnit);
+        return true;
+    }
+
+    bool TexModel::loadQuad(const std::string& path, float pixelsPerUnit, bool flipVertically) {
+        int w = 0, h = 0;
+        if (!readHeader(path, w, h))
+            return false;
+
+        m_texture.reset();
+        m_path = path;
+        m_flip = flipVertically;
+        buildQuad(w, h, pixelsPerUnit);
+        return true;
+    }
+
+    bool TexModel::readHeader(const std::string& path, int& w, int& h) const {
+        int channels = 0;
+        bool known = TextureFile::isContainer(path) ? TextureFile::info(path, w, h)
+                                                    : stbi_info(path.c_str(), &w, &h, &channels) != 0;
+        if (!known)
+            std::cerr << "[TexModel] Cannot read image header: " << path << "\n";
+        return known;
+    }
 
+    void TexModel::buildQuad(int w, int h, float pixelsPerUnit) {
         // convert pixels → world units
         m_widthWorld = w / pixelsPerUnit;
         m_heightWorld = h / pixelsPerUnit;
@@ -59,58 +103,69 @@ namespace gl {
         layout.add<float>(2); // uv
 
         m_mesh.upload(vertices, indices, layout);
-
-        return true;
+        m_pick.build(vertices.data(), 4, layout.stride(), indices.data(), indices.size());
     }
 
     // --------------------------------------------------
     // Transform methods
     // --------------------------------------------------
     void TexModel::setPosition(const glm::vec3& p) {
-        m_position = p;
+        m_transform.setPosition(p);
     }
 
     void TexModel::setRotation(const glm::quat& q) {
-        m_rotation = q;
+        m_transform.setRotation(q);
     }
 
     void TexModel::rotateX(float deg) {
         float radians = deg * std::numbers::pi / 180.f;
-        m_rotation = glm::angleAxis(radians, glm::vec3(1, 0, 0)) * m_rotation;
+        m_transform.setRotation(glm::angleAxis(radians, glm::vec3(1, 0, 0)) * m_transform.rotation());
     }
 
     void TexModel::rotateY(float deg) {
         float radians = deg * std::numbers::pi / 180.f;
-        m_rotation = glm::angleAxis(radians, glm::vec3(0, 1, 0)) * m_rotation;
+        m_transform.setRotation(glm::angleAxis(radians, glm::vec3(0, 1, 0)) * m_transform.rotation());
     }
 
     void TexModel::rotateZ(float deg) {
         float radians = deg * std::numbers::pi / 180.f;
-        m_rotation = glm::angleAxis(radians, glm::vec3(0, 0, 1)) * m_rotation;
+        m_transform.setRotation(glm::angleAxis(radians, glm::vec3(0, 0, 1)) * m_transform.rotation());
     }
 
     void TexModel::setScale(const glm::vec3& s) {
-        m_scale = s;
+        m_transform.setScale(s);
     }
 
     // --------------------------------------------------
     // Create model matrix
     // --------------------------------------------------
-    glm::mat4 TexModel::modelMatrix() const {
-        glm::mat4 m(1.0f);
-        m = glm::translate(m, m_position);
-        m *= glm::mat4_cast(m_rotation);
-        m = glm::scale(m, m_scale);
-        return m;
+    const glm::mat4& TexModel::modelMatrix() const {
+        return m_transform.world();
+    }
+
+    const glm::mat4& TexModel::mvp(const glm::mat4& viewProj) const {
+        return m_transform.mvp(viewProj);
+    }
+
+    glm::vec4 TexModel::worldSphere() const {
+        return m_mesh.bounds().sphere(modelMatrix());
+    }
+
+    aabb TexModel::worldBox() const {
+        return m_mesh.bounds().box(modelMatrix());
     }
 
     // --------------------------------------------------
     // Draw textured quad
     // --------------------------------------------------
-    void TexModel::draw(GLenum mode) const {
-        m_texture.bind(0);
+    const Texture& TexModel::texture() const {
+        static const Texture none;
+        return m_texture ? *m_texture : none;
+    }
 
-        glActiveTexture(GL_TEXTURE0);
+    void TexModel::draw(GLenum mode) const {
+        if (m_texture)
+            m_texture->bind(0);
         m_mesh.draw(mode);
     }
 }
\ No newline at end of file
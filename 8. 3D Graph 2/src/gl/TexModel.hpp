@@ -1,7 +1,11 @@
 #pragma once
 
 #include "Texture.hpp"
+#include "TextureCache.hpp"
 #include "mesh.hpp"
+#include "TransformStore.hpp"
+#include "Picker.hpp"
+#include "TextureLoader.hpp"
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
@@ -9,16 +13,22 @@ namespace gl {
 
     class TexModel {
     private:
-        Texture    m_texture;
+        texture_handle m_texture; // shared through TextureCache::shared()
         Mesh   m_mesh;
+        PickMesh m_pick;  // CPU copy of the quad for mouse picking
 
-        glm::vec3 m_position;
-        glm::quat m_rotation;
-        glm::vec3 m_scale;
+        // Position/rotation/scale live in TransformStore::shared()
+        transform_handle m_transform;
 
         float m_widthWorld;   // world-space width
         float m_heightWorld;  // world-space height
 
+        std::string m_path;   // what load() was given, for PictureBatch
+        bool m_flip;
+
+        bool readHeader(const std::string& path, int& width, int& height) const;
+        void buildQuad(int width, int height, float pixelsPerUnit);
+
     public:
         TexModel();
         ~TexModel() = default;
@@ -33,6 +43,18 @@ namespace gl {
             float pixelsPerUnit = 100.0f,   // converts px → world units
             bool flipVertically = true);
 
+        // Same quad, built right away from the image header; the texture
+        // shows a placeholder until `loader` has streamed the pixels in
+        bool load(TextureLoader& loader, const std::string& path,
+            float pixelsPerUnit = 100.0f,
+            bool flipVertically = true);
+
+        // The quad alone, sized from the image header; no texture, the
+        // pixels come from whoever draws it, e.g. a PictureBatch
+        bool loadQuad(const std::string& path,
+            float pixelsPerUnit = 100.0f,
+            bool flipVertically = true);
+
         // Transform
         void setPosition(const glm::vec3& p);
         void setRotation(const glm::quat& q);
@@ -41,7 +63,16 @@ namespace gl {
         void rotateZ(float deg);
         void setScale(const glm::vec3& s);
 
-        glm::mat4 modelMatrix() const;
+        const transform_handle& transform() const { return m_transform; }
+
+        // Rebuilt only after the transform changed
+        const glm::mat4& modelMatrix() const;
+        // viewProj * modelMatrix(), cached while neither side changes
+        const glm::mat4& mvp(const glm::mat4& viewProj) const;
+
+        // Quad bounds in world space; the sphere as (center, radius)
+        glm::vec4 worldSphere() const;
+        aabb worldBox() const;
 
         // Draw
         void draw(GLenum mode = GL_TRIANGLES) const;
@@ -49,8 +80,14 @@ namespace gl {
         // Getters
         float widthWorld()  const { return m_widthWorld; }
         float heightWorld() const { return m_heightWorld; }
+        const std::string& path() const { return m_path; }
+        bool flipped() const { return m_flip; }
+
+        const Mesh& mesh() const { return m_mesh; }
+        const PickMesh& pickMesh() const { return m_pick; }
 
-        Texture& texture() { return m_texture; }
-        const Texture& texture() const { return m_texture; }
+        // An empty texture until load() succeeded
+        const Texture& texture() const;
+        const texture_handle& textureHandle() const { return m_texture; }
     };
 }
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "Texture.hpp"
+#include "StateCache.hpp"
+#include "TextureFile.hpp"
 
 #include "../ext/stb_image.h"
 
@@ -10,7 +12,7 @@ namespace gl {
     // Constructor / Destructor
     // --------------------------------------
     Texture::Texture()
-        : m_id(0), m_width(0), m_height(0), m_channels(0) {
+        : m_id(0), m_width(0), m_height(0), m_channels(0), m_bytes(0) {
     }
 
     Texture::~Texture() {
@@ -25,8 +27,10 @@ namespace gl {
         m_width = other.m_width;
         m_height = other.m_height;
         m_channels = other.m_channels;
+        m_bytes = other.m_bytes;
 
         other.m_id = 0;
+        other.m_bytes = 0;
     }
 
     Texture& Texture::operator=(Texture&& other) noexcept {
@@ -37,8 +41,10 @@ namespace gl {
             m_width = other.m_width;
             m_height = other.m_height;
             m_channels = other.m_channels;
+            m_bytes = other.m_bytes;
 
             other.m_id = 0;
+            other.m_bytes = 0;
         }
         return *this;
     }
@@ -50,6 +56,11 @@ namespace gl {
         // Destroy old texture if any
         destroy();
 
+        if (TextureFile::isContainer(path)) {
+            TextureFile file;
+            return file.open(path) && loadContainer(file, minFilter, magFilter);
+        }
+
         //std::cout << "loading in texture..." << std::endl;
         stbi_set_flip_vertically_on_load(flipVertically);
         unsigned char* data = stbi_load(path.c_str(), &m_width, &m_height, &m_channels, 0);
@@ -78,7 +89,7 @@ namespace gl {
         }
 
         glGenTextures(1, &m_id);
-        glBindTexture(GL_TEXTURE_2D, m_id);
+        StateCache::current().bindTexture(GL_TEXTURE_2D, m_id);
 
         // Set texture parameters
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
@@ -94,8 +105,9 @@ namespace gl {
         //std::cout << "gpu mipmap..." << std::endl;
         glGenerateMipmap(GL_TEXTURE_2D);
         //std::cout << "gpu loading ok..." << std::endl;
+        m_bytes = static_cast<std::size_t>(m_width) * m_height * 4 * 4 / 3;
 
-        glBindTexture(GL_TEXTURE_2D, 0);
+        StateCache::current().bindTexture(GL_TEXTURE_2D, 0);
 
         //std::cout << "stbi free..." << std::endl;
         stbi_image_free(data);
@@ -104,16 +116,113 @@ namespace gl {
         return true;
     }
 
+    bool Texture::loadContainer(const TextureFile& file, GLint minFilter, GLint magFilter) {
+        if (!allocate(file, minFilter, magFilter))
+            return false;
+        for (int level = static_cast<int>(file.levels().size()) - 1; level >= 0; level--)
+            updateLevel(file, level);
+        StateCache::current().bindTexture(GL_TEXTURE_2D, 0);
+        return true;
+    }
+
+    bool Texture::createSolid(unsigned char r, unsigned char g, unsigned char b, unsigned char a) {
+        if (!allocate(1, 1, GL_NEAREST, GL_NEAREST))
+            return false;
+        const unsigned char pixel[4] = { r, g, b, a };
+        update(0, 1, pixel);
+        m_channels = 4;
+        return true;
+    }
+
+    bool Texture::allocate(int width, int height, GLint minFilter, GLint magFilter) {
+        destroy();
+        if (width <= 0 || height <= 0) {
+            std::cerr << "Bad texture size!\n";
+            return false;
+        }
+
+        glGenTextures(1, &m_id);
+        StateCache::current().bindTexture(GL_TEXTURE_2D, m_id);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+        m_width = width;
+        m_height = height;
+        m_channels = 4;
+        m_bytes = static_cast<std::size_t>(width) * height * 4;
+        return true;
+    }
+
+    void Texture::update(int y, int rows, const void* pixels) {
+        if (!m_id)
+            return;
+        StateCache::current().bindTexture(GL_TEXTURE_2D, m_id);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y, m_width, rows, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    }
+
+    void Texture::generateMipmaps() {
+        if (!m_id)
+            return;
+        StateCache::current().bindTexture(GL_TEXTURE_2D, m_id);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        m_bytes = static_cast<std::size_t>(m_width) * m_height * 4 * 4 / 3; // a full chain adds a third
+    }
+
+    bool Texture::allocate(const TextureFile& file, GLint minFilter, GLint magFilter) {
+        destroy();
+        const auto& levels = file.levels();
+        if (levels.empty()) {
+            std::cerr << "[Texture] No image data in texture file\n";
+            return false;
+        }
+
+        glGenTextures(1, &m_id);
+        StateCache::current().bindTexture(GL_TEXTURE_2D, m_id);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        // A chain stopping short of 1x1 stays complete with the range capped
+        glTexStorage2D(GL_TEXTURE_2D, static_cast<GLsizei>(levels.size()), file.glFormat(), file.width(), file.height());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levels.size()) - 1);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(levels.size()) - 1);
+
+        m_width = file.width();
+        m_height = file.height();
+        m_channels = file.channels();
+        m_bytes = file.dataSize();
+        return true;
+    }
+
+    void Texture::updateLevel(const TextureFile& file, int level) {
+        if (!m_id || level < 0 || level >= static_cast<int>(file.levels().size()))
+            return;
+        const auto& l = file.levels()[level];
+        StateCache::current().bindTexture(GL_TEXTURE_2D, m_id);
+        if (file.compressed()) {
+            glCompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, l.width, l.height, file.glFormat(),
+                static_cast<GLsizei>(l.bytes), l.data);
+        }
+        else {
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, l.width, l.height, GL_RGBA, GL_UNSIGNED_BYTE, l.data);
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+    }
+
     // --------------------------------------
     // Bind / Unbind
     // --------------------------------------
     void Texture::bind(GLuint unit) const {
-        glActiveTexture(GL_TEXTURE0 + unit);
-        glBindTexture(GL_TEXTURE_2D, m_id);
+        StateCache::current().bindTexture(unit, GL_TEXTURE_2D, m_id);
     }
 
     void Texture::unbind() const {
-        glBindTexture(GL_TEXTURE_2D, 0);
+        StateCache::current().bindTexture(GL_TEXTURE_2D, 0);
     }
 
     // --------------------------------------
@@ -121,8 +230,10 @@ namespace gl {
     // --------------------------------------
     void Texture::destroy() {
         if (m_id != 0) {
+            StateCache::current().forgetTexture(m_id);
             glDeleteTextures(1, &m_id);
             m_id = 0;
+            m_bytes = 0;
         }
     }
 
@@ -1,16 +1,20 @@
 #pragma once
 
 #include <glad/glad.h>
+#include <cstddef>
 #include <string>
 
 namespace gl {
 
+    class TextureFile;
+
     class Texture {
     private:
         GLuint      m_id;
         int         m_width;
         int         m_height;
         int         m_channels;
+        std::size_t m_bytes;    // estimated GPU memory, mips included
 
     public:
         Texture();
@@ -22,8 +26,30 @@ namespace gl {
         Texture(Texture&& other) noexcept;
         Texture& operator=(Texture&& other) noexcept;
 
+        // `.dds`/`.ktx2` files go to loadContainer(); they are stored flipped already
         bool loadFromFile(const std::string& path, bool flipVertically = true, GLint minFilter = GL_LINEAR_MIPMAP_LINEAR, GLint magFilter = GL_LINEAR);
 
+        // Every level of the file as stored, straight from the mapping; no
+        // decode and no glGenerateMipmap
+        bool loadContainer(const TextureFile& file, GLint minFilter = GL_LINEAR_MIPMAP_LINEAR, GLint magFilter = GL_LINEAR);
+
+        // 1x1 texture of one colour, e.g. while the real image loads
+        bool createSolid(unsigned char r, unsigned char g, unsigned char b, unsigned char a = 255);
+
+        // Empty RGBA8 storage for width x height, to be filled by update()
+        bool allocate(int width, int height, GLint minFilter = GL_LINEAR_MIPMAP_LINEAR, GLint magFilter = GL_LINEAR);
+        // Rows [y, y + rows) of tightly packed RGBA8 at level 0. With a
+        // GL_PIXEL_UNPACK_BUFFER bound, `pixels` is an offset into it.
+        void update(int y, int rows, const void* pixels);
+        void generateMipmaps();
+
+        // Immutable storage for the file's format and levels, to be filled by
+        // updateLevel() from the smallest level up
+        bool allocate(const TextureFile& file, GLint minFilter = GL_LINEAR_MIPMAP_LINEAR, GLint magFilter = GL_LINEAR);
+        // Uploads one level and makes it the base, so sampling only ever
+        // sees levels that are in
+        void updateLevel(const TextureFile& file, int level);
+
         void bind(GLuint unit = 0) const;
         void unbind() const;
 
@@ -33,6 +59,7 @@ namespace gl {
         int width()  const { return m_width; }
         int height() const { return m_height; }
         int channels() const { return m_channels; }
+        std::size_t memorySize() const { return m_bytes; }
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "TextureArray.hpp"
+#include "StateCache.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace gl {
+
+    // --------------------------------------
+    // Constructor / Destructor
+    // --------------------------------------
+    TextureArray::TextureArray()
+        : m_id(0), m_width(0), m_height(0), m_layers(0), m_levels(0), m_bytes(0) {
+    }
+
+    TextureArray::~TextureArray() {
+        destroy();
+    }
+
+    // --------------------------------------
+    // Move Operations
+    // --------------------------------------
+    TextureArray::TextureArray(TextureArray&& other) noexcept {
+        m_id = other.m_id;
+        m_width = other.m_width;
+        m_height = other.m_height;
+        m_layers = other.m_layers;
+        m_levels = other.m_levels;
+        m_bytes = other.m_bytes;
+
+        other.m_id = 0;
+        other.m_bytes = 0;
+    }
+
+    TextureArray& TextureArray::operator=(TextureArray&& other) noexcept {
+        if (this != &other) {
+            destroy();
+
+            m_id = other.m_id;
+            m_width = other.m_width;
+            m_height = other.m_height;
+            m_layers = other.m_layers;
+            m_levels = other.m_levels;
+            m_bytes = other.m_bytes;
+
+            other.m_id = 0;
+            other.m_bytes = 0;
+        }
+        return *this;
+    }
+
+    // --------------------------------------
+    // Storage
+    // --------------------------------------
+    bool TextureArray::allocate(int width, int height, int layers, int levels, GLint minFilter, GLint magFilter) {
+        destroy();
+        if (width <= 0 || height <= 0 || layers <= 0) {
+            std::cerr << "[TextureArray] Bad size " << width << "x" << height << "x" << layers << "\n";
+            return false;
+        }
+
+        GLint maxLayers = 0;
+        glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+        if (maxLayers > 0 && layers > maxLayers) {
+            std::cerr << "[TextureArray] " << layers << " layers, the driver allows " << maxLayers << "\n";
+            return false;
+        }
+
+        int full = 1;
+        for (int s = std::max(width, height); s > 1; s /= 2)
+            full++;
+        m_levels = levels > 0 ? std::min(levels, full) : full;
+
+        glGenTextures(1, &m_id);
+        StateCache::current().bindTexture(GL_TEXTURE_2D_ARRAY, m_id);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, minFilter);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, magFilter);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexStorage3D(GL_TEXTURE_2D_ARRAY, m_levels, GL_RGBA8, width, height, layers);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, m_levels - 1);
+
+        m_width = width;
+        m_height = height;
+        m_layers = layers;
+        m_bytes = 0;
+        for (int l = 0, w = width, h = height; l < m_levels; l++, w = std::max(1, w / 2), h = std::max(1, h / 2))
+            m_bytes += static_cast<std::size_t>(w) * h * 4 * layers;
+        return true;
+    }
+
+    void TextureArray::update(int layer, int y, int rows, const void* pixels) {
+        if (!m_id || layer < 0 || layer >= m_layers)
+            return;
+        StateCache::current().bindTexture(GL_TEXTURE_2D_ARRAY, m_id);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, y, layer, m_width, rows, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    }
+
+    void TextureArray::generateMipmaps() {
+        if (!m_id || m_levels < 2)
+            return;
+        StateCache::current().bindTexture(GL_TEXTURE_2D_ARRAY, m_id);
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    }
+
+    // --------------------------------------
+    // Bind
+    // --------------------------------------
+    void TextureArray::bind(GLuint unit) const {
+        StateCache::current().bindTexture(unit, GL_TEXTURE_2D_ARRAY, m_id);
+    }
+
+    // --------------------------------------
+    // Destroy
+    // --------------------------------------
+    void TextureArray::destroy() {
+        if (m_id != 0) {
+            StateCache::current().forgetTexture(m_id);
+            glDeleteTextures(1, &m_id);
+            m_id = 0;
+            m_bytes = 0;
+        }
+    }
+
+}
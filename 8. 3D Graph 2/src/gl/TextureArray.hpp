@@ -0,0 +1,53 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+
+namespace gl {
+
+    /**
+     * @brief A GL_TEXTURE_2D_ARRAY of RGBA8 layers, all the same size.
+     *
+     * Storage is immutable: allocate() fixes size, layer count and mip
+     * levels, update() fills level 0 of a layer row by row and
+     * generateMipmaps() builds the rest for every layer at once.
+     */
+    class TextureArray {
+    private:
+        GLuint      m_id;
+        int         m_width;
+        int         m_height;
+        int         m_layers;
+        int         m_levels;
+        std::size_t m_bytes;    // GPU memory of every layer and level
+
+    public:
+        TextureArray();
+        ~TextureArray();
+
+        TextureArray(const TextureArray&) = delete;
+        TextureArray& operator=(const TextureArray&) = delete;
+
+        TextureArray(TextureArray&& other) noexcept;
+        TextureArray& operator=(TextureArray&& other) noexcept;
+
+        // `levels` 0 means a full chain down to 1x1
+        bool allocate(int width, int height, int layers, int levels = 0,
+            GLint minFilter = GL_LINEAR_MIPMAP_LINEAR, GLint magFilter = GL_LINEAR);
+        // Rows [y, y + rows) of one layer, tightly packed RGBA8 at level 0
+        void update(int layer, int y, int rows, const void* pixels);
+        void generateMipmaps();
+
+        void bind(GLuint unit = 0) const;
+
+        void destroy();
+
+        GLuint id() const { return m_id; }
+        int width()  const { return m_width; }
+        int height() const { return m_height; }
+        int layers() const { return m_layers; }
+        int levels() const { return m_levels; }
+        std::size_t memorySize() const { return m_bytes; }
+    };
+
+}
@@ -0,0 +1,268 @@
+#include "TextureAtlas.hpp"
+#include "BlockCompressor.hpp"
+#include "MipGenerator.hpp"
+#include "TextureFile.hpp"
+
+#include "../ext/stb_image.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+
+namespace gl {
+
+    namespace {
+        int roundUp(int v, int multiple) {
+            return (v + multiple - 1) / multiple * multiple;
+        }
+    }
+
+    TextureAtlas::TextureAtlas(int layerSize, int maxImageSize, int padding)
+        : m_layerSize(std::max(1, layerSize)) {
+        m_padding = 1;
+        while (m_padding < padding)
+            m_padding *= 2;
+        // Cells are rounded up to the padding, so the layer must divide evenly
+        m_layerSize = roundUp(m_layerSize, m_padding);
+        m_maxImage = std::max(1, std::min(maxImageSize, m_layerSize - 2 * m_padding));
+    }
+
+    // --------------------------------------
+    // Adding images
+    // --------------------------------------
+    int TextureAtlas::add(const unsigned char* rgba, int width, int height) {
+        if (m_packed) {
+            std::cerr << "[TextureAtlas] Already packed, image ignored\n";
+            return -1;
+        }
+        if (!rgba || width <= 0 || height <= 0) {
+            std::cerr << "[TextureAtlas] Bad image " << width << "x" << height << "\n";
+            return -1;
+        }
+
+        Image image;
+        const int largest = std::max(width, height);
+        if (largest > m_maxImage) {
+            const float scale = static_cast<float>(m_maxImage) / largest;
+            mip_level fitted = MipGenerator::resize(rgba, width, height,
+                std::max(1, static_cast<int>(width * scale)), std::max(1, static_cast<int>(height * scale)),
+                mip_filter::kaiser);
+            image.width = fitted.width;
+            image.height = fitted.height;
+            image.rgba = std::move(fitted.rgba);
+        }
+        else {
+            image.width = width;
+            image.height = height;
+            image.rgba.assign(rgba, rgba + static_cast<std::size_t>(width) * height * 4);
+        }
+
+        m_images.push_back(std::move(image));
+        m_regions.emplace_back();
+        return static_cast<int>(m_images.size()) - 1;
+    }
+
+    int TextureAtlas::add(const std::string& path, bool flipVertically) {
+        if (TextureFile::isContainer(path)) {
+            // Stored bottom-up already; any level that fits saves a resize
+            TextureFile file;
+            if (!file.open(path))
+                return -1;
+            const auto& levels = file.levels();
+            std::size_t pick = 0;
+            while (pick + 1 < levels.size() && std::max(levels[pick].width, levels[pick].height) > m_maxImage)
+                pick++;
+            const auto& level = levels[pick];
+            if (!file.compressed())
+                return add(level.data, level.width, level.height);
+
+            block_format format;
+            if (!BlockCompressor::fromGlFormat(file.glFormat(), format)) {
+                std::cerr << "[TextureAtlas] Unsupported format in " << path << "\n";
+                return -1;
+            }
+            if (!BlockCompressor::canDecompress(format, level.data, level.width, level.height)) {
+                std::cerr << "[TextureAtlas] Unsupported " << BlockCompressor::name(format)
+                          << " modes in " << path << " (only mode 6 is decoded)\n";
+                return -1;
+            }
+            std::vector<unsigned char> rgba = BlockCompressor::decompress(format, level.data, level.width, level.height);
+            return add(rgba.data(), level.width, level.height);
+        }
+
+        int w = 0, h = 0, channels = 0;
+        stbi_set_flip_vertically_on_load_thread(flipVertically);
+        unsigned char* rgba = stbi_load(path.c_str(), &w, &h, &channels, 4);
+        if (!rgba) {
+            std::cerr << "[TextureAtlas] Failed to load: " << path << "\n";
+            return -1;
+        }
+        int index = add(rgba, w, h);
+        stbi_image_free(rgba);
+        return index;
+    }
+
+    // --------------------------------------
+    // Packing
+    // --------------------------------------
+    bool TextureAtlas::pack(ThreadPool& pool) {
+        if (m_packed)
+            return true;
+        if (m_images.empty()) {
+            std::cerr << "[TextureAtlas] Nothing to pack\n";
+            return false;
+        }
+        auto start = std::chrono::steady_clock::now();
+
+        auto cellWidth = [&](const Image& i) { return roundUp(i.width + 2 * m_padding, m_padding); };
+        auto cellHeight = [&](const Image& i) { return roundUp(i.height + 2 * m_padding, m_padding); };
+
+        // Tallest first keeps shelves nearly full
+        std::vector<std::size_t> order(m_images.size());
+        std::iota(order.begin(), order.end(), std::size_t{ 0 });
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            const int ha = cellHeight(m_images[a]), hb = cellHeight(m_images[b]);
+            return ha != hb ? ha > hb : cellWidth(m_images[a]) > cellWidth(m_images[b]);
+        });
+
+        struct Shelf {
+            int layer, y, height, x;
+        };
+        struct Cell {
+            int x, y, layer;
+        };
+        std::vector<Shelf> shelves;
+        std::vector<Cell> cells(m_images.size());
+        int top = m_layerSize; // first free row of the newest layer
+        m_layerCount = 0;
+
+        for (std::size_t i : order) {
+            const int cw = cellWidth(m_images[i]);
+            const int ch = cellHeight(m_images[i]);
+
+            Shelf* shelf = nullptr;
+            for (auto& s : shelves) {
+                if (s.height >= ch && s.x + cw <= m_layerSize) {
+                    shelf = &s;
+                    break;
+                }
+            }
+            if (!shelf) {
+                if (top + ch > m_layerSize) {
+                    m_layerCount++;
+                    top = 0;
+                }
+                shelves.push_back({ m_layerCount - 1, top, ch, 0 });
+                top += ch;
+                shelf = &shelves.back();
+            }
+
+            cells[i] = { shelf->x, shelf->y, shelf->layer };
+            shelf->x += cw;
+        }
+
+        const float texel = 1.0f / m_layerSize;
+        m_imageTexels = 0;
+        for (std::size_t i = 0; i < m_images.size(); i++) {
+            const Image& image = m_images[i];
+            atlas_region& r = m_regions[i];
+            r.layer = cells[i].layer;
+            r.width = image.width;
+            r.height = image.height;
+            r.uvRect = glm::vec4((cells[i].x + m_padding) * texel, (cells[i].y + m_padding) * texel,
+                image.width * texel, image.height * texel);
+            m_imageTexels += static_cast<std::size_t>(image.width) * image.height;
+        }
+
+        // Cells never overlap, so images blit in parallel
+        const std::size_t layerBytes = static_cast<std::size_t>(m_layerSize) * m_layerSize * 4;
+        m_layers.assign(m_layerCount, std::vector<unsigned char>(layerBytes, 0));
+        pool.parallelFor(m_images.size(), [&](std::size_t i) {
+            blit(m_images[i], cells[i].x, cells[i].y, m_layers[cells[i].layer].data());
+        });
+
+        m_images.clear();
+        m_images.shrink_to_fit();
+        m_packMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        m_packed = true;
+        return true;
+    }
+
+    void TextureAtlas::blit(const Image& image, int x, int y, unsigned char* layer) const {
+        const int p = m_padding;
+        const std::size_t pitch = static_cast<std::size_t>(m_layerSize) * 4;
+        for (int row = -p; row < image.height + p; row++) {
+            const int src = std::min(image.height - 1, std::max(0, row));
+            const unsigned char* in = image.rgba.data() + static_cast<std::size_t>(src) * image.width * 4;
+            unsigned char* out = layer + (y + p + row) * pitch + static_cast<std::size_t>(x) * 4;
+
+            for (int i = 0; i < p; i++)
+                std::memcpy(out + i * 4, in, 4);
+            std::memcpy(out + p * 4, in, static_cast<std::size_t>(image.width) * 4);
+            const unsigned char* last = in + (image.width - 1) * 4;
+            for (int i = 0; i < p; i++)
+                std::memcpy(out + (p + image.width + i) * 4, last, 4);
+        }
+    }
+
+    // --------------------------------------
+    // Upload
+    // --------------------------------------
+    bool TextureAtlas::upload(std::size_t budget) {
+        if (m_uploaded)
+            return true;
+        if (!m_packed)
+            return false;
+
+        if (!m_texture.id()) {
+            int levels = 1;
+            for (int p = m_padding; p > 1; p /= 2)
+                levels++;
+            if (!m_texture.allocate(m_layerSize, m_layerSize, m_layerCount, levels))
+                return false;
+            m_uploadLayer = 0;
+            m_uploadRow = 0;
+        }
+
+        // At least one row per call, so a tiny budget still makes progress
+        const std::size_t rowBytes = static_cast<std::size_t>(m_layerSize) * 4;
+        do {
+            const std::size_t left = static_cast<std::size_t>(m_layerSize - m_uploadRow);
+            const int rows = static_cast<int>(std::min(left, std::max<std::size_t>(1, budget / rowBytes)));
+            m_texture.update(m_uploadLayer, m_uploadRow, rows, m_layers[m_uploadLayer].data() + m_uploadRow * rowBytes);
+            budget -= std::min(budget, rows * rowBytes);
+            m_uploadRow += rows;
+            if (m_uploadRow == m_layerSize) {
+                std::vector<unsigned char>().swap(m_layers[m_uploadLayer]);
+                m_uploadLayer++;
+                m_uploadRow = 0;
+            }
+        } while (m_uploadLayer < m_layerCount && budget >= rowBytes);
+        if (m_uploadLayer < m_layerCount)
+            return false;
+
+        m_texture.generateMipmaps();
+        m_layers.clear();
+        m_uploaded = true;
+        return true;
+    }
+
+    bool TextureAtlas::build(ThreadPool& pool) {
+        return pack(pool) && upload();
+    }
+
+    double TextureAtlas::fill() const {
+        const double total = static_cast<double>(m_layerSize) * m_layerSize * m_layerCount;
+        return total > 0.0 ? m_imageTexels / total : 0.0;
+    }
+
+    void TextureAtlas::report(std::ostream& out) const {
+        out << "[atlas] " << m_regions.size() << " images in " << m_layerCount << " layers of "
+            << m_layerSize << "x" << m_layerSize << " | fill " << fill() * 100.0 << "%"
+            << " | VRAM " << m_texture.memorySize() / (1024 * 1024) << " MB"
+            << " | pack " << m_packMs << " ms" << std::endl;
+    }
+
+}
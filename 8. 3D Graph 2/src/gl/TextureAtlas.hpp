@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "TextureArray.hpp"
+#include "ThreadPool.hpp"
+
+namespace gl {
+
+    /**
+     * @brief Where one image ended up in a TextureAtlas. The shader maps
+     * the quad's uv with `uvRect.xy + uv * uvRect.zw` and samples `layer`.
+     */
+    struct atlas_region {
+        int layer = 0;
+        glm::vec4 uvRect{ 0.0f, 0.0f, 1.0f, 1.0f }; // offset, scale
+        int width = 0;                              // texels as packed
+        int height = 0;
+    };
+
+    /**
+     * @brief Packs many RGBA8 images into the layers of one TextureArray,
+     * so a whole set of pictures needs a single texture binding.
+     *
+     * Images are shelf packed: sorted by height, each goes on the first
+     * shelf with room left, and a new shelf (or layer) opens when none
+     * has. Every image sits in a cell with `padding` texels of gutter on
+     * each side, filled by repeating its edge, and cells start on
+     * multiples of `padding`. Mip level k keeps padding >> k texels of
+     * gutter, so the chain stops at the level where that reaches one and
+     * neighbours never bleed into each other.
+     *
+     * pack() is CPU only and may run on a worker; upload() must run on
+     * the GL thread and can be spread over several frames.
+     */
+    class TextureAtlas {
+    public:
+        // `padding` is rounded up to a power of two; images larger than
+        // `maxImageSize` (after clamping it to fit a layer) are scaled down
+        explicit TextureAtlas(int layerSize = 2048, int maxImageSize = 1024, int padding = 8);
+
+        TextureAtlas(const TextureAtlas&) = delete;
+        TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+        // Copies the image; returns its index for region()
+        int add(const unsigned char* rgba, int width, int height);
+        // Decodes an image file, or the largest fitting level of a
+        // `.dds`/`.ktx2`; -1 on failure
+        int add(const std::string& path, bool flipVertically = true);
+
+        // Places and blits every image added so far into layer buffers,
+        // then frees the copies
+        bool pack(ThreadPool& pool = ThreadPool::shared());
+        // Allocates the array on the first call and uploads at most
+        // `budget` bytes of rows per call, mips after the last one; true
+        // once the atlas is complete
+        bool upload(std::size_t budget = SIZE_MAX);
+        // pack() and upload() in one go
+        bool build(ThreadPool& pool = ThreadPool::shared());
+
+        bool packed() const { return m_packed; }
+        bool uploaded() const { return m_uploaded; }
+
+        std::size_t size() const { return m_regions.size(); }
+        const atlas_region& region(std::size_t index) const { return m_regions[index]; }
+        const TextureArray& texture() const { return m_texture; }
+
+        int layerSize() const { return m_layerSize; }
+        int layers() const { return m_layerCount; }
+        // Image texels over layer texels
+        double fill() const;
+        double packMs() const { return m_packMs; }
+
+        void report(std::ostream& out) const;
+
+    private:
+        struct Image {
+            int width = 0;
+            int height = 0;
+            std::vector<unsigned char> rgba;
+        };
+
+        // The image and its gutter into layer memory at cell (x, y)
+        void blit(const Image& image, int x, int y, unsigned char* layer) const;
+
+        int m_layerSize;
+        int m_maxImage;
+        int m_padding;
+
+        std::vector<Image> m_images;
+        std::vector<atlas_region> m_regions;
+        std::vector<std::vector<unsigned char>> m_layers; // packed RGBA8, freed once uploaded
+        int m_layerCount = 0;
+        std::size_t m_imageTexels = 0;
+        double m_packMs = 0.0;
+        bool m_packed = false;
+
+        TextureArray m_texture;
+        int m_uploadLayer = 0;
+        int m_uploadRow = 0;
+        bool m_uploaded = false;
+    };
+
+}
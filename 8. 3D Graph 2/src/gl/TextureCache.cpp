@@ -0,0 +1,227 @@
+#include "TextureCache.hpp"
+#include "TextureLoader.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace gl {
+
+    namespace {
+        // 64-bit FNV-style hash taking eight bytes per step, finished with
+        // a murmur avalanche; only has to tell image files apart
+        std::uint64_t hashBytes(const char* data, std::size_t size) {
+            std::uint64_t h = 0xcbf29ce484222325ull ^ size;
+            std::size_t i = 0;
+            for (; i + 8 <= size; i += 8) {
+                std::uint64_t word;
+                std::memcpy(&word, data + i, 8);
+                h = (h ^ word) * 0x100000001b3ull;
+            }
+            for (; i < size; i++)
+                h = (h ^ static_cast<unsigned char>(data[i])) * 0x100000001b3ull;
+
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdull;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ull;
+            h ^= h >> 33;
+            return h;
+        }
+
+        bool hashFile(const std::string& path, std::uint64_t& hash) {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file)
+                return false;
+            std::vector<char> bytes(static_cast<std::size_t>(file.tellg()));
+            file.seekg(0);
+            if (!file.read(bytes.data(), bytes.size()))
+                return false;
+            hash = hashBytes(bytes.data(), bytes.size());
+            return true;
+        }
+    }
+
+    TextureCache::~TextureCache() {
+        if (!m_entries.empty())
+            std::cerr << "[TextureCache] " << m_entries.size() << " textures still referenced at shutdown\n";
+    }
+
+    TextureCache& TextureCache::shared() {
+        static TextureCache cache;
+        return cache;
+    }
+
+    texture_handle TextureCache::findPath(const std::string& path, bool flip, std::string& pathKey) {
+        std::error_code ec;
+        std::filesystem::path canonical = std::filesystem::weakly_canonical(path, ec);
+        pathKey = (ec ? path : canonical.string()) + (flip ? "|flip" : "");
+
+        auto byPath = m_byPath.find(pathKey);
+        if (byPath == m_byPath.end())
+            return nullptr;
+        m_counters.pathHits++;
+        return m_entries.at(byPath->second).texture.lock();
+    }
+
+    bool TextureCache::findContent(const std::string& path, bool flip, const std::string& pathKey,
+        texture_handle& found, std::uint64_t& contentKey) {
+        if (!hashFile(path, contentKey)) {
+            std::cerr << "[TextureCache] Cannot read: " << path << "\n";
+            return false;
+        }
+        contentKey ^= flip; // flipped and upright uploads differ
+
+        auto byContent = m_byContent.find(contentKey);
+        if (byContent != m_byContent.end()) {
+            Entry& e = m_entries.at(byContent->second);
+            found = e.texture.lock();
+            e.paths.push_back(pathKey);
+            m_byPath[pathKey] = byContent->second;
+            m_counters.contentHits++;
+        }
+        return true;
+    }
+
+    texture_handle TextureCache::insert(std::unique_ptr<Texture> texture, const std::string& pathKey,
+        const std::uint64_t* contentKey) {
+        Texture* raw = texture.release();
+        texture_handle handle(raw, [this](Texture* t) {
+            release(t);
+            delete t;
+        });
+
+        Entry& e = m_entries[raw];
+        e.texture = handle;
+        e.source = pathKey;
+        e.paths = { pathKey };
+        if (contentKey) {
+            e.content = *contentKey;
+            e.hashed = true;
+            m_byContent[*contentKey] = raw;
+        }
+        m_byPath[pathKey] = raw;
+        m_counters.loads++;
+        return handle;
+    }
+
+    void TextureCache::resolveContent(Texture* texture, std::uint64_t contentKey) {
+        auto it = m_entries.find(texture);
+        if (it == m_entries.end())
+            return;
+        Entry& e = it->second;
+
+        auto byContent = m_byContent.find(contentKey);
+        if (byContent != m_byContent.end() && byContent->second != texture) {
+            // Uploaded twice by now, but from here on the path shares the
+            // older texture; this one lives while its handles do
+            Entry& older = m_entries.at(byContent->second);
+            for (const auto& key : e.paths) {
+                m_byPath[key] = byContent->second;
+                older.paths.push_back(key);
+            }
+            e.paths.clear();
+            m_counters.contentHits++;
+            return;
+        }
+
+        e.content = contentKey;
+        e.hashed = true;
+        m_byContent[contentKey] = texture;
+    }
+
+    void TextureCache::evict(Texture* texture) {
+        auto it = m_entries.find(texture);
+        if (it == m_entries.end())
+            return;
+        for (const auto& key : it->second.paths)
+            m_byPath.erase(key);
+        it->second.paths.clear();
+    }
+
+    void TextureCache::release(Texture* texture) {
+        auto it = m_entries.find(texture);
+        if (it == m_entries.end())
+            return;
+        for (const auto& key : it->second.paths)
+            m_byPath.erase(key);
+        auto byContent = m_byContent.find(it->second.content);
+        if (it->second.hashed && byContent != m_byContent.end() && byContent->second == texture)
+            m_byContent.erase(byContent);
+        m_entries.erase(it);
+    }
+
+    texture_handle TextureCache::load(const std::string& path, bool flipVertically) {
+        std::string pathKey;
+        if (texture_handle found = findPath(path, flipVertically, pathKey))
+            return found;
+
+        texture_handle found;
+        std::uint64_t contentKey = 0;
+        if (!findContent(path, flipVertically, pathKey, found, contentKey))
+            return nullptr;
+        if (found)
+            return found;
+
+        auto texture = std::make_unique<Texture>();
+        if (!texture->loadFromFile(path, flipVertically))
+            return nullptr;
+        return insert(std::move(texture), pathKey, &contentKey);
+    }
+
+    texture_handle TextureCache::load(TextureLoader& loader, const std::string& path, bool flipVertically) {
+        // No file I/O here: the bytes are hashed next to the decode
+        std::string pathKey;
+        if (texture_handle found = findPath(path, flipVertically, pathKey))
+            return found;
+
+        texture_handle handle = insert(std::make_unique<Texture>(), pathKey, nullptr);
+        Texture* raw = handle.get();
+
+        // Queued ahead of the decode and far cheaper, so it is done by the
+        // time the texture is
+        struct content_hash {
+            std::uint64_t key = 0;
+            bool ok = false;
+        };
+        auto hash = std::make_shared<content_hash>();
+        std::shared_future<void> hashed = loader.pool().submit([hash, path, flipVertically] {
+            hash->ok = hashFile(path, hash->key);
+            hash->key ^= flipVertically;
+        }).share();
+
+        loader.load(handle, path, flipVertically,
+            [this, raw, hash, hashed](Texture&) {
+                hashed.wait();
+                if (hash->ok)
+                    resolveContent(raw, hash->key);
+            },
+            [this, raw] { evict(raw); });
+        return handle;
+    }
+
+    TextureCache::Stats TextureCache::stats() const {
+        Stats s = m_counters;
+        s.textures = m_entries.size();
+        for (const auto& [texture, entry] : m_entries) {
+            s.handles += static_cast<std::size_t>(entry.texture.use_count());
+            s.bytes += texture->memorySize();
+        }
+        return s;
+    }
+
+    void TextureCache::report(std::ostream& out) const {
+        Stats s = stats();
+        out << "[TextureCache] " << s.textures << " textures, " << s.handles << " handles, "
+            << s.bytes / 1024.0 / 1024.0 << " MB | loads " << s.loads << ", path hits " << s.pathHits
+            << ", content hits " << s.contentHits << "\n";
+        for (const auto& [texture, entry] : m_entries) {
+            out << "  " << entry.source << ": " << texture->width() << "x" << texture->height()
+                << ", " << texture->memorySize() / 1024.0 / 1024.0 << " MB, "
+                << entry.texture.use_count() << " handles\n";
+        }
+    }
+
+}
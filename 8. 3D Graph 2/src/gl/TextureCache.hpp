@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Texture.hpp"
+
+namespace gl {
+
+    class TextureLoader;
+
+    // Shared ownership of a cached texture; the last one released unloads it
+    using texture_handle = std::shared_ptr<Texture>;
+
+    /**
+     * @brief Hands out shared textures so each image is decoded and
+     * uploaded once, however many models use it.
+     *
+     * Lookups go by canonical path first (plus the flip flag), then by a
+     * hash of the file's bytes, so the same image under another name or
+     * through a different relative path is still found. Entries only hold
+     * weak references: when the last handle goes, the texture is deleted
+     * and forgotten.
+     *
+     * Asynchronous loads look up the path alone and hash the file on the
+     * loader's pool; once the texture is in, a copy of bytes already
+     * cached is merged, so later requests for its path share the older
+     * texture. A failed load is evicted and the next request retries.
+     *
+     * Handles must not outlive the cache; shared() lives until exit.
+     */
+    class TextureCache {
+    public:
+        struct Stats {
+            std::size_t textures = 0;    // live textures
+            std::size_t handles = 0;     // live handles to them
+            std::size_t bytes = 0;       // estimated VRAM, mips included
+            std::size_t pathHits = 0;    // served by path
+            std::size_t contentHits = 0; // served by content hash under another path
+            std::size_t loads = 0;       // had to decode and upload
+        };
+
+        TextureCache() = default;
+        ~TextureCache();
+
+        TextureCache(const TextureCache&) = delete;
+        TextureCache& operator=(const TextureCache&) = delete;
+
+        // Synchronous load on a miss; nullptr if the file cannot be read
+        texture_handle load(const std::string& path, bool flipVertically = true);
+        // On a miss the texture shows a placeholder until `loader` is done
+        texture_handle load(TextureLoader& loader, const std::string& path, bool flipVertically = true);
+
+        Stats stats() const;
+        // Totals, then one line per live texture
+        void report(std::ostream& out) const;
+
+        static TextureCache& shared();
+
+    private:
+        struct Entry {
+            std::weak_ptr<Texture> texture;
+            std::string source;             // first path key, for report()
+            std::vector<std::string> paths; // path keys resolving here
+            std::uint64_t content = 0;      // content key, once hashed
+            bool hashed = false;
+        };
+
+        // A live texture for the path alone; fills in the key either way
+        texture_handle findPath(const std::string& path, bool flip, std::string& pathKey);
+        // Then by the file's bytes; fills in the key for insert(). False
+        // if the file cannot be read.
+        bool findContent(const std::string& path, bool flip, const std::string& pathKey,
+            texture_handle& found, std::uint64_t& contentKey);
+        texture_handle insert(std::unique_ptr<Texture> texture, const std::string& pathKey,
+            const std::uint64_t* contentKey);
+        // Async loads, on the render thread: register the content key or
+        // merge into the entry that already has it
+        void resolveContent(Texture* texture, std::uint64_t contentKey);
+        // Drops the path keys, so the next request loads again
+        void evict(Texture* texture);
+        void release(Texture* texture);
+
+        std::unordered_map<Texture*, Entry> m_entries;
+        std::unordered_map<std::string, Texture*> m_byPath;
+        std::unordered_map<std::uint64_t, Texture*> m_byContent;
+        Stats m_counters; // hits and loads; the rest is computed by stats()
+    };
+
+}
@@ -0,0 +1,316 @@
+#include "TextureFile.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace gl {
+
+    namespace {
+        constexpr std::uint32_t fourCC(char a, char b, char c, char d) {
+            return static_cast<std::uint32_t>(a) | (static_cast<std::uint32_t>(b) << 8) |
+                (static_cast<std::uint32_t>(c) << 16) | (static_cast<std::uint32_t>(d) << 24);
+        }
+
+        constexpr std::uint32_t DDSD_CAPS = 0x1, DDSD_HEIGHT = 0x2, DDSD_WIDTH = 0x4, DDSD_PITCH = 0x8;
+        constexpr std::uint32_t DDSD_PIXELFORMAT = 0x1000, DDSD_MIPMAPCOUNT = 0x20000, DDSD_LINEARSIZE = 0x80000;
+        constexpr std::uint32_t DDPF_ALPHAPIXELS = 0x1, DDPF_FOURCC = 0x4, DDPF_RGB = 0x40;
+        constexpr std::uint32_t DDSCAPS_COMPLEX = 0x8, DDSCAPS_TEXTURE = 0x1000, DDSCAPS_MIPMAP = 0x400000;
+
+        // DXGI_FORMAT values of the DX10 header
+        constexpr std::uint32_t DXGI_RGBA8_UNORM = 28, DXGI_RGBA8_SRGB = 29;
+        constexpr std::uint32_t DXGI_BC1_UNORM = 71, DXGI_BC1_SRGB = 72;
+        constexpr std::uint32_t DXGI_BC3_UNORM = 77, DXGI_BC3_SRGB = 78;
+        constexpr std::uint32_t DXGI_BC7_UNORM = 98, DXGI_BC7_SRGB = 99;
+
+        // VkFormat values of the KTX2 header
+        constexpr std::uint32_t VK_RGBA8_UNORM = 37, VK_RGBA8_SRGB = 43;
+        constexpr std::uint32_t VK_BC1_RGB_UNORM = 131, VK_BC1_RGB_SRGB = 132, VK_BC1_RGBA_UNORM = 133, VK_BC1_RGBA_SRGB = 134;
+        constexpr std::uint32_t VK_BC3_UNORM = 137, VK_BC3_SRGB = 138;
+        constexpr std::uint32_t VK_BC7_UNORM = 145, VK_BC7_SRGB = 146;
+
+        constexpr std::size_t ddsHeaderBytes = sizeof(DdsMagic) + sizeof(DdsHeader);
+        constexpr std::size_t ktx2HeaderBytes = sizeof(Ktx2Identifier) + sizeof(Ktx2Header);
+
+        // Where the levels are; `levels` only filled in when the whole file is there
+        struct container_layout {
+            GLenum glFormat = 0;
+            int width = 0, height = 0;
+            std::vector<TextureFile::Level> levels;
+        };
+
+        bool fail(const std::string& path, const char* why) {
+            std::cerr << "Error: " << path << ": " << why << "\n";
+            return false;
+        }
+
+        GLenum fromDxgi(std::uint32_t format) {
+            switch (format) {
+            case DXGI_RGBA8_UNORM: case DXGI_RGBA8_SRGB: return GL_RGBA8;
+            case DXGI_BC1_UNORM:   case DXGI_BC1_SRGB:   return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+            case DXGI_BC3_UNORM:   case DXGI_BC3_SRGB:   return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            case DXGI_BC7_UNORM:   case DXGI_BC7_SRGB:   return GL_COMPRESSED_RGBA_BPTC_UNORM;
+            }
+            return 0;
+        }
+
+        GLenum fromVk(std::uint32_t format) {
+            switch (format) {
+            case VK_RGBA8_UNORM:    case VK_RGBA8_SRGB:    return GL_RGBA8;
+            case VK_BC1_RGB_UNORM:  case VK_BC1_RGB_SRGB:  return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+            case VK_BC1_RGBA_UNORM: case VK_BC1_RGBA_SRGB: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+            case VK_BC3_UNORM:      case VK_BC3_SRGB:      return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            case VK_BC7_UNORM:      case VK_BC7_SRGB:      return GL_COMPRESSED_RGBA_BPTC_UNORM;
+            }
+            return 0;
+        }
+
+        bool readDds(const unsigned char* data, std::size_t size, bool whole, const std::string& path, container_layout& out) {
+            DdsHeader h;
+            std::memcpy(&h, data + sizeof(DdsMagic), sizeof(h));
+            if (h.size != sizeof(DdsHeader))
+                return fail(path, "bad DDS header");
+
+            std::size_t offset = ddsHeaderBytes;
+            if (h.format.flags & DDPF_FOURCC) {
+                switch (h.format.fourCC) {
+                case fourCC('D', 'X', 'T', '1'): out.glFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT; break;
+                case fourCC('D', 'X', 'T', '5'): out.glFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT; break;
+                case fourCC('D', 'X', '1', '0'): {
+                    DdsHeaderDx10 dx10;
+                    if (size < ddsHeaderBytes + sizeof(dx10))
+                        return fail(path, "truncated DX10 header");
+                    std::memcpy(&dx10, data + ddsHeaderBytes, sizeof(dx10));
+                    offset += sizeof(dx10);
+                    out.glFormat = fromDxgi(dx10.dxgiFormat);
+                    if (dx10.resourceDimension != 3 || dx10.arraySize > 1)
+                        return fail(path, "only single 2D textures are supported");
+                    break;
+                }
+                }
+            }
+            else if ((h.format.flags & DDPF_RGB) && h.format.rgbBitCount == 32 && h.format.rBitMask == 0x000000FF &&
+                h.format.gBitMask == 0x0000FF00 && h.format.bBitMask == 0x00FF0000) {
+                out.glFormat = GL_RGBA8;
+            }
+            if (!out.glFormat)
+                return fail(path, "unsupported pixel format (expected RGBA8, BC1, BC3 or BC7)");
+
+            out.width = static_cast<int>(h.width);
+            out.height = static_cast<int>(h.height);
+            if (out.width <= 0 || out.height <= 0)
+                return fail(path, "bad texture size");
+            if (!whole)
+                return true;
+
+            // Levels follow each other, largest first
+            const int count = (h.flags & DDSD_MIPMAPCOUNT) ? std::max<int>(1, static_cast<int>(h.mipMapCount)) : 1;
+            int w = out.width, ht = out.height;
+            for (int level = 0; level < count; level++) {
+                const std::size_t bytes = TextureFile::levelSize(out.glFormat, w, ht);
+                if (offset + bytes > size)
+                    break;
+                out.levels.push_back({ data + offset, bytes, w, ht });
+                offset += bytes;
+                if (w == 1 && ht == 1)
+                    break;
+                w = std::max(1, w / 2);
+                ht = std::max(1, ht / 2);
+            }
+            return true;
+        }
+
+        bool readKtx2(const unsigned char* data, std::size_t size, bool whole, const std::string& path, container_layout& out) {
+            Ktx2Header h;
+            std::memcpy(&h, data + sizeof(Ktx2Identifier), sizeof(h));
+            out.glFormat = fromVk(h.vkFormat);
+            if (!out.glFormat)
+                return fail(path, "unsupported VkFormat (expected RGBA8, BC1, BC3 or BC7)");
+            if (h.supercompressionScheme != 0)
+                return fail(path, "supercompressed KTX2 is not supported");
+            if (h.pixelDepth > 1 || h.layerCount > 1 || h.faceCount != 1)
+                return fail(path, "only single 2D textures are supported");
+
+            out.width = static_cast<int>(h.pixelWidth);
+            out.height = static_cast<int>(h.pixelHeight);
+            if (out.width <= 0 || out.height <= 0)
+                return fail(path, "bad texture size");
+            if (!whole)
+                return true;
+
+            // Never more levels than a full chain down to 1x1
+            std::uint32_t fullChain = 1;
+            for (int m = std::max(out.width, out.height); m > 1; m /= 2)
+                fullChain++;
+            const std::uint32_t count = std::clamp<std::uint32_t>(h.levelCount, 1, fullChain);
+            if (size < ktx2HeaderBytes + count * sizeof(Ktx2Level))
+                return fail(path, "truncated level index");
+
+            int w = out.width, ht = out.height;
+            for (std::uint32_t level = 0; level < count; level++) {
+                Ktx2Level l;
+                std::memcpy(&l, data + ktx2HeaderBytes + level * sizeof(Ktx2Level), sizeof(l));
+                const std::size_t bytes = TextureFile::levelSize(out.glFormat, w, ht);
+                if (l.byteLength < bytes || l.byteOffset > size || l.byteLength > size - l.byteOffset)
+                    break;
+                out.levels.push_back({ data + l.byteOffset, bytes, w, ht });
+                if (w == 1 && ht == 1)
+                    break;
+                w = std::max(1, w / 2);
+                ht = std::max(1, ht / 2);
+            }
+            return true;
+        }
+
+        // Checks which container `data` starts with and reads it
+        bool readLayout(const unsigned char* data, std::size_t size, bool whole, const std::string& path, container_layout& out) {
+            if (size >= ddsHeaderBytes && std::memcmp(data, DdsMagic, sizeof(DdsMagic)) == 0)
+                return readDds(data, size, whole, path, out);
+            if (size >= ktx2HeaderBytes && std::memcmp(data, Ktx2Identifier, sizeof(Ktx2Identifier)) == 0)
+                return readKtx2(data, size, whole, path, out);
+            return fail(path, "not a DDS or KTX2 file");
+        }
+    }
+
+    bool TextureFile::open(const std::string& path) {
+        close();
+        if (!m_file.open(path))
+            return false;
+
+        container_layout layout;
+        if (!readLayout(m_file.data(), m_file.size(), true, path, layout)) {
+            close();
+            return false;
+        }
+        if (layout.levels.empty()) {
+            fail(path, "truncated image data");
+            close();
+            return false;
+        }
+
+        m_glFormat = layout.glFormat;
+        m_width = layout.width;
+        m_height = layout.height;
+        m_levels = std::move(layout.levels);
+        return true;
+    }
+
+    void TextureFile::close() {
+        m_file.close();
+        m_levels.clear();
+        m_glFormat = 0;
+        m_width = m_height = 0;
+    }
+
+    int TextureFile::channels() const {
+        return m_glFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ? 3 : 4;
+    }
+
+    std::size_t TextureFile::dataSize() const {
+        std::size_t bytes = 0;
+        for (const auto& l : m_levels)
+            bytes += l.bytes;
+        return bytes;
+    }
+
+    std::size_t TextureFile::levelSize(GLenum glFormat, int width, int height) {
+        block_format format;
+        if (BlockCompressor::fromGlFormat(glFormat, format))
+            return BlockCompressor::compressedSize(format, width, height);
+        return static_cast<std::size_t>(width) * height * 4;
+    }
+
+    bool TextureFile::isContainer(const std::string& path) {
+        const std::size_t dot = path.find_last_of('.');
+        if (dot == std::string::npos)
+            return false;
+        std::string ext = path.substr(dot);
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return ext == ".dds" || ext == ".ktx2";
+    }
+
+    bool TextureFile::info(const std::string& path, int& width, int& height) {
+        unsigned char header[std::max(ddsHeaderBytes + sizeof(DdsHeaderDx10), ktx2HeaderBytes)] = {};
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+        file.read(reinterpret_cast<char*>(header), sizeof(header));
+
+        container_layout layout;
+        if (!readLayout(header, static_cast<std::size_t>(file.gcount()), false, path, layout))
+            return false;
+        width = layout.width;
+        height = layout.height;
+        return true;
+    }
+
+    bool TextureFile::writeDds(const std::string& path, GLenum glFormat, int width, int height,
+        const std::vector<std::vector<unsigned char>>& levels) {
+        if (levels.empty() || width <= 0 || height <= 0)
+            return false;
+
+        DdsHeader h{};
+        h.size = sizeof(DdsHeader);
+        h.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT;
+        h.height = static_cast<std::uint32_t>(height);
+        h.width = static_cast<std::uint32_t>(width);
+        h.mipMapCount = static_cast<std::uint32_t>(levels.size());
+        h.format.size = sizeof(DdsPixelFormat);
+        h.caps = DDSCAPS_TEXTURE;
+        if (levels.size() > 1) {
+            h.flags |= DDSD_MIPMAPCOUNT;
+            h.caps |= DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+        }
+
+        DdsHeaderDx10 dx10{};
+        switch (glFormat) {
+        case GL_RGBA8:
+            h.flags |= DDSD_PITCH;
+            h.pitchOrLinearSize = static_cast<std::uint32_t>(width) * 4;
+            h.format.flags = DDPF_RGB | DDPF_ALPHAPIXELS;
+            h.format.rgbBitCount = 32;
+            h.format.rBitMask = 0x000000FF;
+            h.format.gBitMask = 0x0000FF00;
+            h.format.bBitMask = 0x00FF0000;
+            h.format.aBitMask = 0xFF000000;
+            break;
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+            h.format.fourCC = fourCC('D', 'X', 'T', '1');
+            break;
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+            h.format.fourCC = fourCC('D', 'X', 'T', '5');
+            break;
+        case GL_COMPRESSED_RGBA_BPTC_UNORM:
+            h.format.fourCC = fourCC('D', 'X', '1', '0');
+            dx10.dxgiFormat = DXGI_BC7_UNORM;
+            dx10.resourceDimension = 3;
+            dx10.arraySize = 1;
+            break;
+        default:
+            return fail(path, "cannot store this format as DDS");
+        }
+        if (h.format.fourCC) {
+            h.flags |= DDSD_LINEARSIZE;
+            h.format.flags = DDPF_FOURCC;
+            h.pitchOrLinearSize = static_cast<std::uint32_t>(levels[0].size());
+        }
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "Error: cannot write " << path << "\n";
+            return false;
+        }
+
+        file.write(DdsMagic, sizeof(DdsMagic));
+        file.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        if (dx10.dxgiFormat)
+            file.write(reinterpret_cast<const char*>(&dx10), sizeof(dx10));
+        for (const auto& level : levels)
+            file.write(reinterpret_cast<const char*>(level.data()), static_cast<std::streamsize>(level.size()));
+        return static_cast<bool>(file);
+    }
+
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+
+#include "BlockCompressor.hpp"
+#include "MappedFile.hpp"
+
+namespace gl {
+
+    /**
+     * @brief On-disk layout of `.dds` files, as far as we read and write them.
+     *
+     *   "DDS " [DdsHeader] [DdsHeaderDx10, when fourCC is "DX10"] [level 0] [level 1] ...
+     *
+     * BC1 and BC3 use the legacy "DXT1"/"DXT5" codes, BC7 needs the DX10
+     * extension header, RGBA8 is a plain 32-bit RGB pixel format. Our tools
+     * store rows bottom-up, the order GL samples them in, so files from
+     * other tools show upside down.
+     */
+    constexpr char DdsMagic[4] = { 'D', 'D', 'S', ' ' };
+
+    struct DdsPixelFormat {
+        std::uint32_t size;          // 32
+        std::uint32_t flags;
+        std::uint32_t fourCC;
+        std::uint32_t rgbBitCount;
+        std::uint32_t rBitMask;
+        std::uint32_t gBitMask;
+        std::uint32_t bBitMask;
+        std::uint32_t aBitMask;
+    };
+
+    struct DdsHeader {
+        std::uint32_t size;          // 124
+        std::uint32_t flags;
+        std::uint32_t height;
+        std::uint32_t width;
+        std::uint32_t pitchOrLinearSize;
+        std::uint32_t depth;
+        std::uint32_t mipMapCount;
+        std::uint32_t reserved1[11];
+        DdsPixelFormat format;
+        std::uint32_t caps;
+        std::uint32_t caps2;
+        std::uint32_t caps3;
+        std::uint32_t caps4;
+        std::uint32_t reserved2;
+    };
+
+    struct DdsHeaderDx10 {
+        std::uint32_t dxgiFormat;
+        std::uint32_t resourceDimension; // 3: 2D texture
+        std::uint32_t miscFlag;
+        std::uint32_t arraySize;
+        std::uint32_t miscFlags2;
+    };
+
+    static_assert(sizeof(DdsPixelFormat) == 32, "DdsPixelFormat must be tightly packed");
+    static_assert(sizeof(DdsHeader) == 124, "DdsHeader must be tightly packed");
+    static_assert(sizeof(DdsHeaderDx10) == 20, "DdsHeaderDx10 must be tightly packed");
+
+    /**
+     * @brief On-disk layout of `.ktx2` files (read only).
+     *
+     *   [identifier] [Ktx2Header] [Ktx2Level x levelCount] [DFD] [key/values] ... [levels]
+     *
+     * Single 2D images without supercompression, in RGBA8 or BC1/BC3/BC7.
+     * The level index gives every level's offset, smallest usually last.
+     */
+    constexpr unsigned char Ktx2Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+    struct Ktx2Header {
+        std::uint32_t vkFormat;
+        std::uint32_t typeSize;
+        std::uint32_t pixelWidth;
+        std::uint32_t pixelHeight;
+        std::uint32_t pixelDepth;
+        std::uint32_t layerCount;
+        std::uint32_t faceCount;
+        std::uint32_t levelCount;
+        std::uint32_t supercompressionScheme;
+        std::uint32_t dfdByteOffset;
+        std::uint32_t dfdByteLength;
+        std::uint32_t kvdByteOffset;
+        std::uint32_t kvdByteLength;
+        std::uint32_t sgdByteOffset[2]; // 64-bit fields, only 4-byte aligned in the file
+        std::uint32_t sgdByteLength[2];
+    };
+
+    struct Ktx2Level {
+        std::uint64_t byteOffset;
+        std::uint64_t byteLength;
+        std::uint64_t uncompressedByteLength;
+    };
+
+    static_assert(sizeof(Ktx2Header) == 68, "Ktx2Header must be tightly packed");
+    static_assert(sizeof(Ktx2Level) == 24, "Ktx2Level must be tightly packed");
+
+    /**
+     * @brief A texture container (`.dds` or `.ktx2`) with its mip chain,
+     * memory mapped.
+     *
+     * Levels point straight into the mapping, so they can be handed to
+     * glCompressedTexSubImage2D / glTexSubImage2D without a copy; they stay
+     * valid until the file is closed.
+     */
+    class TextureFile {
+    public:
+        struct Level {
+            const unsigned char* data;
+            std::size_t bytes;
+            int width, height;
+        };
+
+        bool open(const std::string& path);
+        void close();
+
+        // Internal format: GL_RGBA8 or one of BlockCompressor::glFormat()
+        GLenum glFormat() const { return m_glFormat; }
+        bool compressed() const { return m_glFormat != GL_RGBA8; }
+        int channels() const;
+        int width() const { return m_width; }
+        int height() const { return m_height; }
+        // Largest first; may stop short of 1x1
+        const std::vector<Level>& levels() const { return m_levels; }
+        // Every level, i.e. what the texture takes in VRAM
+        std::size_t dataSize() const;
+
+        // Bytes of one width x height level in `glFormat`
+        static std::size_t levelSize(GLenum glFormat, int width, int height);
+
+        // By extension; such paths skip image decoding entirely
+        static bool isContainer(const std::string& path);
+        // Dimensions from the header alone
+        static bool info(const std::string& path, int& width, int& height);
+
+        // `levels` from largest to smallest, each levelSize() bytes; GL_RGBA8
+        // or a block format
+        static bool writeDds(const std::string& path, GLenum glFormat, int width, int height,
+            const std::vector<std::vector<unsigned char>>& levels);
+
+    private:
+        MappedFile m_file;
+        GLenum m_glFormat = 0;
+        int m_width = 0;
+        int m_height = 0;
+        std::vector<Level> m_levels;
+    };
+
+}
@@ -0,0 +1,229 @@
+#include "TextureLoader.hpp"
+#include "TextureFile.hpp"
+
+#include "../ext/stb_image.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+namespace gl {
+
+    texture_load_stats& texture_load_stats::global() {
+        static texture_load_stats stats;
+        return stats;
+    }
+
+    namespace {
+        using clock = std::chrono::steady_clock;
+
+        double msSince(clock::time_point start) {
+            return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        }
+    }
+
+    TextureLoader::Request::~Request() {
+        if (pixels)
+            stbi_image_free(pixels);
+    }
+
+    TextureLoader::TextureLoader(std::size_t bytesPerFrame, ThreadPool& pool)
+        : m_pool(pool), m_budget(bytesPerFrame), m_decoded(1024) {
+    }
+
+    TextureLoader::~TextureLoader() {
+        // Jobs spin until their request fits into m_decoded, so keep
+        // draining it while they finish; requests are deleted here, on the
+        // GL thread, since they may own textures
+        m_stopping = true;
+        Request* done;
+        for (auto& job : m_jobs) {
+            while (job.wait_for(std::chrono::milliseconds(1)) != std::future_status::ready) {
+                while (m_decoded.tryPop(done))
+                    delete done;
+            }
+        }
+        while (m_decoded.tryPop(done))
+            delete done;
+
+        if (m_pbo)
+            glDeleteBuffers(1, &m_pbo);
+    }
+
+    void TextureLoader::load(Texture& target, const std::string& path, bool flipVertically,
+        std::function<void(Texture&)> onReady, std::function<void()> onFailed) {
+        auto request = std::make_unique<Request>();
+        request->target = &target;
+        request->path = path;
+        request->flip = flipVertically;
+        request->onReady = std::move(onReady);
+        request->onFailed = std::move(onFailed);
+        submit(std::move(request));
+    }
+
+    void TextureLoader::load(std::shared_ptr<Texture> target, const std::string& path, bool flipVertically,
+        std::function<void(Texture&)> onReady, std::function<void()> onFailed) {
+        auto request = std::make_unique<Request>();
+        request->target = target.get();
+        request->keepAlive = std::move(target);
+        request->path = path;
+        request->flip = flipVertically;
+        request->onReady = std::move(onReady);
+        request->onFailed = std::move(onFailed);
+        submit(std::move(request));
+    }
+
+    void TextureLoader::submit(std::unique_ptr<Request> request) {
+        auto& stats = texture_load_stats::global();
+        stats.queued++;
+
+        // Containers have nothing to decode; map them and let update()
+        // stream the levels
+        if (TextureFile::isContainer(request->path)) {
+            auto file = std::make_unique<TextureFile>();
+            if (!file->open(request->path) || !request->texture.allocate(*file)) {
+                std::cerr << "[TextureLoader] Failed to load: " << request->path << "\n";
+                stats.failed++;
+                if (request->onFailed)
+                    request->onFailed();
+                return;
+            }
+            request->level = static_cast<int>(file->levels().size()) - 1;
+            request->file = std::move(file);
+
+            request->target->createSolid(128, 128, 128);
+            m_pending++;
+            m_uploads.push_back(std::move(request));
+            return;
+        }
+
+        // Mid grey until the image is in
+        request->target->createSolid(128, 128, 128);
+        m_pending++;
+
+        // A pool without workers would run the job right here, and a full
+        // queue could then never drain
+        if (m_pool.threadCount() == 1) {
+            decode(request.get());
+            m_uploads.push_back(std::move(request));
+            return;
+        }
+
+        Request* raw = request.release();
+        m_jobs.push_back(m_pool.submit([this, raw] {
+            if (!m_stopping)
+                decode(raw);
+            while (!m_decoded.tryPush(raw))
+                std::this_thread::yield();
+        }));
+    }
+
+    // Worker side: only touches the request, never GL
+    void TextureLoader::decode(Request* request) {
+        auto start = clock::now();
+        int channels = 0;
+        stbi_set_flip_vertically_on_load_thread(request->flip);
+        request->pixels = stbi_load(request->path.c_str(), &request->width, &request->height, &channels, 4);
+        request->decodeMs = msSince(start);
+    }
+
+    std::size_t TextureLoader::update() {
+        auto start = clock::now();
+        auto& stats = texture_load_stats::global();
+
+        Request* decoded;
+        while (m_decoded.tryPop(decoded))
+            m_uploads.emplace_back(decoded);
+
+        m_jobs.erase(std::remove_if(m_jobs.begin(), m_jobs.end(), [](const std::future<void>& f) {
+            return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }), m_jobs.end());
+
+        std::size_t completed = 0;
+        std::size_t budget = m_budget;
+        while (!m_uploads.empty() && budget > 0) {
+            Request& r = *m_uploads.front();
+
+            if (!r.file && (!r.pixels || (!r.texture.id() && !r.texture.allocate(r.width, r.height)))) {
+                std::cerr << "[TextureLoader] Failed to load: " << r.path << "\n";
+                stats.failed++;
+                if (r.onFailed)
+                    r.onFailed();
+            }
+            else if (!(r.file ? uploadLevels(r, budget) : upload(r, budget))) {
+                break; // out of budget mid-image, resume next frame
+            }
+            else {
+                stats.loaded++;
+                stats.decodeMs += r.decodeMs;
+                *r.target = std::move(r.texture);
+                if (r.onReady)
+                    r.onReady(*r.target);
+                completed++;
+            }
+
+            m_uploads.pop_front();
+            m_pending--;
+        }
+
+        double ms = msSince(start);
+        stats.uploadMs += ms;
+        stats.worstUpdateMs = std::max(stats.worstUpdateMs, ms);
+        return completed;
+    }
+
+    bool TextureLoader::upload(Request& r, std::size_t& budget) {
+        const std::size_t rowBytes = static_cast<std::size_t>(r.width) * 4;
+        const int rows = static_cast<int>(std::min<std::size_t>(r.height - r.row, std::max<std::size_t>(1, budget / rowBytes)));
+        const std::size_t bytes = rows * rowBytes;
+
+        // Orphan, fill and source the upload from the PBO, so the driver
+        // can copy into the texture without the render thread waiting
+        if (!m_pbo)
+            glGenBuffers(1, &m_pbo);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+        void* dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        if (dst) {
+            std::memcpy(dst, r.pixels + r.row * rowBytes, bytes);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            r.texture.update(r.row, rows, nullptr);
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        // A mapping failure falls back to a plain client-memory upload
+        if (!dst)
+            r.texture.update(r.row, rows, r.pixels + r.row * rowBytes);
+
+        r.row += rows;
+        budget -= std::min(budget, bytes);
+        texture_load_stats::global().bytesUploaded += bytes;
+
+        if (r.row < r.height)
+            return false;
+
+        r.texture.generateMipmaps();
+        stbi_image_free(r.pixels);
+        r.pixels = nullptr;
+        return true;
+    }
+
+    bool TextureLoader::uploadLevels(Request& r, std::size_t& budget) {
+        // Each level goes whole, so one larger than the budget still makes
+        // progress, like a single row does
+        for (; r.level >= 0; r.level--) {
+            if (budget == 0)
+                return false;
+            const std::size_t bytes = r.file->levels()[r.level].bytes;
+            r.texture.updateLevel(*r.file, r.level);
+            budget -= std::min(budget, bytes);
+            texture_load_stats::global().bytesUploaded += bytes;
+        }
+
+        r.file.reset();
+        return true;
+    }
+
+}
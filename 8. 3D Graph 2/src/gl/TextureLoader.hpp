@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+
+#include "BoundedQueue.hpp"
+#include "Texture.hpp"
+#include "ThreadPool.hpp"
+
+namespace gl {
+
+    class TextureFile;
+
+    /**
+     * @brief Counters of the asynchronous texture loader. Times are summed
+     * over all images; reset by whoever prints them.
+     */
+    struct texture_load_stats {
+        std::size_t queued = 0;
+        std::size_t loaded = 0;
+        std::size_t failed = 0;
+        std::size_t bytesUploaded = 0;
+        double decodeMs = 0.0;      // on the workers
+        double uploadMs = 0.0;      // on the render thread, inside update()
+        double worstUpdateMs = 0.0; // longest single update()
+
+        void reset() { *this = texture_load_stats(); }
+
+        static texture_load_stats& global();
+    };
+
+    /**
+     * @brief Loads textures without stalling the render thread.
+     *
+     * load() gives the target a 1x1 placeholder and queues the file on the
+     * thread pool. Workers decode to RGBA8 and hand the pixels back through
+     * a lock-free queue. update(), called once per frame on the GL thread,
+     * streams decoded rows into the texture through a pixel buffer object,
+     * at most `bytesPerFrame` per call, so a large image is spread over
+     * several frames. The target is swapped to the finished texture (mips
+     * included) only once every row is in.
+     *
+     * `.dds`/`.ktx2` files have nothing to decode: they are mapped in
+     * load() and update() uploads their stored levels, smallest first,
+     * straight from the mapping under the same budget.
+     *
+     * Targets must stay where they are until their load completes or the
+     * loader is destroyed.
+     */
+    class TextureLoader {
+    public:
+        explicit TextureLoader(std::size_t bytesPerFrame = 4u << 20, ThreadPool& pool = ThreadPool::shared());
+        ~TextureLoader();
+
+        TextureLoader(const TextureLoader&) = delete;
+        TextureLoader& operator=(const TextureLoader&) = delete;
+
+        // `onReady` runs on the render thread, inside update(), after the
+        // swap; `onFailed` instead when the file cannot be loaded (inside
+        // load() already for an unreadable container)
+        void load(Texture& target, const std::string& path, bool flipVertically = true,
+            std::function<void(Texture&)> onReady = {}, std::function<void()> onFailed = {});
+        // Keeps `target` alive until the load completes
+        void load(std::shared_ptr<Texture> target, const std::string& path, bool flipVertically = true,
+            std::function<void(Texture&)> onReady = {}, std::function<void()> onFailed = {});
+
+        // Uploads within the budget; returns the number of textures completed
+        std::size_t update();
+
+        // Queued and not yet swapped in (including failures not yet reported)
+        std::size_t pending() const { return m_pending; }
+        bool idle() const { return m_pending == 0; }
+
+        void setBudget(std::size_t bytesPerFrame) { m_budget = bytesPerFrame; }
+        std::size_t budget() const { return m_budget; }
+
+        // Where the decodes run, for work that belongs next to them
+        ThreadPool& pool() const { return m_pool; }
+
+    private:
+        struct Request {
+            Texture* target = nullptr;
+            std::shared_ptr<Texture> keepAlive;
+            std::string path;
+            bool flip = true;
+            std::function<void(Texture&)> onReady;
+            std::function<void()> onFailed;
+
+            // Filled in by the worker
+            unsigned char* pixels = nullptr; // stbi allocation
+            int width = 0, height = 0;
+            double decodeMs = 0.0;
+
+            // Upload progress on the render thread
+            Texture texture;
+            int row = 0;
+
+            // Containers only: the mapped file and the next level to upload
+            std::unique_ptr<TextureFile> file;
+            int level = -1;
+
+            ~Request();
+        };
+
+        void submit(std::unique_ptr<Request> request);
+        void decode(Request* request);
+        // Streams up to `budget` bytes of rows into the allocated texture;
+        // true when the image is complete
+        bool upload(Request& request, std::size_t& budget);
+        // Same for a container's levels
+        bool uploadLevels(Request& request, std::size_t& budget);
+
+        ThreadPool& m_pool;
+        std::size_t m_budget;
+        std::atomic<bool> m_stopping{ false }; // set by the destructor, skips pending decodes
+        std::size_t m_pending = 0;
+
+        BoundedQueue<Request*> m_decoded;
+        std::deque<std::unique_ptr<Request>> m_uploads;
+        std::vector<std::future<void>> m_jobs;
+
+        GLuint m_pbo = 0;
+    };
+
+}
@@ -0,0 +1,121 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace gl {
+
+    ThreadPool::ThreadPool(unsigned threads) {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+
+        for (unsigned i = 1; i < threads; i++)
+            m_workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto& t : m_workers)
+            t.join();
+    }
+
+    std::future<void> ThreadPool::submit(std::function<void()> job) {
+        auto task = std::make_shared<std::packaged_task<void()>>(std::move(job));
+        std::future<void> done = task->get_future();
+
+        // Without workers the job runs inline
+        if (m_workers.empty()) {
+            (*task)();
+            return done;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobs.emplace_back([task] { (*task)(); });
+        }
+        m_wake.notify_one();
+        return done;
+    }
+
+    void ThreadPool::parallelFor(std::size_t count, const std::function<void(std::size_t)>& fn) {
+        if (count == 0)
+            return;
+
+        // Completion is counted per index rather than per helper: when the
+        // caller is itself a pool job, helpers may sit in the queue behind
+        // it and never start, and the caller then simply runs every index.
+        // Helpers starting late find nothing left and never touch `fn`.
+        struct loop_state {
+            std::atomic<std::size_t> next{ 0 };
+            std::size_t count = 0;
+            const std::function<void(std::size_t)>* fn = nullptr;
+            std::mutex mutex;
+            std::condition_variable finished;
+            std::size_t done = 0;
+            std::exception_ptr error;
+        };
+        auto state = std::make_shared<loop_state>();
+        state->count = count;
+        state->fn = &fn;
+
+        auto drain = [state] {
+            std::size_t ran = 0;
+            std::exception_ptr error;
+            for (std::size_t i = state->next++; i < state->count; i = state->next++) {
+                try {
+                    (*state->fn)(i);
+                }
+                catch (...) {
+                    if (!error)
+                        error = std::current_exception();
+                }
+                ran++;
+            }
+            if (ran == 0)
+                return;
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (error && !state->error)
+                state->error = error;
+            state->done += ran;
+            if (state->done == state->count)
+                state->finished.notify_all();
+        };
+
+        std::size_t helpers = std::min<std::size_t>(m_workers.size(), count - 1);
+        for (std::size_t i = 0; i < helpers; i++)
+            submit(drain);
+
+        drain();
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->finished.wait(lock, [&] { return state->done == state->count; });
+        if (state->error)
+            std::rethrow_exception(state->error);
+    }
+
+    ThreadPool& ThreadPool::shared() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    void ThreadPool::workerLoop() {
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+                if (m_stop && m_jobs.empty())
+                    return;
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gl {
+
+    /**
+     * @brief Fixed-size pool of worker threads for CPU-side loading work.
+     *
+     * parallelFor() lets the calling thread take part, so a pool built for
+     * N threads runs N-1 workers.
+     */
+    class ThreadPool {
+    private:
+        std::vector<std::thread> m_workers;
+        std::deque<std::function<void()>> m_jobs;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        bool m_stop = false;
+
+    public:
+        // threads = 0 uses one per hardware thread
+        explicit ThreadPool(unsigned threads = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /// Threads taking part in parallelFor, including the caller
+        unsigned threadCount() const { return static_cast<unsigned>(m_workers.size()) + 1; }
+
+        /// Queue a job for a worker thread
+        std::future<void> submit(std::function<void()> job);
+
+        /// Run fn(0..count-1) across the pool and the calling thread, blocking until done.
+        /// Safe to call from inside a job of the same pool, even with every worker busy
+        void parallelFor(std::size_t count, const std::function<void(std::size_t)>& fn);
+
+        /// Process-wide pool sized to the hardware
+        static ThreadPool& shared();
+
+    private:
+        void workerLoop();
+    };
+
+}
@@ -0,0 +1,267 @@
+#include "TransformStore.hpp"
+
+#include <cstring>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define TRANSFORM_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace gl {
+
+    namespace {
+        // Same result as translate(p) * mat4_cast(q) * scale(s)
+        void compose(glm::mat4& m, float px, float py, float pz,
+            float qx, float qy, float qz, float qw, float sx, float sy, float sz) {
+            float xx = qx * qx, yy = qy * qy, zz = qz * qz;
+            float xy = qx * qy, xz = qx * qz, yz = qy * qz;
+            float wx = qw * qx, wy = qw * qy, wz = qw * qz;
+
+            m[0] = glm::vec4((1 - 2 * (yy + zz)) * sx, 2 * (xy + wz) * sx, 2 * (xz - wy) * sx, 0.0f);
+            m[1] = glm::vec4(2 * (xy - wz) * sy, (1 - 2 * (xx + zz)) * sy, 2 * (yz + wx) * sy, 0.0f);
+            m[2] = glm::vec4(2 * (xz + wy) * sz, 2 * (yz - wx) * sz, (1 - 2 * (xx + yy)) * sz, 0.0f);
+            m[3] = glm::vec4(px, py, pz, 1.0f);
+        }
+
+        void multiply(glm::mat4& out, const glm::mat4& a, const glm::mat4& b) {
+#ifdef TRANSFORM_SSE
+            __m128 a0 = _mm_loadu_ps(&a[0][0]);
+            __m128 a1 = _mm_loadu_ps(&a[1][0]);
+            __m128 a2 = _mm_loadu_ps(&a[2][0]);
+            __m128 a3 = _mm_loadu_ps(&a[3][0]);
+            for (int c = 0; c < 4; c++) {
+                __m128 r = _mm_mul_ps(a0, _mm_set1_ps(b[c][0]));
+                r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(b[c][1])));
+                r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(b[c][2])));
+                r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(b[c][3])));
+                _mm_storeu_ps(&out[c][0], r);
+            }
+#else
+            out = a * b;
+#endif
+        }
+    }
+
+    TransformStore& TransformStore::shared() {
+        static TransformStore store;
+        return store;
+    }
+
+    TransformStore::id TransformStore::create() {
+        if (m_free.empty()) {
+            std::size_t first = m_px.size();
+            std::size_t grown = first + 4;
+            for (auto* v : { &m_px, &m_py, &m_pz, &m_qx, &m_qy, &m_qz })
+                v->resize(grown, 0.0f);
+            m_qw.resize(grown, 1.0f);
+            for (auto* v : { &m_sx, &m_sy, &m_sz })
+                v->resize(grown, 1.0f);
+            m_dirty.resize(grown, 0);
+            m_used.resize(grown, 0);
+            m_world.resize(grown, glm::mat4(1.0f));
+            m_mvp.resize(grown, glm::mat4(1.0f));
+            m_mvpEpoch.resize(grown, 0);
+
+            // Lowest slot first
+            for (std::size_t i = grown; i > first; i--)
+                m_free.push_back(static_cast<id>(i - 1));
+        }
+
+        id slot = m_free.back();
+        m_free.pop_back();
+
+        m_px[slot] = m_py[slot] = m_pz[slot] = 0.0f;
+        m_qx[slot] = m_qy[slot] = m_qz[slot] = 0.0f;
+        m_qw[slot] = 1.0f;
+        m_sx[slot] = m_sy[slot] = m_sz[slot] = 1.0f;
+        m_used[slot] = 1;
+        m_world[slot] = glm::mat4(1.0f);
+        m_mvpEpoch[slot] = 0;
+        if (m_dirty[slot]) {
+            m_dirty[slot] = 0;
+            m_dirtyCount--;
+        }
+        m_live++;
+        return slot;
+    }
+
+    void TransformStore::destroy(id slot) {
+        if (slot == invalid || slot >= m_used.size() || !m_used[slot])
+            return;
+        m_used[slot] = 0;
+        if (m_dirty[slot]) {
+            m_dirty[slot] = 0;
+            m_dirtyCount--;
+        }
+        m_live--;
+        m_free.push_back(slot);
+    }
+
+    void TransformStore::setPosition(id slot, const glm::vec3& p) {
+        m_px[slot] = p.x; m_py[slot] = p.y; m_pz[slot] = p.z;
+        if (!m_dirty[slot]) { m_dirty[slot] = 1; m_dirtyCount++; }
+    }
+
+    void TransformStore::setRotation(id slot, const glm::quat& q) {
+        m_qx[slot] = q.x; m_qy[slot] = q.y; m_qz[slot] = q.z; m_qw[slot] = q.w;
+        if (!m_dirty[slot]) { m_dirty[slot] = 1; m_dirtyCount++; }
+    }
+
+    void TransformStore::setScale(id slot, const glm::vec3& s) {
+        m_sx[slot] = s.x; m_sy[slot] = s.y; m_sz[slot] = s.z;
+        if (!m_dirty[slot]) { m_dirty[slot] = 1; m_dirtyCount++; }
+    }
+
+    glm::vec3 TransformStore::position(id slot) const { return glm::vec3(m_px[slot], m_py[slot], m_pz[slot]); }
+    glm::quat TransformStore::rotation(id slot) const { return glm::quat(m_qw[slot], m_qx[slot], m_qy[slot], m_qz[slot]); }
+    glm::vec3 TransformStore::scale(id slot) const { return glm::vec3(m_sx[slot], m_sy[slot], m_sz[slot]); }
+
+    const glm::mat4& TransformStore::world(id slot) {
+        if (m_dirty[slot]) {
+            rebuild(slot);
+            m_dirty[slot] = 0;
+            m_dirtyCount--;
+        }
+        else {
+            transform_stats::global().hits++;
+        }
+        return m_world[slot];
+    }
+
+    const glm::mat4& TransformStore::mvp(id slot, const glm::mat4& viewProj) {
+        setViewProj(viewProj);
+        const glm::mat4& w = world(slot);
+        if (m_mvpEpoch[slot] != m_epoch) {
+            multiply(m_mvp[slot], m_viewProj, w);
+            m_mvpEpoch[slot] = m_epoch;
+            transform_stats::global().mvpRebuilds++;
+        }
+        return m_mvp[slot];
+    }
+
+    void TransformStore::rebuild(std::size_t s) {
+        compose(m_world[s], m_px[s], m_py[s], m_pz[s], m_qx[s], m_qy[s], m_qz[s], m_qw[s], m_sx[s], m_sy[s], m_sz[s]);
+        m_mvpEpoch[s] = 0;
+        transform_stats::global().rebuilds++;
+    }
+
+    void TransformStore::rebuildBlock(std::size_t first) {
+#ifdef TRANSFORM_SSE
+        const __m128 one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f), zero = _mm_setzero_ps();
+
+        __m128 qx = _mm_loadu_ps(&m_qx[first]), qy = _mm_loadu_ps(&m_qy[first]);
+        __m128 qz = _mm_loadu_ps(&m_qz[first]), qw = _mm_loadu_ps(&m_qw[first]);
+        __m128 sx = _mm_loadu_ps(&m_sx[first]), sy = _mm_loadu_ps(&m_sy[first]), sz = _mm_loadu_ps(&m_sz[first]);
+
+        __m128 xx = _mm_mul_ps(qx, qx), yy = _mm_mul_ps(qy, qy), zz = _mm_mul_ps(qz, qz);
+        __m128 xy = _mm_mul_ps(qx, qy), xz = _mm_mul_ps(qx, qz), yz = _mm_mul_ps(qy, qz);
+        __m128 wx = _mm_mul_ps(qw, qx), wy = _mm_mul_ps(qw, qy), wz = _mm_mul_ps(qw, qz);
+
+        // Rows are one matrix element across four objects
+        __m128 col[4][4];
+        col[0][0] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+        col[0][1] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+        col[0][2] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+        col[0][3] = zero;
+        col[1][0] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+        col[1][1] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+        col[1][2] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+        col[1][3] = zero;
+        col[2][0] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+        col[2][1] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+        col[2][2] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+        col[2][3] = zero;
+        col[3][0] = _mm_loadu_ps(&m_px[first]);
+        col[3][1] = _mm_loadu_ps(&m_py[first]);
+        col[3][2] = _mm_loadu_ps(&m_pz[first]);
+        col[3][3] = one;
+
+        // Transpose each column from SoA back to one vec4 per object
+        for (int c = 0; c < 4; c++) {
+            __m128 r0 = col[c][0], r1 = col[c][1], r2 = col[c][2], r3 = col[c][3];
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            _mm_storeu_ps(&m_world[first + 0][c][0], r0);
+            _mm_storeu_ps(&m_world[first + 1][c][0], r1);
+            _mm_storeu_ps(&m_world[first + 2][c][0], r2);
+            _mm_storeu_ps(&m_world[first + 3][c][0], r3);
+        }
+#else
+        for (std::size_t s = first; s < first + 4; s++)
+            compose(m_world[s], m_px[s], m_py[s], m_pz[s], m_qx[s], m_qy[s], m_qz[s], m_qw[s], m_sx[s], m_sy[s], m_sz[s]);
+#endif
+    }
+
+    void TransformStore::update() {
+        if (m_dirtyCount == 0)
+            return;
+
+        auto& stats = transform_stats::global();
+        for (std::size_t first = 0; first < m_dirty.size(); first += 4) {
+            std::uint32_t any;
+            std::memcpy(&any, &m_dirty[first], sizeof(any));
+            if (!any)
+                continue;
+
+            // Clean neighbours in the block come out unchanged
+            rebuildBlock(first);
+            for (std::size_t s = first; s < first + 4; s++) {
+                if (m_dirty[s]) {
+                    m_dirty[s] = 0;
+                    m_mvpEpoch[s] = 0;
+                    stats.rebuilds++;
+                }
+            }
+        }
+        m_dirtyCount = 0;
+    }
+
+    void TransformStore::update(const glm::mat4& viewProj) {
+        setViewProj(viewProj);
+        update();
+
+        auto& stats = transform_stats::global();
+        for (std::size_t s = 0; s < m_used.size(); s++) {
+            if (!m_used[s] || m_mvpEpoch[s] == m_epoch)
+                continue;
+            multiply(m_mvp[s], m_viewProj, m_world[s]);
+            m_mvpEpoch[s] = m_epoch;
+            stats.mvpRebuilds++;
+        }
+    }
+
+    void TransformStore::setViewProj(const glm::mat4& viewProj) {
+        if (viewProj == m_viewProj)
+            return;
+        m_viewProj = viewProj;
+        if (++m_epoch == 0)
+            m_epoch = 1;
+    }
+
+    // ---------------------------
+    // transform_handle
+    // ---------------------------
+    transform_handle::transform_handle(TransformStore& store)
+        : m_store(&store), m_id(store.create()) {
+    }
+
+    transform_handle::~transform_handle() {
+        if (m_store)
+            m_store->destroy(m_id);
+    }
+
+    transform_handle::transform_handle(transform_handle&& other) noexcept
+        : m_store(other.m_store), m_id(other.m_id) {
+        other.m_id = TransformStore::invalid;
+    }
+
+    transform_handle& transform_handle::operator=(transform_handle&& other) noexcept {
+        if (this != &other) {
+            m_store->destroy(m_id);
+            m_store = other.m_store;
+            m_id = other.m_id;
+            other.m_id = TransformStore::invalid;
+        }
+        return *this;
+    }
+
+}
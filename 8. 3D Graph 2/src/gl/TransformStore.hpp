@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "transform.hpp"
+
+namespace gl {
+
+    /**
+     * @brief Positions, rotations and scales of many objects, stored as
+     * separate contiguous arrays (structure of arrays).
+     *
+     * World matrices are rebuilt behind per-slot dirty flags: either one
+     * at a time when world() finds its slot dirty, or all at once by
+     * update(), which runs four objects per SSE iteration. MVP matrices
+     * are cached per slot until the world matrix or viewProj changes.
+     *
+     * Slots are reused after destroy(); Model and TexModel hold one
+     * through a transform_handle.
+     */
+    class TransformStore {
+    public:
+        using id = std::uint32_t;
+        static constexpr id invalid = ~0u;
+
+        // New slot with the identity transform
+        id create();
+        void destroy(id slot);
+
+        void setPosition(id slot, const glm::vec3& p);
+        void setRotation(id slot, const glm::quat& q);
+        void setScale(id slot, const glm::vec3& s);
+
+        glm::vec3 position(id slot) const;
+        glm::quat rotation(id slot) const;
+        glm::vec3 scale(id slot) const;
+
+        // translate * rotate * scale, rebuilt here if the slot is dirty
+        const glm::mat4& world(id slot);
+        // viewProj * world(slot), rebuilt if either side changed
+        const glm::mat4& mvp(id slot, const glm::mat4& viewProj);
+
+        // Rebuilds every dirty world matrix in SIMD batches
+        void update();
+        // ... and every stale MVP for this viewProj
+        void update(const glm::mat4& viewProj);
+
+        std::size_t size() const { return m_live; }
+        std::size_t capacity() const { return m_px.size(); }
+
+        // Whole arrays, for passes that walk every object
+        const std::vector<glm::mat4>& worlds() const { return m_world; }
+        const std::vector<glm::mat4>& mvps() const { return m_mvp; }
+
+        // Store used by Model and TexModel
+        static TransformStore& shared();
+
+    private:
+        void rebuild(std::size_t slot);
+        void rebuildBlock(std::size_t first); // 4 slots starting at `first`
+        void setViewProj(const glm::mat4& viewProj);
+
+        // Slots come in blocks of 4 so SIMD loads never run off the end
+        std::vector<float> m_px, m_py, m_pz;
+        std::vector<float> m_qx, m_qy, m_qz, m_qw;
+        std::vector<float> m_sx, m_sy, m_sz;
+        std::vector<std::uint8_t> m_dirty;
+        std::vector<std::uint8_t> m_used;
+
+        std::vector<glm::mat4> m_world;
+        std::vector<glm::mat4> m_mvp;
+        std::vector<std::uint32_t> m_mvpEpoch; // == m_epoch while m_mvp is current
+
+        glm::mat4 m_viewProj{ 1.0f };
+        std::uint32_t m_epoch = 1;
+        std::size_t m_dirtyCount = 0;
+        std::size_t m_live = 0;
+        std::vector<id> m_free;
+    };
+
+    /**
+     * @brief Owning reference to a TransformStore slot. Move-only; the
+     * slot is released when the handle dies.
+     */
+    class transform_handle {
+    public:
+        explicit transform_handle(TransformStore& store = TransformStore::shared());
+        ~transform_handle();
+
+        transform_handle(const transform_handle&) = delete;
+        transform_handle& operator=(const transform_handle&) = delete;
+        transform_handle(transform_handle&& other) noexcept;
+        transform_handle& operator=(transform_handle&& other) noexcept;
+
+        void setPosition(const glm::vec3& p) { m_store->setPosition(m_id, p); }
+        void setRotation(const glm::quat& q) { m_store->setRotation(m_id, q); }
+        void setScale(const glm::vec3& s) { m_store->setScale(m_id, s); }
+
+        glm::vec3 position() const { return m_store->position(m_id); }
+        glm::quat rotation() const { return m_store->rotation(m_id); }
+        glm::vec3 scale() const { return m_store->scale(m_id); }
+
+        const glm::mat4& world() const { return m_store->world(m_id); }
+        const glm::mat4& mvp(const glm::mat4& viewProj) const { return m_store->mvp(m_id, viewProj); }
+
+        TransformStore::id id() const { return m_id; }
+
+    private:
+        TransformStore* m_store;
+        TransformStore::id m_id;
+    };
+
+}
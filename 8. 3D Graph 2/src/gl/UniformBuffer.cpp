@@ -0,0 +1,66 @@
+#include "UniformBuffer.hpp"
+#include "Shader.hpp"
+
+#include <iostream>
+
+namespace gl {
+
+    UniformBuffer::~UniformBuffer() {
+        destroy();
+    }
+
+    UniformBuffer::UniformBuffer(UniformBuffer&& other) noexcept
+        : m_id(other.m_id), m_binding(other.m_binding), m_size(other.m_size) {
+        other.m_id = 0;
+        other.m_size = 0;
+    }
+
+    UniformBuffer& UniformBuffer::operator=(UniformBuffer&& other) noexcept {
+        if (this != &other) {
+            destroy();
+            m_id = other.m_id;
+            m_binding = other.m_binding;
+            m_size = other.m_size;
+            other.m_id = 0;
+            other.m_size = 0;
+        }
+        return *this;
+    }
+
+    bool UniformBuffer::create(const std::string& block, GLuint binding, std::size_t bytes) {
+        destroy();
+
+        glGenBuffers(1, &m_id);
+        if (!m_id) {
+            std::cerr << "Failed to create uniform buffer for block " << block << "\n";
+            return false;
+        }
+        m_binding = binding;
+        m_size = bytes;
+
+        glBindBuffer(GL_UNIFORM_BUFFER, m_id);
+        glBufferData(GL_UNIFORM_BUFFER, bytes, nullptr, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, binding, m_id);
+
+        Shader::bindBlock(block, binding);
+        return true;
+    }
+
+    void UniformBuffer::update(const void* data, std::size_t bytes, std::size_t offset) {
+        if (!m_id || offset + bytes > m_size) {
+            std::cerr << "Uniform buffer update out of range: " << offset + bytes << " > " << m_size << "\n";
+            return;
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, m_id);
+        glBufferSubData(GL_UNIFORM_BUFFER, offset, bytes, data);
+    }
+
+    void UniformBuffer::destroy() {
+        if (m_id) {
+            glDeleteBuffers(1, &m_id);
+            m_id = 0;
+        }
+        m_size = 0;
+    }
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+namespace gl {
+
+    /**
+     * @brief A uniform buffer attached to a fixed binding point.
+     *
+     * create() also registers the block name with Shader::bindBlock, so
+     * every program linked afterwards that declares the block reads from
+     * this buffer without any per-shader setup.
+     */
+    class UniformBuffer {
+    private:
+        GLuint m_id = 0;
+        GLuint m_binding = 0;
+        std::size_t m_size = 0;
+
+    public:
+        UniformBuffer() = default;
+        ~UniformBuffer();
+
+        UniformBuffer(const UniformBuffer&) = delete;
+        UniformBuffer& operator=(const UniformBuffer&) = delete;
+        UniformBuffer(UniformBuffer&& other) noexcept;
+        UniformBuffer& operator=(UniformBuffer&& other) noexcept;
+
+        bool create(const std::string& block, GLuint binding, std::size_t bytes);
+
+        void update(const void* data, std::size_t bytes, std::size_t offset = 0);
+
+        template<typename T>
+        void update(const T& value) { update(&value, sizeof(T)); }
+
+        void destroy();
+
+        GLuint id() const { return m_id; }
+        GLuint binding() const { return m_binding; }
+        std::size_t size() const { return m_size; }
+    };
+
+    /**
+     * @brief Per-frame camera data, laid out like the std140 `Frame`
+     * block the shaders declare:
+     *
+     *   layout(std140) uniform Frame {
+     *       mat4 view;
+     *       mat4 projection;
+     *       mat4 viewProj;
+     *       vec4 cameraPosition; // w = 1
+     *       float time;
+     *   };
+     */
+    struct frame_uniforms {
+        static constexpr GLuint binding = 0;
+        static constexpr const char* block = "Frame";
+
+        glm::mat4 view{ 1.0f };
+        glm::mat4 projection{ 1.0f };
+        glm::mat4 viewProj{ 1.0f };
+        glm::vec4 cameraPosition{ 0.0f, 0.0f, 0.0f, 1.0f };
+        float time = 0.0f;
+        float padding[3] = {}; // std140 rounds the block up to a vec4
+    };
+
+    static_assert(sizeof(frame_uniforms) == 3 * 64 + 16 + 16, "frame_uniforms must match the std140 Frame block");
+
+}
@@ -29,6 +29,12 @@ namespace gl {
             return false;
         }
 
+        // The renderer needs GL 4.2 (glProgramUniform*, glTexStorage*);
+        // ask for a core context of at least that unless told otherwise
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, requiredMajor);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, requiredMinor);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
         // Apply user-provided hints
         for (const auto& hint : hints) {
             glfwWindowHint(hint.first, hint.second);
@@ -46,14 +52,29 @@ namespace gl {
         // LOAD OPENGL FUNCTIONS USING GLAD
         if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
             std::cout << "Failed to initialize GLAD" << std::endl;
-            return -1;
+            terminate();
+            return false;
+        }
+
+        // Entry points past the context's version are null; fail here
+        // rather than crash on the first call
+        if (!GLAD_GL_VERSION_4_2) {
+            std::cerr << "OpenGL " << requiredMajor << "." << requiredMinor << " required, the context has "
+                      << GLVersion.major << "." << GLVersion.minor << "\n";
+            terminate();
+            return false;
         }
 
+        state.invalidate();
+        StateCache::makeCurrent(&state);
+
         return true;
     }
 
     void Window::terminate() {
         if (handle) {
+            if (&StateCache::current() == &state)
+                StateCache::makeCurrent(nullptr);
             glfwDestroyWindow(handle);
             handle = nullptr;
         }
@@ -6,9 +6,17 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include "StateCache.hpp"
+
 namespace gl {
 
     class Window {
+    public:
+
+        // Oldest context the renderer runs on
+        static constexpr int requiredMajor = 4;
+        static constexpr int requiredMinor = 2;
+
     private:
 
         GLFWwindow* handle;
@@ -17,6 +25,7 @@ namespace gl {
         std::string title;
         bool fullscreen;
         std::unordered_map<int, int> hints;
+        StateCache state; // shadow of this window's context
 
     public:
 
@@ -47,6 +56,7 @@ namespace gl {
         std::string getTitle() const;
         bool isFullscreen() const;
         GLFWwindow* getHandle() const;
+        StateCache& getState() { return state; }
 
     public:
 
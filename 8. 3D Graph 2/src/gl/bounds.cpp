@@ -0,0 +1,74 @@
+#include "bounds.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace gl {
+
+    bounds bounds::of(const void* vertices, std::size_t vertexBytes, const vertex_layout& layout) {
+        bounds b;
+        const vertex_layout::Attribute* pos = layout.position();
+        const std::size_t stride = layout.stride();
+        if (!pos || stride == 0 || vertexBytes < stride)
+            return b;
+
+        const unsigned char* base = static_cast<const unsigned char*>(vertices) + pos->offset;
+        const std::size_t count = vertexBytes / stride;
+
+        glm::vec3 lo(1e30f), hi(-1e30f);
+        for (std::size_t v = 0; v < count; v++) {
+            glm::vec3 p;
+            std::memcpy(&p[0], base + v * stride, sizeof(float) * 3);
+            lo = glm::min(lo, p);
+            hi = glm::max(hi, p);
+        }
+
+        glm::vec3 center = (lo + hi) * 0.5f;
+        float radius2 = 0.0f;
+        for (std::size_t v = 0; v < count; v++) {
+            glm::vec3 p;
+            std::memcpy(&p[0], base + v * stride, sizeof(float) * 3);
+            glm::vec3 d = p - center;
+            radius2 = std::max(radius2, glm::dot(d, d));
+        }
+
+        b.min = lo;
+        b.max = hi;
+        b.center = center;
+        b.radius = std::sqrt(radius2);
+        b.empty = false;
+        return b;
+    }
+
+    glm::vec4 bounds::sphere(const glm::mat4& model) const {
+        // Largest axis scale, so rotated or non-uniformly scaled spheres still enclose
+        float sx = glm::dot(glm::vec3(model[0]), glm::vec3(model[0]));
+        float sy = glm::dot(glm::vec3(model[1]), glm::vec3(model[1]));
+        float sz = glm::dot(glm::vec3(model[2]), glm::vec3(model[2]));
+        float scale = std::sqrt(std::max(sx, std::max(sy, sz)));
+        return glm::vec4(glm::vec3(model * glm::vec4(center, 1.0f)), radius * scale);
+    }
+
+    aabb aabb::transformed(const glm::mat4& model) const {
+        // Arvo: each output axis takes the smaller/larger product per input axis
+        aabb b;
+        if (empty())
+            return b;
+        b.min = b.max = glm::vec3(model[3]);
+        for (int c = 0; c < 3; c++) {
+            glm::vec3 lo = glm::vec3(model[c]) * min[c];
+            glm::vec3 hi = glm::vec3(model[c]) * max[c];
+            b.min += glm::min(lo, hi);
+            b.max += glm::max(lo, hi);
+        }
+        return b;
+    }
+
+    aabb bounds::box(const glm::mat4& model) const {
+        if (empty)
+            return aabb();
+        return aabb{ min, max }.transformed(model);
+    }
+
+}
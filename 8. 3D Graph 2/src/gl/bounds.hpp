@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+
+#include "vertex_layout.hpp"
+
+namespace gl {
+
+    // Axis-aligned box; the default one is empty (min > max)
+    struct aabb {
+        glm::vec3 min{ 1e30f };
+        glm::vec3 max{ -1e30f };
+
+        void grow(const glm::vec3& p) { min = glm::min(min, p); max = glm::max(max, p); }
+        void grow(const aabb& b) { min = glm::min(min, b.min); max = glm::max(max, b.max); }
+        glm::vec3 center() const { return (min + max) * 0.5f; }
+        glm::vec3 extent() const { return max - min; }
+        bool empty() const { return min.x > max.x; }
+        float area() const {
+            glm::vec3 e = glm::max(extent(), glm::vec3(0.0f));
+            return 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+        }
+
+        // Box around this box after `model`
+        aabb transformed(const glm::mat4& model) const;
+    };
+
+    /**
+     * @brief Axis-aligned box and bounding sphere of a mesh, in mesh space.
+     *
+     * The sphere is centered on the box and just encloses every vertex,
+     * which is tighter than the box's own circumsphere for most meshes.
+     */
+    struct bounds {
+        glm::vec3 min{ 0.0f };
+        glm::vec3 max{ 0.0f };
+        glm::vec3 center{ 0.0f };
+        float radius = 0.0f;
+        bool empty = true;
+
+        // Bounds of the layout's position attribute (vertex_layout::position)
+        static bounds of(const void* vertices, std::size_t vertexBytes, const vertex_layout& layout);
+
+        // Sphere enclosing these bounds after `model`, as (center, radius)
+        glm::vec4 sphere(const glm::mat4& model) const;
+        // World-space box around the transformed box
+        aabb box(const glm::mat4& model) const;
+    };
+
+}
@@ -0,0 +1,10 @@
+#include "transform.hpp"
+
+namespace gl {
+
+    transform_stats& transform_stats::global() {
+        static transform_stats stats;
+        return stats;
+    }
+
+}
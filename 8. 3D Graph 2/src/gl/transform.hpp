@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+
+namespace gl {
+
+    /**
+     * @brief Process-wide counters of model matrix work, used to check
+     * that static objects stop costing matrix math once cached.
+     */
+    struct transform_stats {
+        std::size_t rebuilds = 0;    // translate * rotate * scale recomputed
+        std::size_t mvpRebuilds = 0; // viewProj * model recomputed
+        std::size_t hits = 0;        // matrix served from the cache
+
+        void reset() { *this = transform_stats(); }
+
+        static transform_stats& global();
+    };
+
+}
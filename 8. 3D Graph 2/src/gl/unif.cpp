@@ -1,11 +1,38 @@
 #include "unif.hpp"
 #include <iostream>
+#include <cstring>
 
 namespace gl {
 
+    // -------------------- Stats / Shadow --------------------
+    uniform_stats& uniform_stats::global() {
+        static uniform_stats stats;
+        return stats;
+    }
+
+    bool uniform_slot::update(const void* data, std::size_t bytes) {
+        if (known && std::memcmp(value, data, bytes) == 0)
+            return false;
+        std::memcpy(value, data, bytes);
+        known = true;
+        return true;
+    }
+
     // -------------------- Constructor --------------------
-    unif::unif(GLuint program, const std::string& name, GLint location)
-        : m_programID(program), m_location(location), m_name(name) {
+    unif::unif(GLuint program, const std::string& name, GLint location, uniform_slot* slot)
+        : m_programID(program), m_location(location), m_name(name), m_slot(slot) {
+    }
+
+    // Shadowed uniforms skip the GL call when the value is unchanged
+    template<typename T>
+    bool unif::changed(const T& v) {
+        auto& stats = uniform_stats::global();
+        if (m_slot && !m_slot->update(&v, sizeof(T))) {
+            stats.skipped++;
+            return false;
+        }
+        stats.issued++;
+        return true;
     }
 
     GLint unif::location() const {
@@ -20,49 +47,50 @@ namespace gl {
 
     // -------------------- Setters --------------------
     unif& unif::operator=(int v) {
-        if (m_location != -1) glUniform1i(m_location, v);
+        if (m_location != -1) { if (changed(v)) glProgramUniform1i(m_programID, m_location, v); }
         else std::cerr << "Uniform not found: " << m_name << "\n";
         return *this;
     }
 
     unif& unif::operator=(float v) {
-        if (m_location != -1) glUniform1f(m_location, v);
+        if (m_location != -1) { if (changed(v)) glProgramUniform1f(m_programID, m_location, v); }
         else std::cerr << "Uniform not found: " << m_name << "\n";
         return *this;
     }
 
     unif& unif::operator=(bool v) {
-        if (m_location != -1) glUniform1i(m_location, v ? 1 : 0);
+        int i = v ? 1 : 0;
+        if (m_location != -1) { if (changed(i)) glProgramUniform1i(m_programID, m_location, i); }
         else std::cerr << "Uniform not found: " << m_name << "\n";
         return *this;
     }
 
     unif& unif::operator=(const glm::vec2& v) {
-        if (m_location != -1) glUniform2fv(m_location, 1, glm::value_ptr(v));
+        if (m_location != -1) { if (changed(v)) glProgramUniform2fv(m_programID, m_location, 1, glm::value_ptr(v)); }
         else std::cerr << "Uniform not found: " << m_name << "\n";
         return *this;
     }
 
     unif& unif::operator=(const glm::vec3& v) {
-        if (m_location != -1) glUniform3fv(m_location, 1, glm::value_ptr(v));
+        if (m_location != -1) { if (changed(v)) glProgramUniform3fv(m_programID, m_location, 1, glm::value_ptr(v)); }
         else std::cerr << "Uniform not found: " << m_name << "\n";
         return *this;
     }
 
     unif& unif::operator=(const glm::vec4& v) {
-        if (m_location != -1) glUniform4fv(m_location, 1, glm::value_ptr(v));
+        if (m_location != -1) { if (changed(v)) glProgramUniform4fv(m_programID, m_location, 1, glm::value_ptr(v)); }
         else std::cerr << "Uniform not found: " << m_name << "\n";
         return *this;
     }
 
     unif& unif::operator=(const glm::mat3& v) {
-        if (m_location != -1) glUniformMatrix3fv(m_location, 1, GL_FALSE, glm::value_ptr(v));
+        if (m_location != -1) { if (changed(v)) glProgramUniformMatrix3fv(m_programID, m_location, 1, GL_FALSE, glm::value_ptr(v)); }
         else std::cerr << "Uniform not found: " << m_name << "\n";
         return *this;
     }
 
     unif& unif::operator=(const glm::mat4& v) {
-        if (m_location != -1) glUniformMatrix4fv(m_location, 1, GL_FALSE, glm::value_ptr(v));
+        if (m_location != -1) { if (changed(v)) glProgramUniformMatrix4fv(m_programID, m_location, 1, GL_FALSE, glm::value_ptr(v)); }
         else std::cerr << "Uniform not found: " << m_name << "\n";
         return *this;
     }
@@ -1,18 +1,57 @@
+#pragma once
+
 #include <string>
+#include <cstddef>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 namespace gl {
 
+    /**
+     * @brief Process-wide uniform counters, used to measure how many
+     * driver calls the Shader uniform cache saves.
+     */
+    struct uniform_stats {
+        std::size_t hits = 0;     // name resolved from the reflected table
+        std::size_t misses = 0;   // name had to go through glGetUniformLocation
+        std::size_t issued = 0;   // glUniform* calls made
+        std::size_t skipped = 0;  // glUniform* calls elided, value unchanged
+
+        void reset() { *this = uniform_stats(); }
+
+        static uniform_stats& global();
+    };
+
+    /**
+     * @brief One active uniform of a linked program plus a shadow copy of
+     * the last value uploaded to it. Owned by gl::Shader.
+     */
+    struct uniform_slot {
+        std::string name;
+        GLint location = -1;
+        GLenum type = 0;
+        GLint size = 0;
+
+        bool known = false; // true once `value` mirrors the GL state
+        alignas(16) unsigned char value[sizeof(float) * 16] = {};
+
+        // Stores the value and returns true if it differs from the shadow
+        bool update(const void* data, std::size_t bytes);
+    };
+
     class unif {
     private:
         GLuint m_programID;
         GLint m_location;
         std::string m_name;
+        uniform_slot* m_slot;
+
+        template<typename T>
+        bool changed(const T& v);
 
     public:
-        unif(GLuint program = 0, const std::string& name = "", GLint location = -1);
+        unif(GLuint program = 0, const std::string& name = "", GLint location = -1, uniform_slot* slot = nullptr);
 
         // -------------------- Setters --------------------
         unif& operator=(int v);
@@ -0,0 +1,104 @@
+#include "vertex_formats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace gl {
+
+    half toHalf(float f) {
+        std::uint32_t x;
+        std::memcpy(&x, &f, sizeof(x));
+
+        std::uint32_t sign = (x >> 16) & 0x8000u;
+        std::uint32_t mant = x & 0x007fffffu;
+        int exp = static_cast<int>((x >> 23) & 0xff) - 127 + 15;
+
+        // NaN / Inf
+        if (((x >> 23) & 0xff) == 0xff)
+            return { static_cast<std::uint16_t>(sign | 0x7c00u | (mant ? 0x200u : 0u)) };
+
+        // Overflow saturates to Inf
+        if (exp >= 31)
+            return { static_cast<std::uint16_t>(sign | 0x7c00u) };
+
+        // Subnormal or zero
+        if (exp <= 0) {
+            if (exp < -10)
+                return { static_cast<std::uint16_t>(sign) };
+            mant |= 0x00800000u;
+            int shift = 14 - exp;
+            std::uint32_t h = mant >> shift;
+            std::uint32_t rest = mant & ((1u << shift) - 1);
+            std::uint32_t halfway = 1u << (shift - 1);
+            if (rest > halfway || (rest == halfway && (h & 1u)))
+                h++;
+            return { static_cast<std::uint16_t>(sign | h) };
+        }
+
+        // Normal: round to nearest even, carries roll into the exponent
+        std::uint32_t h = sign | (static_cast<std::uint32_t>(exp) << 10) | (mant >> 13);
+        std::uint32_t rest = mant & 0x1fffu;
+        if (rest > 0x1000u || (rest == 0x1000u && (h & 1u)))
+            h++;
+        return { static_cast<std::uint16_t>(h) };
+    }
+
+    float toFloat(half h) {
+        std::uint32_t sign = (h.bits & 0x8000u) << 16;
+        std::uint32_t exp = (h.bits >> 10) & 0x1fu;
+        std::uint32_t mant = h.bits & 0x3ffu;
+
+        std::uint32_t x;
+        if (exp == 0) {
+            if (mant == 0) {
+                x = sign;
+            }
+            else {
+                // Renormalize the subnormal
+                int e = -1;
+                do {
+                    e++;
+                    mant <<= 1;
+                } while ((mant & 0x400u) == 0);
+                x = sign | (static_cast<std::uint32_t>(127 - 15 - e) << 23) | ((mant & 0x3ffu) << 13);
+            }
+        }
+        else if (exp == 31) {
+            x = sign | 0x7f800000u | (mant << 13);
+        }
+        else {
+            x = sign | ((exp + 127 - 15) << 23) | (mant << 13);
+        }
+
+        float f;
+        std::memcpy(&f, &x, sizeof(f));
+        return f;
+    }
+
+    packed_2_10_10_10 packSnorm2_10_10_10(float x, float y, float z, float w) {
+        auto snorm = [](float v, int bits) {
+            float maxv = static_cast<float>((1 << (bits - 1)) - 1);
+            int q = static_cast<int>(std::lround(std::clamp(v, -1.0f, 1.0f) * maxv));
+            return static_cast<std::uint32_t>(q) & ((1u << bits) - 1);
+        };
+        return { snorm(x, 10) | (snorm(y, 10) << 10) | (snorm(z, 10) << 20) | (snorm(w, 2) << 30) };
+    }
+
+    std::uint8_t packUnorm8(float v) {
+        return static_cast<std::uint8_t>(std::lround(std::clamp(v, 0.0f, 1.0f) * 255.0f));
+    }
+
+    std::int8_t packSnorm8(float v) {
+        return static_cast<std::int8_t>(std::lround(std::clamp(v, -1.0f, 1.0f) * 127.0f));
+    }
+
+    std::uint16_t packUnorm16(float v) {
+        return static_cast<std::uint16_t>(std::lround(std::clamp(v, 0.0f, 1.0f) * 65535.0f));
+    }
+
+    std::int16_t packSnorm16(float v) {
+        return static_cast<std::int16_t>(std::lround(std::clamp(v, -1.0f, 1.0f) * 32767.0f));
+    }
+
+}
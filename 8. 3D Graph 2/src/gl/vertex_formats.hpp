@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+namespace gl {
+
+    /**
+     * @brief Compact vertex component formats and their encoders.
+     *
+     * Usable with vertex_layout::add<T>() next to the plain C++ types:
+     *   layout.add<half>(2);                          // GL_HALF_FLOAT uv
+     *   layout.add<unsigned char>(4, true);           // GL_UNSIGNED_BYTE unorm color
+     *   layout.add<packed_2_10_10_10>(4, true);       // GL_INT_2_10_10_10_REV normal
+     */
+    struct half {
+        std::uint16_t bits;
+    };
+
+    // x, y, z in 10 bits each and w in 2, one 32-bit word per attribute
+    struct packed_2_10_10_10 {
+        std::uint32_t bits;
+    };
+
+    half toHalf(float f);
+    float toFloat(half h);
+
+    // Signed normalized [-1, 1] -> GL_INT_2_10_10_10_REV
+    packed_2_10_10_10 packSnorm2_10_10_10(float x, float y, float z, float w = 0.0f);
+
+    std::uint8_t  packUnorm8(float v);
+    std::int8_t   packSnorm8(float v);
+    std::uint16_t packUnorm16(float v);
+    std::int16_t  packSnorm16(float v);
+
+}
@@ -1,6 +1,6 @@
 #include "vertex_layout.hpp"
-#include <type_traits>
 #include <stdexcept>
+#include <string>
 
 namespace gl {
 
@@ -17,14 +17,12 @@ namespace gl {
         template<> constexpr GLenum gl_type<int>() { return GL_INT; }
         template<> constexpr GLenum gl_type<unsigned int>() { return GL_UNSIGNED_INT; }
         template<> constexpr GLenum gl_type<double>() { return GL_DOUBLE; }
-
-        template<typename T>
-        constexpr bool is_supported() {
-            return std::is_same_v<T, float> ||
-                std::is_same_v<T, int> ||
-                std::is_same_v<T, unsigned int> ||
-                std::is_same_v<T, double>;
-        }
+        template<> constexpr GLenum gl_type<half>() { return GL_HALF_FLOAT; }
+        template<> constexpr GLenum gl_type<signed char>() { return GL_BYTE; }
+        template<> constexpr GLenum gl_type<unsigned char>() { return GL_UNSIGNED_BYTE; }
+        template<> constexpr GLenum gl_type<short>() { return GL_SHORT; }
+        template<> constexpr GLenum gl_type<unsigned short>() { return GL_UNSIGNED_SHORT; }
+        template<> constexpr GLenum gl_type<packed_2_10_10_10>() { return GL_INT_2_10_10_10_REV; }
     }
 
     // -------------------------------
@@ -32,94 +30,86 @@ namespace gl {
     // -------------------------------
 
     vertex_layout::vertex_layout()
-        : m_currentOffset(0), m_nextIndex(0) {
+        : m_currentOffset(0), m_nextIndex(0), m_divisor(0) {
     }
 
-    // Template specializations
-
-    template<>
-    vertex_layout& vertex_layout::add<float>(GLint count, bool normalized) {
-        if (!is_supported<float>())
-            throw std::runtime_error("Unsupported vertex attribute type (float).");
-
-        Attribute attr{
-            m_nextIndex++,
-            count,
-            gl_type<float>(),
-            GLboolean(normalized ? GL_TRUE : GL_FALSE),
-            m_currentOffset
-        };
-
-        m_attributes.push_back(attr);
-        m_currentOffset += sizeof(float) * count;
-        return *this;
+    vertex_layout::vertex_layout(GLuint baseIndex, GLuint divisor)
+        : m_currentOffset(0), m_nextIndex(baseIndex), m_divisor(divisor) {
     }
 
-    template<>
-    vertex_layout& vertex_layout::add<int>(GLint count, bool normalized) {
-        if (!is_supported<int>())
-            throw std::runtime_error("Unsupported vertex attribute type (int).");
+    vertex_layout& vertex_layout::push(GLenum type, GLint count, bool normalized) {
+        if (type == GL_INT_2_10_10_10_REV && count != 4)
+            throw std::runtime_error("Packed 2_10_10_10 attributes must have 4 components.");
 
         Attribute attr{
             m_nextIndex++,
             count,
-            gl_type<int>(),
+            type,
             GLboolean(normalized ? GL_TRUE : GL_FALSE),
             m_currentOffset
         };
 
         m_attributes.push_back(attr);
-        m_currentOffset += sizeof(int) * count;
+        m_currentOffset += attributeSize(type, count);
         return *this;
     }
 
-    template<>
-    vertex_layout& vertex_layout::add<unsigned int>(GLint count, bool normalized) {
-        if (!is_supported<unsigned int>())
-            throw std::runtime_error("Unsupported vertex attribute type (uint).");
+    // Template specializations
 
-        Attribute attr{
-            m_nextIndex++,
-            count,
-            gl_type<unsigned int>(),
-            GLboolean(normalized ? GL_TRUE : GL_FALSE),
-            m_currentOffset
-        };
+    template<> vertex_layout& vertex_layout::add<float>(GLint count, bool normalized) { return push(gl_type<float>(), count, normalized); }
+    template<> vertex_layout& vertex_layout::add<int>(GLint count, bool normalized) { return push(gl_type<int>(), count, normalized); }
+    template<> vertex_layout& vertex_layout::add<unsigned int>(GLint count, bool normalized) { return push(gl_type<unsigned int>(), count, normalized); }
+    template<> vertex_layout& vertex_layout::add<double>(GLint count, bool normalized) { return push(gl_type<double>(), count, normalized); }
+    template<> vertex_layout& vertex_layout::add<half>(GLint count, bool normalized) { return push(gl_type<half>(), count, normalized); }
+    template<> vertex_layout& vertex_layout::add<signed char>(GLint count, bool normalized) { return push(gl_type<signed char>(), count, normalized); }
+    template<> vertex_layout& vertex_layout::add<unsigned char>(GLint count, bool normalized) { return push(gl_type<unsigned char>(), count, normalized); }
+    template<> vertex_layout& vertex_layout::add<short>(GLint count, bool normalized) { return push(gl_type<short>(), count, normalized); }
+    template<> vertex_layout& vertex_layout::add<unsigned short>(GLint count, bool normalized) { return push(gl_type<unsigned short>(), count, normalized); }
+    template<> vertex_layout& vertex_layout::add<packed_2_10_10_10>(GLint count, bool normalized) { return push(gl_type<packed_2_10_10_10>(), count, normalized); }
+
+    vertex_layout& vertex_layout::add(GLenum type, GLint count, bool normalized) {
+        if (attributeSize(type, count) == 0)
+            throw std::runtime_error("Unsupported vertex attribute type (" + std::to_string(type) + ").");
+        return push(type, count, normalized);
+    }
 
-        m_attributes.push_back(attr);
-        m_currentOffset += sizeof(unsigned int) * count;
+    vertex_layout& vertex_layout::tag(semantic meaning) {
+        if (!m_attributes.empty())
+            m_attributes.back().meaning = meaning;
         return *this;
     }
 
-    template<>
-    vertex_layout& vertex_layout::add<double>(GLint count, bool normalized) {
-        if (!is_supported<double>())
-            throw std::runtime_error("Unsupported vertex attribute type (double).");
-
-        Attribute attr{
-            m_nextIndex++,
-            count,
-            gl_type<double>(),
-            GLboolean(normalized ? GL_TRUE : GL_FALSE),
-            m_currentOffset
-        };
+    const vertex_layout::Attribute* vertex_layout::find(semantic meaning) const {
+        for (const auto& attr : m_attributes) {
+            if (attr.meaning == meaning)
+                return &attr;
+        }
+        return nullptr;
+    }
 
-        m_attributes.push_back(attr);
-        m_currentOffset += sizeof(double) * count;
-        return *this;
+    const vertex_layout::Attribute* vertex_layout::position() const {
+        const Attribute* a = find(semantic::position);
+        if (!a && !m_attributes.empty())
+            a = &m_attributes[0];
+        if (!a || a->type != GL_FLOAT || a->size < 3 || a->normalized)
+            return nullptr;
+        return a;
     }
 
     void vertex_layout::enable() const {
         for (const auto& attr : m_attributes) {
+            const void* offset = reinterpret_cast<const void*>(attr.offset);
+            const bool integer = attr.type != GL_FLOAT && attr.type != GL_DOUBLE && attr.type != GL_HALF_FLOAT &&
+                attr.type != GL_INT_2_10_10_10_REV && attr.normalized == GL_FALSE;
+
             glEnableVertexAttribArray(attr.index);
-            glVertexAttribPointer(
-                attr.index,
-                attr.size,
-                attr.type,
-                attr.normalized,
-                m_currentOffset,
-                reinterpret_cast<const void*>(attr.offset)
-            );
+            if (attr.type == GL_DOUBLE)
+                glVertexAttribLPointer(attr.index, attr.size, attr.type, m_currentOffset, offset);
+            else if (integer)
+                glVertexAttribIPointer(attr.index, attr.size, attr.type, m_currentOffset, offset);
+            else
+                glVertexAttribPointer(attr.index, attr.size, attr.type, attr.normalized, m_currentOffset, offset);
+            glVertexAttribDivisor(attr.index, m_divisor);
         }
     }
 
@@ -129,6 +119,27 @@ namespace gl {
         }
     }
 
+    std::size_t vertex_layout::typeSize(GLenum type) {
+        switch (type) {
+        case GL_FLOAT:          return sizeof(float);
+        case GL_INT:            return sizeof(int);
+        case GL_UNSIGNED_INT:   return sizeof(unsigned int);
+        case GL_DOUBLE:         return sizeof(double);
+        case GL_HALF_FLOAT:     return sizeof(half);
+        case GL_BYTE:           return sizeof(signed char);
+        case GL_UNSIGNED_BYTE:  return sizeof(unsigned char);
+        case GL_SHORT:          return sizeof(short);
+        case GL_UNSIGNED_SHORT: return sizeof(unsigned short);
+        default:                return 0; // includes packed types
+        }
+    }
+
+    std::size_t vertex_layout::attributeSize(GLenum type, GLint count) {
+        if (type == GL_INT_2_10_10_10_REV)
+            return sizeof(packed_2_10_10_10);
+        return typeSize(type) * static_cast<std::size_t>(count);
+    }
+
     std::size_t vertex_layout::stride() const {
         return m_currentOffset;
     }
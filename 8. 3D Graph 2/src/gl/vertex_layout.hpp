@@ -3,6 +3,9 @@
 #include <glad/glad.h>
 #include <vector>
 #include <cstddef>
+#include <cstdint>
+
+#include "vertex_formats.hpp"
 
 namespace gl {
 
@@ -14,31 +17,72 @@ namespace gl {
      *   layout.add<float>(3); // position
      *   layout.add<float>(2); // texCoord
      *   layout.apply();
+     *
+     * Per-instance layouts start after the mesh attributes and advance once
+     * per instance instead of once per vertex:
+     *   vertex_layout inst(2, 1);
+     *   for (int c = 0; c < 4; c++) inst.add<float>(4); // mat4 columns
      */
     class vertex_layout {
     public:
+        // What an attribute holds, used to pick compact formats on import
+        enum class semantic : std::uint32_t {
+            none = 0,
+            position,
+            color,
+            normal,
+            uv,
+        };
+
         struct Attribute {
             GLuint index;
             GLint size;
             GLenum type;
             GLboolean normalized;
             std::size_t offset;
+            semantic meaning = semantic::none;
         };
 
         vertex_layout();
+        explicit vertex_layout(GLuint baseIndex, GLuint divisor = 0);
 
         template<typename T>
         vertex_layout& add(GLint count, bool normalized = false);
 
+        // Runtime variant for layouts read from files (GL_FLOAT, GL_INT, ...)
+        vertex_layout& add(GLenum type, GLint count, bool normalized = false);
+
+        // Tags the last added attribute
+        vertex_layout& tag(semantic meaning);
+
+        // Integer attributes (unless normalized) go through
+        // glVertexAttribIPointer and doubles through glVertexAttribLPointer,
+        // so shaders must declare them as ivec/uvec/dvec inputs
         void enable() const;
         void disable() const;
 
         std::size_t stride() const;
+        const std::vector<Attribute>& attributes() const { return m_attributes; }
+        // First attribute tagged `meaning`, or nullptr
+        const Attribute* find(semantic meaning) const;
+        // Float xyz positions: the attribute tagged position, else the
+        // first attribute by convention. nullptr if that is not float(3+).
+        const Attribute* position() const;
+        GLuint nextIndex() const { return m_nextIndex; }
+        GLuint divisor() const { return m_divisor; }
+
+        // Size in bytes of one component of a GL type (0 for packed types)
+        static std::size_t typeSize(GLenum type);
+        // Size in bytes of a whole attribute (packed types hold all components in one word)
+        static std::size_t attributeSize(GLenum type, GLint count);
 
     private:
+        vertex_layout& push(GLenum type, GLint count, bool normalized);
+
         std::vector<Attribute> m_attributes;
         std::size_t m_currentOffset;
         GLuint m_nextIndex;
+        GLuint m_divisor;
     };
 
     // Explicit template specializations for supported types
@@ -46,5 +90,11 @@ namespace gl {
     template<> vertex_layout& vertex_layout::add<int>(GLint count, bool normalized);
     template<> vertex_layout& vertex_layout::add<unsigned int>(GLint count, bool normalized);
     template<> vertex_layout& vertex_layout::add<double>(GLint count, bool normalized);
+    template<> vertex_layout& vertex_layout::add<half>(GLint count, bool normalized);
+    template<> vertex_layout& vertex_layout::add<signed char>(GLint count, bool normalized);
+    template<> vertex_layout& vertex_layout::add<unsigned char>(GLint count, bool normalized);
+    template<> vertex_layout& vertex_layout::add<short>(GLint count, bool normalized);
+    template<> vertex_layout& vertex_layout::add<unsigned short>(GLint count, bool normalized);
+    template<> vertex_layout& vertex_layout::add<packed_2_10_10_10>(GLint count, bool normalized);
 
 }
\ No newline at end of file
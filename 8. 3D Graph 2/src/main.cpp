@@ -1,7 +1,9 @@
 #include "main.hpp"
 #include "controls.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <iterator>
 #include <numbers>
 
 #include "gl/Shader.hpp"
@@ -10,6 +12,15 @@
 #include "gl/governor.hpp"
 #include "gl/Model.hpp"
 #include "gl/TexModel.hpp"
+#include "gl/SceneGraph.hpp"
+#include "gl/Bvh.hpp"
+#include "gl/Picker.hpp"
+#include "gl/RenderQueue.hpp"
+#include "gl/UniformBuffer.hpp"
+#include "gl/PictureBatch.hpp"
+
+#include "bench/bench.hpp"
+#include "tools/tools.hpp"
 
 gl::Window window;
 gl::Camera camera;
@@ -19,48 +30,84 @@ glm::mat4 mat_persp, mat_view;
 
 float lastTime, currTime, deltaTime;
 
-int main()
+int main(int argc, char** argv)
 {
+    if (argc > 1 && std::string(argv[1]) == "--bench")
+        return bench::run(argc > 2 ? argv[2] : "");
+    if (argc > 1 && std::string(argv[1]) == "--tool")
+        return tools::run(argc > 2 ? argv[2] : "", std::vector<std::string>(argv + std::min(argc, 3), argv + argc));
+
+    // Startup is measured up to the first presented frame
+    bench::stopwatch startup;
+
     // Initialize window
-    window.init(800, 600, "UPY YUPI");
+    if (!window.init(800, 600, "UPY YUPI"))
+        return 1;
+
+    // Camera data for every shader, uploaded once per frame; must exist
+    // before the shaders link so they pick up the Frame block binding
+    gl::UniformBuffer frameBuffer;
+    frameBuffer.create(gl::frame_uniforms::block, gl::frame_uniforms::binding, sizeof(gl::frame_uniforms));
 
     // Load Shaders
-    gl::Shader s_colors;
-    s_colors.attach("./shaders/colors");
-    s_colors.use();
-    auto unif_matrix = s_colors.getUniform("matrix");
+    gl::Shader s_instanced;
+    s_instanced.attach("./shaders/colors_instanced");
+    s_instanced.use();
 
     gl::Shader s_cube;
     s_cube.attach("./shaders/cube");
 
-    // Load models
-    gl::Mesh m_cube = gl::MeshParser::loadModel("./models/cube.mo");
+    gl::Shader s_pictures;
+    s_pictures.attach("./shaders/pictures");
+
+    // Load models, reordering and compacting them on import
+    gl::MeshLoadOptions meshOptions;
+    meshOptions.optimize = true;
+    meshOptions.quantize = true;
+    meshOptions.report = true;
+
+    gl::Mesh m_cube = gl::MeshParser::loadModel("./models/cube.mo", meshOptions);
 
-    gl::Model model_cube2(std::move(gl::MeshParser::loadModel("./models/cube2.mo")));
+    gl::Model model_cube2(std::move(gl::MeshParser::loadModel("./models/cube2.mo", meshOptions)));
     model_cube2.setPosition({-3, 0, 3});
 
     gl::TexModel t_cats, t_fav, t_bliss, t_code;
-    t_cats.load("./imgs/cats.jpg", 4);
+    // Only the quads here; the pictures share one atlas, decoded and
+    // packed on the thread pool and streamed in over the first frames.
+    // Until then they show a grey placeholder
+    t_cats.loadQuad("./imgs/cats.jpg", 4);
     t_cats.setPosition({-100, 0, 0});
     t_cats.rotateY(90);
 
-    t_fav.load("./imgs/favicon.jpg", 5);
+    t_fav.loadQuad("./imgs/favicon.jpg", 5);
     t_fav.setPosition({200, 0, 0});
     t_fav.rotateY(-90);
 
-    t_bliss.load("./imgs/xp-bliss.jpg", 3);
+    t_bliss.loadQuad("./imgs/xp-bliss.jpg", 3);
     t_bliss.setPosition({0, 0, -500});
 
-    t_code.load("./imgs/guero.jpg", 3);
+    t_code.loadQuad("./imgs/guero.jpg", 3);
     t_code.setPosition({100, 0, 350});
     t_code.rotateY(180);
 
+    // Axes hang off one graph origin, so moving it moves the whole plot
+    gl::SceneGraph scene;
+    auto graphOrigin = scene.create();
+    scene.setPosition(graphOrigin, {0, -10, 0});
+    auto axisX = scene.create(graphOrigin);
+    auto axisZ = scene.create(graphOrigin);
+    for(int i = 0; i < 50; i += 2) {
+        scene.setPosition(scene.create(model_cube2, axisX), {i, 0, 0});
+        scene.setPosition(scene.create(model_cube2, axisZ), {0, 0, i});
+    }
+
     // SETUP VIEW MATRICES
     mat_persp = glm::perspective((float)(fov * std::numbers::pi / 180.f), 8.f / 6.f, 0.001f, 1000.f);
 
     // SETUP GL...
-    glEnable(GL_DEPTH_TEST); // test for depth...
-    // glEnable(GL_CULL_FACE); // Draw only front triangles..
+    gl::StateCache& glState = window.getState();
+    glState.enable(GL_DEPTH_TEST); // test for depth...
+    // glState.enable(GL_CULL_FACE); // Draw only front triangles..
 
     const int wX = 33;
     const int wY = 5;
@@ -72,16 +119,83 @@ int main()
         {1, 1, 1, 1, 0, 1, 1, 1, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 1, 1, 1, 0, 1, 0, 0, 0, 0, 1, 0},
     };
 
+    // The wall never moves: upload one model matrix per set cell once
+    // and draw all letter cubes with a single instanced call
+    std::vector<glm::mat4> wallMatrices;
+    for (int i = 0; i < wX; i++)
+    {
+        for (int j = 0; j < wY; j++)
+        {
+            if (!wall[j][i])
+                continue;
+            int jp = wY - j - 1;
+            wallMatrices.push_back(glm::translate(glm::mat4(1), glm::vec3(i, jp, 0)));
+        }
+    }
+
+    gl::vertex_layout wallLayout(m_cube.instanceBaseIndex(), 1);
+    for (int c = 0; c < 4; c++)
+        wallLayout.add<float>(4); // mat4 = 4 vec4 columns
+    m_cube.uploadInstances(wallMatrices.data(), wallMatrices.size() * sizeof(glm::mat4), wallLayout);
+
+    // Pictures and the letter wall (as one box) in a BVH; only t_fav
+    // moves, so it is the only one refit each frame
+    enum { o_wall, o_cats, o_fav, o_bliss, o_code, o_count };
+    gl::aabb wallBox;
+    for (const auto& m : wallMatrices)
+        wallBox.grow(m_cube.bounds().box(m));
+    gl::Bvh objects;
+    objects.build({ wallBox, t_cats.worldBox(), t_fav.worldBox(), t_bliss.worldBox(), t_code.worldBox() });
+    std::vector<std::uint32_t> visibleObjects;
+    bool visible[o_count];
+
+    // Click picking runs on CPU copies of the meshes: the pictures, then
+    // every letter cube of the wall
+    gl::PickMesh pickCube;
+    {
+        gl::MeshData cubeData;
+        if (gl::MeshParser::parseFile("./models/cube.mo", cubeData))
+            pickCube.build(cubeData);
+    }
+    const gl::TexModel* pictures[] = { &t_cats, &t_fav, &t_bliss, &t_code };
+    const char* pictureNames[] = { "cats", "favicon", "bliss", "code" };
+    gl::PictureBatch pictureBatch;
+    for (const auto* t : pictures)
+        pictureBatch.add(*t);
+    pictureBatch.buildAsync();
+    gl::Picker picker;
+    for (const auto* t : pictures)
+        picker.add(t->pickMesh(), t->modelMatrix());
+    if (pickCube.triangleCount() > 0) {
+        for (const auto& m : wallMatrices)
+            picker.add(pickCube, m);
+    }
+
+    // Every draw of a frame goes through one queue, sorted by state
+    gl::RenderQueue queue;
+
     setupControls();
 
     gl::governor gov;
     // gov.setDebug(true);
     gov.setFPS(60);
 
+    // Print per-frame renderer counters about once a second
+    const bool showStats = false;
+    glState.setDebug(showStats); // count real vs elided state calls
+    int statFrames = 0;
+    float statTime = 0;
+
+    // Atlas streaming report: first frame, then the worst frame while
+    // the atlas was still loading
+    bool firstFrame = true, loadingReported = false;
+    double worstLoadingFrameMs = 0;
+
     lastTime = 0.0f;
     while (!window.shouldClose())
     {
         gov.busy();
+        bench::stopwatch frameTime;
 
         currTime = glfwGetTime();
         deltaTime = currTime - lastTime;
@@ -92,58 +206,135 @@ int main()
 
         window.pollEvents();
         processControls();
-        // draw letters
-        s_colors.use();
-        for (int i = 0; i < wX; i++)
-        {
-            for (int j = 0; j < wY; j++)
-            {
-                if (!wall[j][i])
-                    continue;
-                int jp = wY - j - 1;
-                glm::mat4 m = glm::translate(glm::mat4(1), {i, jp, 0});
-                unif_matrix = mat_persp * mat_view * m;
-                m_cube.draw();
+        const glm::mat4 viewProj = mat_persp * mat_view;
+        gl::TransformStore::shared().update();
+        scene.update();
+
+        // The only camera upload of the frame; shaders multiply by the
+        // model matrix themselves
+        gl::frame_uniforms frame;
+        frame.view = mat_view;
+        frame.projection = mat_persp;
+        frame.viewProj = viewProj;
+        frame.cameraPosition = glm::vec4(camera.getPosition(), 1.0f);
+        frame.time = currTime;
+        frameBuffer.update(frame);
+
+        // Decide what is on screen before any uniform goes out; the view
+        // already carries the pitch applied in processControls
+        const gl::Frustum frustum(viewProj);
+        objects.refit(o_fav, t_fav.worldBox());
+        objects.cull(frustum, visibleObjects);
+        picker.setTransform(o_fav - o_cats, t_fav.modelMatrix());
+
+        glm::vec2 cursor, viewport;
+        if (takePickRequest(cursor, viewport)) {
+            bench::stopwatch sw;
+            gl::Picker::Hit hit = picker.pick(cursor, viewport, mat_persp, mat_view);
+            double ms = sw.ms();
+            if (hit.object == gl::Picker::invalid) {
+                std::cout << "[pick] nothing (" << ms << " ms)" << std::endl;
+            } else {
+                const char* name = hit.object < std::size(pictures) ? pictureNames[hit.object] : "wall";
+                std::cout << "[pick] " << name << " triangle " << hit.triangle
+                          << " at (" << hit.point.x << ", " << hit.point.y << ", " << hit.point.z
+                          << "), distance " << hit.t << " (" << ms << " ms)" << std::endl;
             }
         }
-        
-        
-        // Draw a cube
-        s_cube.use();
-        s_cube.setUniform("u_mode", 1); // MODE: Solid Color
+        std::fill(std::begin(visible), std::end(visible), false);
+        for (auto o : visibleObjects)
+            visible[o] = true;
 
-        // draw axes, well, sort of
-        s_cube.setUniform("u_solidColor", glm::vec4(1, 0, 0, 1));
-        for(int i = 0; i < 50; i += 2) {
-            glm::mat4 m = glm::translate(glm::mat4(1), {i, -10, 0});
-            s_cube.setUniform("matrix", mat_persp * mat_view * m);
-            model_cube2.draw();
-        }
-        s_cube.setUniform("u_solidColor", glm::vec4(0, 0, 1, 1));
-        for(int i = 0; i < 50; i += 2) {
-            glm::mat4 m = glm::translate(glm::mat4(1), {0, -10, i});
-            s_cube.setUniform("matrix", mat_persp * mat_view * m);
-            model_cube2.draw();
+        // draw letters
+        if (visible[o_wall]) {
+            gl::RenderQueue::Draw d;
+            d.shader = &s_instanced;
+            d.mesh = &m_cube;
+            d.matrixUniform = {}; // per-instance matrices, camera from the Frame block
+            d.instances = m_cube.instanceCount();
+            d.depth = (viewProj * glm::vec4(wallBox.center(), 1.0f)).w;
+            queue.submit(d);
         }
-        
-
-         // MODE: Textured
-        s_cube.setUniform("u_mode", 2);
 
-        s_cube.setUniform("matrix", mat_persp * mat_view * t_cats.modelMatrix());
-        t_cats.draw();
+        // draw axes, well, sort of
+        gl::RenderQueue::Draw axis;
+        axis.shader = &s_cube;
+        axis.mode = 1; // MODE: Solid Color
+        axis.color = glm::vec4(1, 0, 0, 1);
+        scene.submit(queue, axis, viewProj, axisX, &frustum);
+        axis.color = glm::vec4(0, 0, 1, 1);
+        scene.submit(queue, axis, viewProj, axisZ, &frustum);
 
-        
-        s_cube.setUniform("matrix", mat_persp * mat_view * t_fav.modelMatrix());
-        t_fav.draw();
+        // All pictures in one instanced draw from the atlas
+        if (pictureBatch.update(&frustum) > 0) {
+            queue.submit(pictureBatch.draw(s_pictures));
+        }
+        else if (!pictureBatch.ready()) {
+            for (int o = o_cats; o <= o_code; o++) {
+                if (!visible[o])
+                    continue;
+                const gl::TexModel& t = *pictures[o - o_cats];
+                gl::RenderQueue::Draw d;
+                d.shader = &s_cube;
+                d.mesh = &t.mesh();
+                d.mode = 1; // MODE: Solid Color
+                d.color = glm::vec4(0.5f, 0.5f, 0.5f, 1.0f);
+                d.matrix = t.modelMatrix();
+                d.depth = (viewProj * d.matrix[3]).w;
+                queue.submit(d);
+            }
+        }
         t_fav.rotateX(10 * deltaTime);
         t_fav.rotateY(30 * deltaTime);
 
-         s_cube.setUniform("matrix", mat_persp * mat_view * t_bliss.modelMatrix());
-        t_bliss.draw();
-
-        s_cube.setUniform("matrix", mat_persp * mat_view * t_code.modelMatrix());
-        t_code.draw();
+        queue.flush();
         window.swapBuffers();
+
+        if (firstFrame) {
+            std::cout << "[textures] first frame after " << startup.ms() << " ms, "
+                      << (pictureBatch.ready() ? "atlas ready" : "atlas still loading") << std::endl;
+            firstFrame = false;
+        }
+        else if (!loadingReported) {
+            worstLoadingFrameMs = std::max(worstLoadingFrameMs, frameTime.ms());
+        }
+        if (!loadingReported && (pictureBatch.ready() || pictureBatch.failed())) {
+            std::cout << "[textures] " << pictureBatch.size() << " pictures "
+                      << (pictureBatch.failed() ? "failed" : "in one atlas") << " after "
+                      << startup.ms() << " ms | worst frame " << worstLoadingFrameMs << " ms" << std::endl;
+            pictureBatch.atlas().report(std::cout);
+            loadingReported = true;
+        }
+
+        statFrames++;
+        statTime += deltaTime;
+        if (showStats && statTime >= 1.0f)
+        {
+            auto& us = gl::uniform_stats::global();
+            auto& ts = gl::transform_stats::global();
+            auto& cs = gl::cull_stats::global();
+            auto& rs = gl::render_stats::global();
+            auto& ss = gl::state_stats::global();
+            std::cout << "[stats] per frame: uniform hits " << us.hits / statFrames
+                      << " | misses " << us.misses / statFrames
+                      << " | gl calls " << us.issued / statFrames
+                      << " | skipped " << us.skipped / statFrames
+                      << " | matrix rebuilds " << ts.rebuilds / statFrames
+                      << " | mvp rebuilds " << ts.mvpRebuilds / statFrames
+                      << " | visible " << cs.visible / statFrames
+                      << " | culled " << cs.culled / statFrames
+                      << " | draws " << rs.draws / statFrames
+                      << " | state changes " << rs.changes() / statFrames
+                      << " (unsorted " << rs.unsorted / statFrames << ")"
+                      << " | gl state calls " << ss.issued / statFrames
+                      << " | elided " << ss.elided / statFrames << std::endl;
+            us.reset();
+            ts.reset();
+            cs.reset();
+            rs.reset();
+            ss.reset();
+            statFrames = 0;
+            statTime = 0;
+        }
     }
 }
\ No newline at end of file
@@ -11,4 +11,4 @@ extern glm::mat4 mat_persp, mat_view;
 extern const float fov;
 extern float deltaTime;
 
-int main();
+int main(int argc, char** argv);
@@ -0,0 +1,92 @@
+#include "tools.hpp"
+
+#include "../gl/MeshParser.hpp"
+#include "../gl/MeshQuantizer.hpp"
+
+#include <cstdlib>
+#include <iostream>
+
+namespace tools {
+
+    namespace {
+        // Splits "--flag" arguments from file names
+        gl::MeshLoadOptions readOptions(const std::vector<std::string>& args, std::vector<std::string>& files) {
+            gl::MeshLoadOptions options;
+            options.report = true;
+            for (const auto& a : args) {
+                if (a == "--quantize") options.quantize = true;
+                else if (a == "--optimize") options.optimize = true;
+                else if (a == "--weld") options.weld = true;
+                else if (a.rfind("--weld=", 0) == 0) {
+                    options.weld = true;
+                    options.weldEpsilon = std::strtof(a.c_str() + 7, nullptr);
+                }
+                else if (a.rfind("--", 0) == 0) std::cerr << "Ignoring unknown option " << a << "\n";
+                else files.push_back(a);
+            }
+            return options;
+        }
+    }
+
+    int meshToBinary(const std::vector<std::string>& args) {
+        std::vector<std::string> files;
+        gl::MeshLoadOptions options = readOptions(args, files);
+        if (files.empty()) {
+            std::cerr << "usage: --tool mo2bin [--weld[=epsilon]] [--optimize] [--quantize] <in.mo>...\n";
+            return 1;
+        }
+
+        int failed = 0;
+        for (const auto& in : files) {
+            gl::MeshData md;
+            if (!gl::MeshParser::parseFile(in, md)) {
+                failed++;
+                continue;
+            }
+
+            // Bake the steps asked for here or in the mesh's metadata
+            gl::MeshMemory before = gl::MeshMemory::of(md);
+            gl::MeshParser::process(md, options, in);
+
+            std::string out = gl::MeshParser::binaryPath(in);
+            if (!gl::MeshParser::writeBinary(md, out)) {
+                failed++;
+                continue;
+            }
+
+            std::cout << in << " -> " << out << "\n";
+            gl::MeshQuantizer::report(std::cout, in, before, gl::MeshMemory::of(md));
+        }
+        return failed == 0 ? 0 : 1;
+    }
+
+    int meshInfo(const std::vector<std::string>& args) {
+        if (args.empty()) {
+            std::cerr << "usage: --tool meshinfo <in.mo|in.mob>...\n";
+            return 1;
+        }
+
+        int failed = 0;
+        for (const auto& in : args) {
+            gl::MeshData md;
+            bool binary = in.size() > 4 && in.compare(in.size() - 4, 4, ".mob") == 0;
+            if (!(binary ? gl::MeshParser::parseBinary(in, md) : gl::MeshParser::parseFile(in, md))) {
+                failed++;
+                continue;
+            }
+
+            // Memory and cache stats as stored, and what importing with
+            // every step would give
+            gl::MeshMemory before = gl::MeshMemory::of(md);
+            gl::MeshLoadOptions options;
+            options.weld = true;
+            options.optimize = true;
+            options.quantize = true;
+            options.report = true;
+            gl::MeshParser::process(md, options, in);
+            gl::MeshQuantizer::report(std::cout, in, before, gl::MeshMemory::of(md));
+        }
+        return failed == 0 ? 0 : 1;
+    }
+
+}
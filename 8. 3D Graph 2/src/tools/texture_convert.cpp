@@ -0,0 +1,209 @@
+#include "tools.hpp"
+
+#include "../gl/BlockCompressor.hpp"
+#include "../gl/MipGenerator.hpp"
+#include "../gl/TextureFile.hpp"
+#include "../ext/stb_image.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+
+namespace tools {
+
+    namespace {
+        struct compress_options {
+            bool automatic = true;     // bc1 for opaque images, bc3 otherwise
+            bool uncompressed = false; // rgba8
+            gl::block_format format = gl::block_format::bc1;
+            bool mips = true;
+            gl::mip_filter filter = gl::mip_filter::kaiser;
+            bool srgb = true;
+            bool flip = true;
+            unsigned threads = 0;
+        };
+
+        bool isImage(const std::filesystem::path& p) {
+            std::string ext = p.extension().string();
+            std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            return ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".bmp" || ext == ".tga";
+        }
+
+        // Images among the arguments, directories expanded one level
+        std::vector<std::string> collectImages(const std::vector<std::string>& inputs) {
+            std::vector<std::string> files;
+            for (const auto& in : inputs) {
+                std::error_code ec;
+                if (!std::filesystem::is_directory(in, ec)) {
+                    files.push_back(in);
+                    continue;
+                }
+                std::vector<std::string> found;
+                for (const auto& entry : std::filesystem::directory_iterator(in, ec)) {
+                    if (entry.is_regular_file() && isImage(entry.path()))
+                        found.push_back(entry.path().string());
+                }
+                std::sort(found.begin(), found.end());
+                files.insert(files.end(), found.begin(), found.end());
+            }
+            return files;
+        }
+
+        double psnr(const unsigned char* a, const unsigned char* b, std::size_t pixels) {
+            double sum = 0.0;
+            for (std::size_t i = 0; i < pixels * 4; i++) {
+                double d = static_cast<double>(a[i]) - b[i];
+                sum += d * d;
+            }
+            double mse = sum / (pixels * 4.0);
+            return mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : 99.0;
+        }
+
+        double megabytes(std::size_t bytes) {
+            return bytes / (1024.0 * 1024.0);
+        }
+
+        double msSince(std::chrono::steady_clock::time_point start) {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    int textureCompress(const std::vector<std::string>& args) {
+        compress_options options;
+        std::vector<std::string> inputs;
+        for (const auto& a : args) {
+            if (a.rfind("--format=", 0) == 0) {
+                std::string name = a.substr(9);
+                options.automatic = name == "auto";
+                options.uncompressed = name == "rgba8";
+                if (!options.automatic && !options.uncompressed && !gl::BlockCompressor::parse(name, options.format)) {
+                    std::cerr << "Unknown format " << name << " (bc1, bc3, bc7, rgba8 or auto)\n";
+                    return 1;
+                }
+            }
+            else if (a.rfind("--mips=", 0) == 0) {
+                std::string name = a.substr(7);
+                options.mips = name != "none";
+                if (options.mips && !gl::MipGenerator::parse(name, options.filter)) {
+                    std::cerr << "Unknown mip filter " << name << " (kaiser, box or none)\n";
+                    return 1;
+                }
+            }
+            else if (a == "--linear") options.srgb = false;
+            else if (a == "--no-flip") options.flip = false;
+            else if (a.rfind("--threads=", 0) == 0) options.threads = static_cast<unsigned>(std::strtoul(a.c_str() + 10, nullptr, 10));
+            else if (a.rfind("--", 0) == 0) std::cerr << "Ignoring unknown option " << a << "\n";
+            else inputs.push_back(a);
+        }
+
+        const std::vector<std::string> files = collectImages(inputs);
+        if (files.empty()) {
+            std::cerr << "usage: --tool texcompress [--format=bc1|bc3|bc7|rgba8|auto] [--mips=kaiser|box|none] [--linear]\n"
+                         "                          [--threads=N] [--no-flip] <image|dir>...\n";
+            return 1;
+        }
+
+        std::unique_ptr<gl::ThreadPool> ownPool;
+        if (options.threads)
+            ownPool = std::make_unique<gl::ThreadPool>(options.threads);
+        gl::ThreadPool& pool = ownPool ? *ownPool : gl::ThreadPool::shared();
+        std::cout << "Encoding on " << pool.threadCount() << " threads\n";
+
+        int failed = 0;
+        std::size_t totalBefore = 0, totalAfter = 0, totalPixels = 0;
+        double totalMipMs = 0.0, totalEncodeMs = 0.0;
+        for (const auto& in : files) {
+            int w = 0, h = 0, channels = 0;
+            stbi_set_flip_vertically_on_load(options.flip);
+            unsigned char* rgba = stbi_load(in.c_str(), &w, &h, &channels, 4);
+            if (!rgba) {
+                std::cerr << "Error: cannot decode " << in << "\n";
+                failed++;
+                continue;
+            }
+            const std::size_t pixels = static_cast<std::size_t>(w) * h;
+
+            gl::block_format format = options.format;
+            if (options.automatic) {
+                bool opaque = true;
+                if (channels == 2 || channels == 4) {
+                    for (std::size_t i = 0; i < pixels && opaque; i++)
+                        opaque = rgba[i * 4 + 3] == 255;
+                }
+                format = opaque ? gl::block_format::bc1 : gl::block_format::bc3;
+            }
+            const GLenum glFormat = options.uncompressed ? GL_RGBA8 : gl::BlockCompressor::glFormat(format);
+
+            auto start = std::chrono::steady_clock::now();
+            std::vector<gl::mip_level> chain;
+            if (options.mips) {
+                chain = gl::MipGenerator::build(rgba, w, h, options.filter, options.srgb, pool);
+            }
+            else {
+                chain.push_back({ w, h, std::vector<unsigned char>(rgba, rgba + pixels * 4) });
+            }
+            const double mipMs = msSince(start);
+            stbi_image_free(rgba);
+
+            start = std::chrono::steady_clock::now();
+            std::vector<std::vector<unsigned char>> levels;
+            std::size_t before = 0, after = 0;
+            for (auto& level : chain) {
+                before += level.rgba.size();
+                if (options.uncompressed)
+                    levels.push_back(std::move(level.rgba));
+                else
+                    levels.push_back(gl::BlockCompressor::compress(format, level.rgba.data(), level.width, level.height, pool));
+                after += levels.back().size();
+            }
+            const double encodeMs = msSince(start);
+
+            // Error of the top level only; rgba8 is lossless
+            double quality = 99.0;
+            if (!options.uncompressed) {
+                std::vector<unsigned char> decoded = gl::BlockCompressor::decompress(format, levels[0].data(), w, h);
+                if (format == gl::block_format::bc1) {
+                    for (std::size_t i = 0; i < pixels; i++)
+                        decoded[i * 4 + 3] = chain[0].rgba[i * 4 + 3]; // not stored, not scored
+                }
+                quality = psnr(chain[0].rgba.data(), decoded.data(), pixels);
+            }
+
+            const std::string out = std::filesystem::path(in).replace_extension(".dds").string();
+            if (!gl::TextureFile::writeDds(out, glFormat, w, h, levels)) {
+                failed++;
+                continue;
+            }
+
+            // Throughput counts every level's pixels
+            char line[256];
+            std::snprintf(line, sizeof(line), "%dx%d %s, %zu levels: RGBA8 %.2f MB -> %.2f MB (%.1fx) | mips %.1f ms, encode %.1f ms (%.1f MP/s) | PSNR %.1f dB",
+                w, h, options.uncompressed ? "rgba8" : gl::BlockCompressor::name(format), levels.size(),
+                megabytes(before), megabytes(after), static_cast<double>(before) / after,
+                mipMs, encodeMs, before / 4 / std::max(encodeMs, 1e-3) / 1000.0, quality);
+            std::cout << in << " -> " << out << "\n  " << line << "\n";
+
+            totalBefore += before;
+            totalAfter += after;
+            totalPixels += before / 4;
+            totalMipMs += mipMs;
+            totalEncodeMs += encodeMs;
+        }
+
+        if (totalPixels) {
+            char line[256];
+            std::snprintf(line, sizeof(line), "Total: VRAM %.2f MB -> %.2f MB, %.1f MP in all levels | mips %.1f ms, encode %.1f ms (%.1f MP/s)",
+                megabytes(totalBefore), megabytes(totalAfter), totalPixels / 1e6,
+                totalMipMs, totalEncodeMs, totalPixels / std::max(totalEncodeMs, 1e-3) / 1000.0);
+            std::cout << line << "\n";
+        }
+        return failed == 0 ? 0 : 1;
+    }
+
+}
@@ -0,0 +1,36 @@
+#include "tools.hpp"
+
+#include <iostream>
+
+namespace tools {
+
+    namespace {
+        struct entry {
+            const char* name;
+            int (*fn)(const std::vector<std::string>&);
+            const char* usage;
+        };
+
+        const entry entries[] = {
+            { "mo2bin",   meshToBinary, "[--weld[=eps]] [--optimize] [--quantize] <in.mo>... - compile text models to .mob" },
+            { "meshinfo", meshInfo,     "<in.mo|in.mob>... - vertex/index memory and cache report" },
+            { "texcompress", textureCompress, "[--format=bc1|bc3|bc7|rgba8|auto] [--mips=kaiser|box|none] [--linear] [--threads=N] [--no-flip] <image|dir>... - images to .dds with mips" },
+        };
+    }
+
+    int run(const std::string& name, const std::vector<std::string>& args) {
+        for (const auto& e : entries) {
+            if (name == e.name)
+                return e.fn(args);
+        }
+
+        if (!name.empty())
+            std::cerr << "Unknown tool: " << name << "\n";
+
+        std::cout << "Available tools:\n";
+        for (const auto& e : entries)
+            std::cout << "  " << e.name << " " << e.usage << "\n";
+        return name.empty() ? 0 : 1;
+    }
+
+}
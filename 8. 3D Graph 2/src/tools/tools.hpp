@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace tools {
+
+    /**
+     * @brief Offline asset tools, selected with `out.exe --tool <name> args...`.
+     *
+     * `out.exe --tool` without a name lists the available ones.
+     */
+    int run(const std::string& name, const std::vector<std::string>& args);
+
+    // mo2bin [--weld[=epsilon]] [--optimize] [--quantize] <in.mo>... : compile text models into `.mob` next to them
+    int meshToBinary(const std::vector<std::string>& args);
+
+    // meshinfo <in.mo|in.mob>... : vertex/index memory and vertex cache stats,
+    // as stored and fully optimized
+    int meshInfo(const std::vector<std::string>& args);
+
+    // texcompress [--format=bc1|bc3|bc7|rgba8|auto] [--mips=kaiser|box|none] [--linear]
+    // [--threads=N] [--no-flip] <image|dir>... : mip chains, block-compressed, into `.dds` next to the images
+    int textureCompress(const std::vector<std::string>& args);
+
+}